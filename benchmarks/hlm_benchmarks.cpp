@@ -0,0 +1,1566 @@
+// Benchmarks of HLM::Vector, HELIUM_API::SharedVector and std::vector,
+// and of HLM::SoAVector against SharedVector<Particle> on field-subset scans,
+// and of SharedVector storage taken from HLM::AlignedResource (aligned, huge pages) on scans
+// Self-contained, no dependency beyond the headers of this repository
+//
+// Build (from the repository root), once per parallel backend :
+//   g++ -std=c++17 -O2 -DNDEBUG -I. benchmarks/hlm_benchmarks.cpp -o hlm_benchmarks -pthread
+//   g++ -std=c++17 -O2 -DNDEBUG -I. -fopenmp -DHLM_OMP_PARALLEL benchmarks/hlm_benchmarks.cpp -o hlm_benchmarks_omp
+//   g++ -std=c++17 -O2 -DNDEBUG -I. -DHLM_THREAD_PARALLEL benchmarks/hlm_benchmarks.cpp -o hlm_benchmarks_thread -pthread
+//
+// Run :
+//   hlm_benchmarks [--out results.json] [--min-size N] [--max-size N] [--min-time seconds]
+//                  [--container name] [--operation name]
+//   Sizes run from 8 to 10^8 by default, --max-size 1000000 keeps a run under a minute
+//   The JSON goes to stdout unless --out is given, the readable table always goes to stderr
+//
+// The JSON follows the layout of Google Benchmark (context + benchmarks, real_time in ns per
+// iteration) so the usual comparison scripts read it, with container / operation / size fields
+// added to each entry. The context records the parallel backend, compare runs of the same one
+//
+// Every measurement repeats the operation until --min-time has elapsed. Small sizes run in
+// batches : the inputs of a whole batch are prepared before the clock starts, so only the
+// operation itself is timed
+//
+// range_for sums a non-const vector with a range-based for loop. Only a build with NDEBUG compares
+// like with like : the iterators are raw pointers there, debug builds use the checked iterators of
+// hlm_iterator.hpp (generation check on every dereference)
+//
+// reduce and broadcast pass a callable, inlined into the loop, reduce_functor and broadcast_functor
+// do the same work through the virtual ReduceFunctor / BroadcastFunctor interfaces (std::vector
+// runs std::accumulate and std::fill for both)
+//
+// The particle runs (operations field_update and field_sum, containers SharedVector<Particle> and
+// SoAVector) store a 12-float record, 48 bytes per row : they stop at 10^7 rows whatever --max-size
+//
+// The sort runs (operations sort, sort_float and sort_cmp) sort n int keys, n float keys (both take
+// the radix passes) and n int keys with a comparator (merge sort), on Vector and SharedVector
+// serial (Vector/serial ...) and with HLM_PARALLEL (Vector/parallel ...), std::vector runs std::sort
+//
+// The lookup runs (operation indexed_find) call contains() 1024 times on a SharedVector after one
+// build_index() : alone (SharedVector/index), each after a read through a const reference
+// (SharedVector/index+const_reads), and each after a read through the non-const operator[]
+// (SharedVector/index+reads, up to 10^5 elements). That read drops the index, as every non-const
+// accessor does, and the lookups fall back to linear scans. size is n, real_time covers the 1024
+//
+// The scan runs (operations sequential_scan and random_scan) read a SharedVector<Element> whose
+// storage comes from operator new (SharedVector/new), an AlignedResource at 64 bytes
+// (SharedVector/aligned64), with transparent huge pages (SharedVector/thp) and with MAP_HUGETLB
+// (SharedVector/hugetlb, which falls back to thp without a reserved pool, see vm.nr_hugepages).
+// random_scan visits n uniformly drawn indices : beyond the cache it measures the TLB and DRAM
+//
+// The concurrent append runs (operation concurrent_push_back, from 10^4 elements) split n push_back
+// over 1, 2, 4 ... threads up to std::thread::hardware_concurrency() : ConcurrentSharedVector/<t>
+// against a std::vector behind a std::mutex (std::vector+mutex/<t>), thread start-up included
+//
+// The fan-out runs (operation fan_out, from 10^4 elements) hand a published SharedVector to 1, 2, 4 ...
+// threads up to hardware_concurrency(), as HLM_COW handles (SharedVector/cow/<t>, shared until the
+// first write) and as HLM_COPY handles (SharedVector/copy/<t>, one deep copy each). Every worker
+// reads the whole vector 4 times and one in 8 writes one element, thread start-up included
+//
+// The publication runs (operation load_under_churn, once per run on a 1000-element vector) count
+// the snapshots r readers take in --min-time while a writer republishes every 100 us, for r = 1,
+// 2, 4 ... up to hardware_concurrency() : AtomicSharedVector/<r>, a SharedVector behind a std::mutex
+// (mutex+SharedVector/<r>) and std::atomic_load of a std::shared_ptr (atomic_load(shared_ptr)/<r>)
+// real_time is the time per snapshot over all readers (size 1 : items_per_second counts snapshots),
+// the table adds millions of loads per second
+//
+// The serialization runs (container SharedVector/serialize) time save() into memory, the streaming
+// load() back, checksum64 alone, and map_saved() of a file in /dev/shm (or TMPDIR) with and
+// without the checksum, the table adds GB/s of payload. They stop at 10^7 elements
+//
+// The small-vector runs (operation small_vectors) fill n / 8 SharedVectors of 8 elements by push_back,
+// all alive at once, then drop them together. Storage comes from operator new (SharedVector/new),
+// an ArenaResource released after every round (SharedVector/arena) and a PoolResource whose free
+// lists are reused from round to round (SharedVector/pool). They stop at 10^7 elements
+//
+// The bounds runs (operation indexed_read) sum n elements through the const operator[](size_t)
+// of Vector and SharedVector under each BoundsPolicy (containers Vector/BoundsUnchecked ...
+// SharedVector/BoundsWarn), next to std::vector/operator[] : the gap is the cost of the check
+//
+// copy_share also runs on SharedVector<Element, SingleThreaded> and SharedVector<Element, MultiThreaded>
+// (containers SharedVector/SingleThreaded and SharedVector/MultiThreaded) : the same container under
+// both refcount policies, where Vector against SharedVector changes the policy and the container
+//
+// The legacy_layout runs (construct_destroy and operator[]) repeat those two operations of the
+// container runs on a copy of the block layout HLM::Vector had before the single-allocation block
+// (Data, then a heap std::vector<T>*, then the element buffer) : compare them with the Vector rows
+//
+// The first-touch runs (Vector and SharedVector) time the initialisation of a fresh vector :
+// resize (serial), resize_parallel, resize_uninitialized followed by a parallel broadcast
+// (resize_uninitialized_broadcast), and broadcast_serial next to the parallel broadcast above.
+// The parallel ones only differ from the serial ones with a parallel backend and several cores,
+// and only NUMA machines show the placement gain in the loops that follow
+
+#include "hlm_vector.hpp"
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_concurrent_vector.h"
+#include "hlm_vector_class/hlm_atomic_vector.h"
+#include "hlm_soa_vector.hpp"
+#include "hlm_serialize.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef int Element;
+
+// Keep the optimiser from discarding a result
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/// @brief Operations
+// One overload set per container, the HLM containers share every member used here
+// std::vector stands in with the closest standard algorithm
+namespace ops {
+
+    template <typename V>
+    V deep_copy(const V& source)
+    {
+        return V(source, HLM_COPY);
+    }
+    inline std::vector<Element> deep_copy(const std::vector<Element>& source)
+    {
+        return source;
+    }
+
+    template <typename V>
+    V from_std(const std::vector<Element>& source)
+    {
+        return V(source, HLM_COPY);
+    }
+    template <>
+    inline std::vector<Element> from_std<std::vector<Element>>(const std::vector<Element>& source)
+    {
+        return source;
+    }
+
+    template <typename V>
+    V from_std(const std::vector<float>& source)
+    {
+        return V(source, HLM_COPY);
+    }
+    template <>
+    inline std::vector<float> from_std<std::vector<float>>(const std::vector<float>& source)
+    {
+        return source;
+    }
+
+    template <typename V>
+    Element fast_access_sum(V& vector, const size_t& n)
+    {
+        Element sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += vector.fast_access(i);
+        }
+        return sum;
+    }
+    inline Element fast_access_sum(std::vector<Element>& vector, const size_t& n)
+    {
+        Element sum = 0;
+        const Element* elements = vector.data();
+        for (size_t i = 0; i < n; ++i) {
+            sum += elements[i];
+        }
+        return sum;
+    }
+
+    template <typename V>
+    void broadcast(V& vector, const Element& value)
+    {
+        vector.broadcast(value);
+    }
+    inline void broadcast(std::vector<Element>& vector, const Element& value)
+    {
+        std::fill(vector.begin(), vector.end(), value);
+    }
+
+    template <typename V>
+    Element reduce(const V& vector)
+    {
+        return vector.reduce(std::plus<Element>());
+    }
+    inline Element reduce(const std::vector<Element>& vector)
+    {
+        return std::accumulate(vector.begin(), vector.end(), Element(0));
+    }
+
+    // The virtual ReduceFunctor / BroadcastFunctor path, the containers above take callables
+    template <typename V>
+    class Plus : public V::reduce_functor_type {
+    public:
+        Element operator()(const Element& acc, const Element& element) const override { return acc + element; }
+    };
+
+    template <typename V>
+    class Assign : public V::broadcast_functor_type {
+    public:
+        explicit Assign(const Element& value) : value_(value) {}
+        void operator()(Element& element) override { element = value_; }
+
+    private:
+        Element value_;
+    };
+
+    template <typename V>
+    Element reduce_functor(V& vector)
+    {
+        const Plus<V> plus;
+        return vector.reduce(plus);
+    }
+    inline Element reduce_functor(std::vector<Element>& vector)
+    {
+        return std::accumulate(vector.begin(), vector.end(), Element(0));
+    }
+
+    template <typename V>
+    void broadcast_functor(V& vector, const Element& value)
+    {
+        Assign<V> assign(value);
+        vector.broadcast(assign);
+    }
+    inline void broadcast_functor(std::vector<Element>& vector, const Element& value)
+    {
+        std::fill(vector.begin(), vector.end(), value);
+    }
+
+    template <typename V>
+    void filter(V& vector)
+    {
+        vector.filter();
+    }
+    inline void filter(std::vector<Element>& vector)
+    {
+        std::sort(vector.begin(), vector.end());
+        vector.erase(std::unique(vector.begin(), vector.end()), vector.end());
+    }
+
+    // Not std::less : the HLM containers take the merge sort instead of the radix passes
+    struct Descending {
+        template <typename T>
+        bool operator()(const T& a, const T& b) const { return b < a; }
+    };
+
+    template <typename V>
+    void sort(V& vector, const bool& parallel)
+    {
+        vector.sort(parallel);
+    }
+    template <typename T>
+    void sort(std::vector<T>& vector, const bool&)
+    {
+        std::sort(vector.begin(), vector.end());
+    }
+
+    template <typename V>
+    void sort_descending(V& vector, const bool& parallel)
+    {
+        vector.sort(Descending(), parallel);
+    }
+    template <typename T>
+    void sort_descending(std::vector<T>& vector, const bool&)
+    {
+        std::sort(vector.begin(), vector.end(), Descending());
+    }
+
+    template <typename V>
+    bool find(const V& vector, const Element& value)
+    {
+        return &vector.find(value) != &V::DefaultValue();
+    }
+    inline bool find(const std::vector<Element>& vector, const Element& value)
+    {
+        return std::find(vector.begin(), vector.end(), value) != vector.end();
+    }
+
+    template <typename V>
+    V concatenate(const V& a, const V& b)
+    {
+        return a + b;
+    }
+    inline std::vector<Element> concatenate(const std::vector<Element>& a, const std::vector<Element>& b)
+    {
+        std::vector<Element> result;
+        result.reserve(a.size() + b.size());
+        result.insert(result.end(), a.begin(), a.end());
+        result.insert(result.end(), b.begin(), b.end());
+        return result;
+    }
+
+    /// @brief Particle operations
+    // The same record as rows (SharedVector<Particle>) and as columns (Particles)
+    // field_update touches 2 of the 12 fields (x += vx * dt), field_sum 1 (mass)
+    struct Particle {
+        float x, y, z, vx, vy, vz, ax, ay, az, mass, charge, age;
+    };
+
+    typedef HELIUM_API::SharedVector<Particle> ParticleRows;
+    typedef HLM::SoAVector<float, float, float, float, float, float, float, float, float, float, float, float> Particles;
+    enum ParticleField { field_x = 0, field_vx = 3, field_mass = 9 };
+
+    template <typename V>
+    V make_particles(const size_t& n);
+    template <>
+    inline ParticleRows make_particles<ParticleRows>(const size_t& n)
+    {
+        ParticleRows rows;
+        for (size_t i = 0; i < n; ++i) {
+            const float f = static_cast<float>(i % 1024);
+            rows.push_back(Particle{f, f, f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, f, 1.0f, 0.0f});
+        }
+        return rows;
+    }
+    template <>
+    inline Particles make_particles<Particles>(const size_t& n)
+    {
+        Particles columns;
+        columns.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            const float f = static_cast<float>(i % 1024);
+            columns.push_back(f, f, f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, f, 1.0f, 0.0f);
+        }
+        return columns;
+    }
+
+    inline void field_update(ParticleRows& rows, const float& dt)
+    {
+        rows.broadcast([dt](Particle& p) { p.x += p.vx * dt; });
+    }
+    inline void field_update(Particles& columns, const float& dt)
+    {
+        columns.broadcast<field_x, field_vx>([dt](float& x, const float& vx) { x += vx * dt; });
+    }
+
+    inline float field_sum(ParticleRows& rows, const size_t& n)
+    {
+        float sum = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            sum += rows.fast_access(i).mass;
+        }
+        return sum;
+    }
+    inline float field_sum(Particles& columns, const size_t&)
+    {
+        return columns.sum<field_mass>();
+    }
+
+} // namespace ops
+
+/// @brief legacy
+// The layout HLM::Vector had before the single-allocation block, kept as the baseline of the
+// legacy_layout runs : a refcounted Data holding a heap std::vector<T>*, so a vector costs three
+// allocations (Data, the std::vector, its buffer) and operator[] goes through two pointers
+// Trimmed to what construct_destroy and operator[] use (the original also registered an atexit
+// check for every block, left out : it would only add to the construction cost)
+namespace legacy {
+
+    template <typename T>
+    class Vector {
+    public:
+        explicit Vector(const std::vector<T>& externalVector) : m_data_(new Data(externalVector)) {}
+        Vector(const Vector& other) : m_data_(other.m_data_) { ++m_data_->count; }
+        Vector& operator=(const Vector&) = delete;
+        ~Vector()
+        {
+            if (m_data_ != nullptr && --m_data_->count == 0) {
+                delete m_data_;
+            }
+        }
+
+        T& operator[](const int& index)
+        {
+            if (is_valid()) {
+                if (index >= 0 && static_cast<size_t>(index) < m_data_->vector->size()) {
+                    return (*m_data_->vector)[static_cast<size_t>(index)];
+                }
+                else if (index < 0 && static_cast<size_t>(-index) <= m_data_->vector->size()) {
+                    return (*m_data_->vector)[m_data_->vector->size() - static_cast<size_t>(-index)];
+                }
+                std::cerr << "\nWarning : Index " << index << " out of bound. Returning default value \n";
+                return m_data_->vector->back();
+            }
+            return DefaultValue();
+        }
+
+    private:
+        struct Data {
+            static size_t& GlobalCount()
+            {
+                static size_t global_count = 0;
+                return global_count;
+            }
+
+            std::vector<T>* vector;
+            size_t count;
+            size_t UUID;
+
+            explicit Data(const std::vector<T>& externalVector)
+            : vector(new std::vector<T>(externalVector)), count(1), UUID(++GlobalCount()) {}
+            ~Data()
+            {
+                --GlobalCount();
+                delete vector;
+            }
+        };
+
+        bool is_valid() const
+        {
+            if (m_data_ != nullptr && m_data_->vector != nullptr && m_data_->count != 0) {
+                return true;
+            }
+            throw std::runtime_error("Accessing null or released vector");
+        }
+
+        static T& DefaultValue()
+        {
+            static T value = T();
+            return value;
+        }
+
+        Data* m_data_;
+    };
+
+} // namespace legacy
+
+struct Options {
+    size_t      min_size = 8;
+    size_t      max_size = 100000000;
+    double      min_time = 0.2;
+    std::string out;
+    std::string container;
+    std::string operation;
+};
+
+struct Result {
+    std::string container;
+    std::string operation;
+    size_t      size;
+    size_t      iterations;
+    double      ns_per_iteration;
+};
+
+/// @brief measure
+// prepare(k) builds the input of the k-th run of a batch, run(input) is the timed operation
+// Inputs are destroyed after the clock stops
+template <typename Input, typename Prepare, typename Run>
+Result measure(const Options& options, const size_t& n, Prepare prepare, Run run)
+{
+    typedef std::chrono::steady_clock Clock;
+    size_t batch = 1;
+    while (batch * n < 4096 && batch < 4096) {
+        batch *= 2;
+    }
+    size_t iterations = 0;
+    double elapsed = 0.0;
+    while (elapsed < options.min_time) {
+        std::vector<Input> inputs;
+        inputs.reserve(batch);
+        for (size_t k = 0; k < batch; ++k) {
+            inputs.push_back(prepare(k));
+        }
+        const Clock::time_point start = Clock::now();
+        for (size_t k = 0; k < batch; ++k) {
+            run(inputs[k]);
+        }
+        elapsed += std::chrono::duration<double>(Clock::now() - start).count();
+        iterations += batch;
+        // grow the batch while the clock overhead is still visible
+        if (elapsed < options.min_time / 100 && batch < (size_t(1) << 20)) {
+            batch *= 2;
+        }
+    }
+    Result result;
+    result.size = n;
+    result.iterations = iterations;
+    result.ns_per_iteration = elapsed * 1e9 / static_cast<double>(iterations);
+    return result;
+}
+
+struct Empty {};
+
+/// @brief run_container
+// Every operation for one container type and one size, source holds n random elements in [0, n)
+template <typename V>
+void run_container(const Options& options, const std::string& name, const std::vector<Element>& source,
+                   std::vector<Result>& results)
+{
+    const size_t n = source.size();
+    const Empty none = Empty();
+    auto wanted = [&](const char* operation) {
+        return options.operation.empty() || options.operation == operation;
+    };
+    auto record = [&](const char* operation, Result result) {
+        result.container = name;
+        result.operation = operation;
+        results.push_back(result);
+        std::fprintf(stderr, "%-14s %-18s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), operation, n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+
+    // Inputs of the mutating operations are full copies, the read-only ones share one vector
+    const V shared = ops::from_std<V>(source);
+    auto copy_of_source = [&](const size_t&) { return ops::from_std<V>(source); };
+    auto no_input = [&](const size_t&) { return none; };
+
+    if (wanted("construct_destroy")) {
+        record("construct_destroy", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V vector = ops::from_std<V>(source);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("copy_share")) {
+        // HLM handles share the block, std::vector has to copy
+        record("copy_share", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V copy(shared);
+            do_not_optimize(copy);
+        }));
+    }
+    if (wanted("deep_copy")) {
+        record("deep_copy", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V copy = ops::deep_copy(shared);
+            do_not_optimize(copy);
+        }));
+    }
+    if (wanted("operator[]")) {
+        V vector = ops::from_std<V>(source);
+        record("operator[]", measure<Empty>(options, n, no_input, [&](Empty&) {
+            Element sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += vector[static_cast<int>(i)];
+            }
+            do_not_optimize(sum);
+        }));
+    }
+    if (wanted("range_for")) {
+        V vector = ops::from_std<V>(source);
+        record("range_for", measure<Empty>(options, n, no_input, [&](Empty&) {
+            Element sum = 0;
+            for (const Element& element : vector) {
+                sum += element;
+            }
+            do_not_optimize(sum);
+        }));
+    }
+    if (wanted("fast_access")) {
+        V vector = ops::from_std<V>(source);
+        record("fast_access", measure<Empty>(options, n, no_input, [&](Empty&) {
+            const Element sum = ops::fast_access_sum(vector, n);
+            do_not_optimize(sum);
+        }));
+    }
+    if (wanted("push_back")) {
+        record("push_back", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V vector;
+            for (size_t i = 0; i < n; ++i) {
+                vector.push_back(source[i]);
+            }
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("broadcast")) {
+        V vector = ops::from_std<V>(source);
+        record("broadcast", measure<Empty>(options, n, no_input, [&](Empty&) {
+            ops::broadcast(vector, Element(7));
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("reduce")) {
+        record("reduce", measure<Empty>(options, n, no_input, [&](Empty&) {
+            const Element sum = ops::reduce(shared);
+            do_not_optimize(sum);
+        }));
+    }
+    if (wanted("reduce_functor")) {
+        V vector = ops::from_std<V>(source);
+        record("reduce_functor", measure<Empty>(options, n, no_input, [&](Empty&) {
+            const Element sum = ops::reduce_functor(vector);
+            do_not_optimize(sum);
+        }));
+    }
+    if (wanted("broadcast_functor")) {
+        V vector = ops::from_std<V>(source);
+        record("broadcast_functor", measure<Empty>(options, n, no_input, [&](Empty&) {
+            ops::broadcast_functor(vector, Element(7));
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("filter")) {
+        record("filter", measure<V>(options, n, copy_of_source, [&](V& vector) {
+            ops::filter(vector);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("find")) {
+        // -1 is never present : a full scan
+        record("find", measure<Empty>(options, n, no_input, [&](Empty&) {
+            const bool found = ops::find(shared, Element(-1));
+            do_not_optimize(found);
+        }));
+    }
+    if (wanted("concatenate")) {
+        record("concatenate", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V joined = ops::concatenate(shared, shared);
+            do_not_optimize(joined);
+        }));
+    }
+}
+
+/// @brief run_copy_share
+// The copy_share loop of run_container on SharedVector under one refcount policy, so the policy
+// changes alone (the Vector / SharedVector rows change the container and the policy together)
+template <typename ThreadPolicy>
+void run_copy_share(const Options& options, const std::string& name, const std::vector<Element>& source,
+                    std::vector<Result>& results)
+{
+    if (!(options.operation.empty() || options.operation == "copy_share") ||
+        !(options.container.empty() || options.container == name)) {
+        return;
+    }
+    const size_t n = source.size();
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+
+    typedef HELIUM_API::SharedVector<Element, ThreadPolicy> V;
+    const V shared = ops::from_std<V>(source);
+    Result result = measure<Empty>(options, n, no_input, [&](Empty&) {
+        V copy(shared);
+        do_not_optimize(copy);
+    });
+    result.container = name;
+    result.operation = "copy_share";
+    results.push_back(result);
+    std::fprintf(stderr, "%-28s %-18s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), "copy_share", n,
+                 result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+}
+
+/// @brief run_small_vectors
+// n elements as n / 8 short SharedVectors filled by push_back, all alive at once then dropped together,
+// storage from operator new, an ArenaResource (released after each round) and a PoolResource
+void run_small_vectors(const Options& options, const std::vector<Element>& source, std::vector<Result>& results)
+{
+    if (!(options.operation.empty() || options.operation == "small_vectors")) {
+        return;
+    }
+    typedef HELIUM_API::SharedVector<Element> V;
+    const size_t n = source.size();
+    const size_t length = 8;
+    const size_t count = (n + length - 1) / length;
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto record = [&](const std::string& name, Result result) {
+        result.container = name;
+        result.operation = "small_vectors";
+        results.push_back(result);
+        std::fprintf(stderr, "%-22s %-16s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), "small_vectors", n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+
+    // The handles live in one buffer reserved up front, only the vectors themselves allocate
+    std::vector<V> handles;
+    handles.reserve(count);
+    auto fill = [&](std::pmr::memory_resource* resource) {
+        for (size_t v = 0; v < count; ++v) {
+            handles.emplace_back(resource);
+            V& vector = handles.back();
+            for (size_t i = v * length; i < n && i < (v + 1) * length; ++i) {
+                vector.push_back(source[i]);
+            }
+        }
+        do_not_optimize(handles);
+        handles.clear();
+    };
+
+    HLM::ArenaResource arena;
+    HLM::PoolResource pool;
+    if (options.container.empty() || options.container == "SharedVector/new") {
+        record("SharedVector/new", measure<Empty>(options, n, no_input, [&](Empty&) {
+            fill(nullptr);
+        }));
+    }
+    if (options.container.empty() || options.container == "SharedVector/arena") {
+        record("SharedVector/arena", measure<Empty>(options, n, no_input, [&](Empty&) {
+            fill(&arena);
+            arena.release();
+        }));
+    }
+    if (options.container.empty() || options.container == "SharedVector/pool") {
+        record("SharedVector/pool", measure<Empty>(options, n, no_input, [&](Empty&) {
+            fill(&pool);
+        }));
+    }
+}
+
+/// @brief run_legacy_layout
+// construct_destroy and operator[] of the pre-series block layout (see namespace legacy), the same
+// loops as run_container : compare with the Vector rows of the same size
+void run_legacy_layout(const Options& options, const std::vector<Element>& source, std::vector<Result>& results)
+{
+    const size_t n = source.size();
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto wanted = [&](const char* operation) {
+        return options.operation.empty() || options.operation == operation;
+    };
+    auto record = [&](const char* operation, Result result) {
+        result.container = "legacy_layout";
+        result.operation = operation;
+        results.push_back(result);
+        std::fprintf(stderr, "%-14s %-18s %10zu %14.1f ns %12.3f ns/element\n", "legacy_layout", operation, n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+
+    if (wanted("construct_destroy")) {
+        record("construct_destroy", measure<Empty>(options, n, no_input, [&](Empty&) {
+            legacy::Vector<Element> vector(source);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("operator[]")) {
+        legacy::Vector<Element> vector(source);
+        record("operator[]", measure<Empty>(options, n, no_input, [&](Empty&) {
+            Element sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += vector[static_cast<int>(i)];
+            }
+            do_not_optimize(sum);
+        }));
+    }
+}
+
+/// @brief run_sort
+// sort of int keys and float keys (radix passes in the HLM containers) and sort with a comparator
+// (merge sort), serial or HLM_PARALLEL, std::vector runs std::sort
+template <typename VInt, typename VFloat>
+void run_sort(const Options& options, const std::string& name, const bool& parallel, const std::vector<Element>& source,
+              const std::vector<float>& floats, std::vector<Result>& results)
+{
+    if (!(options.container.empty() || options.container == name)) {
+        return;
+    }
+    const size_t n = source.size();
+    auto wanted = [&](const char* operation) {
+        return options.operation.empty() || options.operation == operation;
+    };
+    auto record = [&](const char* operation, Result result) {
+        result.container = name;
+        result.operation = operation;
+        results.push_back(result);
+        std::fprintf(stderr, "%-22s %-12s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), operation, n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+
+    if (wanted("sort")) {
+        record("sort", measure<VInt>(options, n, [&](const size_t&) { return ops::from_std<VInt>(source); },
+                                     [&](VInt& vector) {
+            ops::sort(vector, parallel);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("sort_float")) {
+        record("sort_float", measure<VFloat>(options, n, [&](const size_t&) { return ops::from_std<VFloat>(floats); },
+                                             [&](VFloat& vector) {
+            ops::sort(vector, parallel);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("sort_cmp")) {
+        record("sort_cmp", measure<VInt>(options, n, [&](const size_t&) { return ops::from_std<VInt>(source); },
+                                         [&](VInt& vector) {
+            ops::sort_descending(vector, parallel);
+            do_not_optimize(vector);
+        }));
+    }
+}
+
+/// @brief run_indexed_find
+// 1024 contains() of present values after one build_index() : on their own, each after a read through
+// the const operator[], and each after a read through the non-const operator[], which drops the index
+// and leaves a linear scan per lookup (up to 10^5 elements)
+void run_indexed_find(const Options& options, const std::vector<Element>& source, std::vector<Result>& results)
+{
+    if (!(options.operation.empty() || options.operation == "indexed_find")) {
+        return;
+    }
+    typedef HELIUM_API::SharedVector<Element> V;
+    const size_t n = source.size();
+    const size_t lookups = 1024;
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto record = [&](const std::string& name, Result result) {
+        result.container = name;
+        result.operation = "indexed_find";
+        result.size = n;
+        results.push_back(result);
+        std::fprintf(stderr, "%-30s %-14s %10zu %14.1f ns %12.3f ns/lookup\n", name.c_str(), "indexed_find", n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(lookups));
+    };
+    auto wanted = [&](const std::string& name) {
+        return options.container.empty() || options.container == name;
+    };
+    std::vector<Element> keys(lookups);
+    for (size_t k = 0; k < lookups; ++k) {
+        keys[k] = source[(k * 7919) % n];
+    }
+
+    if (wanted("SharedVector/index")) {
+        V vector = ops::from_std<V>(source);
+        vector.build_index();
+        record("SharedVector/index", measure<Empty>(options, lookups, no_input, [&](Empty&) {
+            size_t found = 0;
+            for (size_t k = 0; k < lookups; ++k) {
+                found += vector.contains(keys[k]);
+            }
+            do_not_optimize(found);
+        }));
+    }
+    if (wanted("SharedVector/index+const_reads")) {
+        V vector = ops::from_std<V>(source);
+        vector.build_index();
+        const V& view = vector;
+        record("SharedVector/index+const_reads", measure<Empty>(options, lookups, no_input, [&](Empty&) {
+            size_t found = 0;
+            for (size_t k = 0; k < lookups; ++k) {
+                found += static_cast<size_t>(view[k % n] != 0);
+                found += vector.contains(keys[k]);
+            }
+            do_not_optimize(found);
+        }));
+    }
+    if (n <= 100000 && wanted("SharedVector/index+reads")) {
+        V vector = ops::from_std<V>(source);
+        vector.build_index();
+        record("SharedVector/index+reads", measure<Empty>(options, lookups, no_input, [&](Empty&) {
+            size_t found = 0;
+            for (size_t k = 0; k < lookups; ++k) {
+                found += static_cast<size_t>(vector[k % n] != 0);
+                found += vector.contains(keys[k]);
+            }
+            do_not_optimize(found);
+        }));
+    }
+}
+
+/// @brief run_scans
+// Sequential and random reads over n elements, order holds the indices of the random pass
+void run_scans(const Options& options, const std::string& name, std::pmr::memory_resource* resource,
+               const std::vector<Element>& source, const std::vector<uint32_t>& order, std::vector<Result>& results)
+{
+    const size_t n = source.size();
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto wanted = [&](const char* operation) {
+        return options.operation.empty() || options.operation == operation;
+    };
+    auto record = [&](const char* operation, Result result) {
+        result.container = name;
+        result.operation = operation;
+        results.push_back(result);
+        std::fprintf(stderr, "%-22s %-16s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), operation, n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+    if (!wanted("sequential_scan") && !wanted("random_scan")) {
+        return;
+    }
+
+    HELIUM_API::SharedVector<Element> vector(source, resource);
+    if (wanted("sequential_scan")) {
+        record("sequential_scan", measure<Empty>(options, n, no_input, [&](Empty&) {
+            const Element sum = ops::fast_access_sum(vector, n);
+            do_not_optimize(sum);
+        }));
+    }
+    if (wanted("random_scan")) {
+        record("random_scan", measure<Empty>(options, n, no_input, [&](Empty&) {
+            Element sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += vector.fast_access(order[i]);
+            }
+            do_not_optimize(sum);
+        }));
+    }
+}
+
+/// @brief run_concurrent_append
+// n push_back split over threads, the lock-free vector against a locked std::vector
+void run_concurrent_append(const Options& options, const size_t& n, std::vector<Result>& results)
+{
+    if (!(options.operation.empty() || options.operation == "concurrent_push_back")) {
+        return;
+    }
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto record = [&](const std::string& name, Result result) {
+        result.container = name;
+        result.operation = "concurrent_push_back";
+        results.push_back(result);
+        std::fprintf(stderr, "%-26s %-20s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), "concurrent_push_back", n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+    // Runs task(t, first, last) on threads threads over [0, n)
+    auto split = [n](const size_t& threads, const std::function<void(size_t, size_t)>& task) {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back(task, n * t / threads, n * (t + 1) / threads);
+        }
+        for (size_t t = 0; t < threads; ++t) {
+            workers[t].join();
+        }
+    };
+
+    const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t threads = 1; threads < hardware; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware);
+    for (size_t c = 0; c < counts.size(); ++c) {
+        const size_t threads = counts[c];
+        const std::string suffix = "/" + std::to_string(threads);
+        if (options.container.empty() || options.container == "ConcurrentSharedVector" + suffix) {
+            record("ConcurrentSharedVector" + suffix, measure<Empty>(options, n, no_input, [&](Empty&) {
+                HELIUM_API::ConcurrentSharedVector<Element> vector;
+                split(threads, [&vector](size_t first, size_t last) {
+                    for (size_t i = first; i < last; ++i) {
+                        vector.push_back(static_cast<Element>(i));
+                    }
+                });
+                do_not_optimize(vector);
+            }));
+        }
+        if (options.container.empty() || options.container == "std::vector+mutex" + suffix) {
+            record("std::vector+mutex" + suffix, measure<Empty>(options, n, no_input, [&](Empty&) {
+                std::vector<Element> vector;
+                std::mutex mutex;
+                split(threads, [&vector, &mutex](size_t first, size_t last) {
+                    for (size_t i = first; i < last; ++i) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        vector.push_back(static_cast<Element>(i));
+                    }
+                });
+                do_not_optimize(vector);
+            }));
+        }
+    }
+}
+
+/// @brief run_fan_out
+// A published vector handed to t workers as HLM_COW handles (shared until written) and as HLM_COPY
+// handles (one deep copy each) : every worker reads the whole vector 4 times, one in 8 then writes
+// one element, handle creation included
+void run_fan_out(const Options& options, const std::vector<Element>& source, std::vector<Result>& results)
+{
+    if (!(options.operation.empty() || options.operation == "fan_out")) {
+        return;
+    }
+    typedef HELIUM_API::SharedVector<Element> V;
+    const size_t n = source.size();
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto record = [&](const std::string& name, Result result) {
+        result.container = name;
+        result.operation = "fan_out";
+        results.push_back(result);
+        std::fprintf(stderr, "%-26s %-20s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), "fan_out", n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+    auto worker = [n](V& handle, const size_t& w) {
+        const V& view = handle;
+        Element sum = 0;
+        for (size_t pass = 0; pass < 4; ++pass) {
+            for (size_t i = 0; i < n; ++i) {
+                sum += view[i];
+            }
+        }
+        if (w % 8 == 0) {
+            handle[size_t(0)] = sum;
+        }
+        do_not_optimize(sum);
+    };
+    const V published = ops::from_std<V>(source);
+    auto fan_out = [&](const size_t& threads, const int& mode) {
+        std::vector<V> handles;
+        handles.reserve(threads);
+        for (size_t w = 0; w < threads; ++w) {
+            handles.emplace_back(published, mode);
+        }
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < threads; ++w) {
+            workers.emplace_back(worker, std::ref(handles[w]), w);
+        }
+        for (size_t w = 0; w < threads; ++w) {
+            workers[w].join();
+        }
+    };
+
+    const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t threads = 1; threads < hardware; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(hardware);
+    for (size_t c = 0; c < counts.size(); ++c) {
+        const size_t threads = counts[c];
+        const std::string suffix = "/" + std::to_string(threads);
+        if (options.container.empty() || options.container == "SharedVector/cow" + suffix) {
+            record("SharedVector/cow" + suffix, measure<Empty>(options, n, no_input, [&](Empty&) {
+                fan_out(threads, HLM_COW);
+            }));
+        }
+        if (options.container.empty() || options.container == "SharedVector/copy" + suffix) {
+            record("SharedVector/copy" + suffix, measure<Empty>(options, n, no_input, [&](Empty&) {
+                fan_out(threads, HLM_COPY);
+            }));
+        }
+    }
+}
+
+/// @brief run_publication
+// Snapshot throughput of readers while a writer keeps republishing, for each publication scheme
+void run_publication(const Options& options, std::vector<Result>& results)
+{
+    if (!(options.operation.empty() || options.operation == "load_under_churn")) {
+        return;
+    }
+    typedef HELIUM_API::SharedVector<Element> V;
+    const size_t n = 1000;
+    auto make_version = [n](const Element& v) {
+        V vector;
+        vector.resize(n);
+        vector.broadcast(v);
+        return vector;
+    };
+
+    // Runs readers threads calling read() against one writer calling write(v) every 100 us
+    // for min_time, returns the total number of reads
+    auto churn = [&options](const size_t& readers, const std::function<void()>& read,
+                            const std::function<void(Element)>& write) {
+        std::atomic<bool> stop(false);
+        std::vector<size_t> counts(readers * 8, 0);   // one cache line apart
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&stop, &counts, &read, r]() {
+                size_t count = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    read();
+                    ++count;
+                }
+                counts[r * 8] = count;
+            });
+        }
+        threads.emplace_back([&stop, &write]() {
+            Element v = 1;
+            while (!stop.load(std::memory_order_relaxed)) {
+                write(v++);
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::duration<double>(options.min_time));
+        stop.store(true);
+        for (size_t t = 0; t < threads.size(); ++t) {
+            threads[t].join();
+        }
+        size_t total = 0;
+        for (size_t r = 0; r < readers; ++r) {
+            total += counts[r * 8];
+        }
+        return total;
+    };
+    auto record = [&](const std::string& name, const size_t& loads) {
+        Result result;
+        result.container = name;
+        result.operation = "load_under_churn";
+        result.size = 1;
+        result.iterations = loads;
+        result.ns_per_iteration = (loads != 0) ? options.min_time * 1e9 / static_cast<double>(loads) : 0.0;
+        results.push_back(result);
+        std::fprintf(stderr, "%-28s %-18s %10zu %14.1f ns %10.1f M loads/s\n", name.c_str(), "load_under_churn", result.size,
+                     result.ns_per_iteration, static_cast<double>(loads) / options.min_time * 1e-6);
+    };
+    auto wanted = [&options](const std::string& name) {
+        return options.container.empty() || options.container == name;
+    };
+
+    const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t readers = 1; readers < hardware; readers *= 2) {
+        counts.push_back(readers);
+    }
+    counts.push_back(hardware);
+    for (size_t c = 0; c < counts.size(); ++c) {
+        const size_t readers = counts[c];
+        const std::string suffix = "/" + std::to_string(readers);
+        if (wanted("AtomicSharedVector" + suffix)) {
+            HELIUM_API::AtomicSharedVector<Element> slot(make_version(0));
+            record("AtomicSharedVector" + suffix, churn(readers,
+                [&slot]() { V snapshot = slot.load(); do_not_optimize(snapshot); },
+                [&slot, &make_version](Element v) { slot.store(make_version(v)); }));
+        }
+        if (wanted("mutex+SharedVector" + suffix)) {
+            V published = make_version(0);
+            std::mutex mutex;
+            record("mutex+SharedVector" + suffix, churn(readers,
+                [&published, &mutex]() {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    V snapshot(published);
+                    lock.unlock();
+                    do_not_optimize(snapshot);
+                },
+                [&published, &mutex, &make_version](Element v) {
+                    V next = make_version(v);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    published = next;
+                }));
+        }
+        if (wanted("atomic_load(shared_ptr)" + suffix)) {
+            std::shared_ptr<const std::vector<Element>> published = std::make_shared<const std::vector<Element>>(n, 0);
+            record("atomic_load(shared_ptr)" + suffix, churn(readers,
+                [&published]() {
+                    std::shared_ptr<const std::vector<Element>> snapshot = std::atomic_load(&published);
+                    do_not_optimize(snapshot);
+                },
+                [&published, n](Element v) {
+                    std::atomic_store(&published, std::make_shared<const std::vector<Element>>(n, v));
+                }));
+        }
+    }
+}
+
+/// @brief run_serialize
+// save / load / map_saved throughput of n elements
+void run_serialize(const Options& options, const std::vector<Element>& source, std::vector<Result>& results)
+{
+    typedef HELIUM_API::SharedVector<Element> V;
+    const std::string name = "SharedVector/serialize";
+    const size_t n = source.size();
+    const double payload_bytes = static_cast<double>(n * sizeof(Element));
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto wanted = [&](const char* operation) {
+        return options.operation.empty() || options.operation == operation;
+    };
+    auto record = [&](const char* operation, Result result) {
+        result.container = name;
+        result.operation = operation;
+        results.push_back(result);
+        std::fprintf(stderr, "%-22s %-20s %10zu %14.1f ns %10.2f GB/s\n", name.c_str(), operation, n,
+                     result.ns_per_iteration, payload_bytes / result.ns_per_iteration);
+    };
+    if (!(options.container.empty() || options.container == name)) {
+        return;
+    }
+
+    const V vector(source, HLM_COPY);
+    std::ostringstream saved(std::ios::binary);
+    HLM::save(saved, vector);
+    const std::string image = saved.str();
+
+    if (wanted("save")) {
+        record("save", measure<Empty>(options, n, no_input, [&](Empty&) {
+            std::ostringstream out(std::ios::binary);
+            HLM::save(out, vector);
+            do_not_optimize(out);
+        }));
+    }
+    if (wanted("load")) {
+        record("load", measure<Empty>(options, n, no_input, [&](Empty&) {
+            std::istringstream in(image, std::ios::binary);
+            V loaded = HLM::load<V>(in);
+            do_not_optimize(loaded);
+        }));
+    }
+    if (wanted("checksum64")) {
+        record("checksum64", measure<Empty>(options, n, no_input, [&](Empty&) {
+            const uint64_t checksum = HLM::checksum64(image.data() + HLM::detail::payload_alignment<Element>(), n * sizeof(Element));
+            do_not_optimize(checksum);
+        }));
+    }
+    if (wanted("map_saved") || wanted("map_saved_unchecked")) {
+        const char* directory = std::getenv("TMPDIR");
+        std::FILE* probe = std::fopen("/dev/shm/hlm_benchmarks_probe", "wb");
+        if (probe != nullptr) {
+            std::fclose(probe);
+            std::remove("/dev/shm/hlm_benchmarks_probe");
+            directory = "/dev/shm";
+        }
+        const std::string path = std::string(directory != nullptr ? directory : "/tmp") + "/hlm_benchmarks_saved.bin";
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            std::fprintf(stderr, "cannot write %s, map_saved skipped\n", path.c_str());
+            return;
+        }
+        std::fwrite(image.data(), 1, image.size(), file);
+        std::fclose(file);
+        if (wanted("map_saved")) {
+            record("map_saved", measure<Empty>(options, n, no_input, [&](Empty&) {
+                V mapped = V::map_saved(path, HLM_MAP_READONLY, HLM_VERIFY_CHECKSUM);
+                do_not_optimize(mapped);
+            }));
+        }
+        if (wanted("map_saved_unchecked")) {
+            record("map_saved_unchecked", measure<Empty>(options, n, no_input, [&](Empty&) {
+                V mapped = V::map_saved(path, HLM_MAP_READONLY, HLM_SKIP_CHECKSUM);
+                do_not_optimize(mapped);
+            }));
+        }
+        std::remove(path.c_str());
+    }
+}
+
+/// @brief run_bounds
+// Indexed reads of n elements through operator[], V carries the BoundsPolicy under test
+template <typename V>
+void run_bounds(const Options& options, const std::string& name, const std::vector<Element>& source,
+                std::vector<Result>& results)
+{
+    const size_t n = source.size();
+    if (!(options.operation.empty() || options.operation == "indexed_read") ||
+        !(options.container.empty() || options.container == name)) {
+        return;
+    }
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+
+    const V vector = ops::from_std<V>(source);
+    Result result = measure<Empty>(options, n, no_input, [&](Empty&) {
+        Element sum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            sum += vector[i];
+        }
+        do_not_optimize(sum);
+    });
+    result.container = name;
+    result.operation = "indexed_read";
+    results.push_back(result);
+    std::fprintf(stderr, "%-28s %-16s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), "indexed_read", n,
+                 result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+}
+
+template <typename Policy>
+void run_bounds_policy(const Options& options, const char* policy, const std::vector<Element>& source,
+                       std::vector<Result>& results)
+{
+    run_bounds<HLM::Vector<Element, HLM::SingleThreaded, 0, Policy>>(
+        options, std::string("Vector/") + policy, source, results);
+    run_bounds<HELIUM_API::SharedVector<Element, HLM::MultiThreaded, 0, Policy>>(
+        options, std::string("SharedVector/") + policy, source, results);
+}
+
+/// @brief run_first_touch
+// Initialisation of n elements, serial against split over the parallel workers
+template <typename V>
+void run_first_touch(const Options& options, const std::string& name, const size_t& n, std::vector<Result>& results)
+{
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto wanted = [&](const char* operation) {
+        return options.operation.empty() || options.operation == operation;
+    };
+    auto record = [&](const char* operation, Result result) {
+        result.container = name;
+        result.operation = operation;
+        results.push_back(result);
+        std::fprintf(stderr, "%-14s %-30s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), operation, n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+
+    if (wanted("resize")) {
+        record("resize", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V vector;
+            vector.resize(n);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("resize_parallel")) {
+        record("resize_parallel", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V vector;
+            vector.resize_parallel(n);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("resize_uninitialized_broadcast")) {
+        record("resize_uninitialized_broadcast", measure<Empty>(options, n, no_input, [&](Empty&) {
+            V vector;
+            vector.resize_uninitialized(n);
+            vector.broadcast(Element(7), HLM_PARALLEL);
+            do_not_optimize(vector);
+        }));
+    }
+    if (wanted("broadcast_serial")) {
+        V vector;
+        vector.resize(n);
+        record("broadcast_serial", measure<Empty>(options, n, no_input, [&](Empty&) {
+            vector.broadcast(Element(7), HLM_SERIAL);
+            do_not_optimize(vector);
+        }));
+    }
+}
+
+/// @brief run_particles
+// Field-subset scans over n particles
+template <typename V>
+void run_particles(const Options& options, const std::string& name, const size_t& n, std::vector<Result>& results)
+{
+    const Empty none = Empty();
+    auto no_input = [&](const size_t&) { return none; };
+    auto wanted = [&](const char* operation) {
+        return options.operation.empty() || options.operation == operation;
+    };
+    auto record = [&](const char* operation, Result result) {
+        result.container = name;
+        result.operation = operation;
+        results.push_back(result);
+        std::fprintf(stderr, "%-22s %-14s %10zu %14.1f ns %12.3f ns/element\n", name.c_str(), operation, n,
+                     result.ns_per_iteration, result.ns_per_iteration / static_cast<double>(n));
+    };
+    if (!wanted("field_update") && !wanted("field_sum")) {
+        return;
+    }
+
+    V particles = ops::make_particles<V>(n);
+    if (wanted("field_update")) {
+        record("field_update", measure<Empty>(options, n, no_input, [&](Empty&) {
+            ops::field_update(particles, 0.01f);
+            do_not_optimize(particles);
+        }));
+    }
+    if (wanted("field_sum")) {
+        record("field_sum", measure<Empty>(options, n, no_input, [&](Empty&) {
+            const float sum = ops::field_sum(particles, n);
+            do_not_optimize(sum);
+        }));
+    }
+}
+
+static const char* parallel_backend()
+{
+#if defined(HLM_OMP_PARALLEL)
+    return "omp";
+#elif defined(HLM_THREAD_PARALLEL)
+    return "thread";
+#else
+    return "serial";
+#endif
+}
+
+static const char* compiler()
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc";
+#else
+    return "unknown";
+#endif
+}
+
+static void write_json(std::FILE* file, const Options& options, const std::vector<Result>& results)
+{
+    char date[32];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    std::fprintf(file, "{\n  \"context\": {\n");
+    std::fprintf(file, "    \"date\": \"%s\",\n", date);
+    std::fprintf(file, "    \"compiler\": \"%s\",\n", compiler());
+    std::fprintf(file, "    \"parallel\": \"%s\",\n", parallel_backend());
+    std::fprintf(file, "    \"threads\": %zu,\n", HLM::parallel::thread_count());
+    std::fprintf(file, "    \"element\": \"int%zu\",\n", sizeof(Element) * 8);
+    std::fprintf(file, "    \"min_time\": %g\n", options.min_time);
+    std::fprintf(file, "  },\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        const double seconds = r.ns_per_iteration * 1e-9;
+        std::fprintf(file, "    {\"name\": \"%s/%s/%zu\", \"container\": \"%s\", \"operation\": \"%s\", "
+                           "\"size\": %zu, \"iterations\": %zu, \"real_time\": %.3f, \"time_unit\": \"ns\", "
+                           "\"items_per_second\": %.6g}%s\n",
+                     r.container.c_str(), r.operation.c_str(), r.size, r.container.c_str(), r.operation.c_str(),
+                     r.size, r.iterations, r.ns_per_iteration,
+                     (seconds > 0.0) ? static_cast<double>(r.size) / seconds : 0.0,
+                     (i + 1 < results.size()) ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+}
+
+static bool parse(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value after %s\n", argument.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        if (argument == "--out") {
+            options.out = value;
+        }
+        else if (argument == "--min-size") {
+            options.min_size = std::strtoull(value, nullptr, 10);
+        }
+        else if (argument == "--max-size") {
+            options.max_size = std::strtoull(value, nullptr, 10);
+        }
+        else if (argument == "--min-time") {
+            options.min_time = std::strtod(value, nullptr);
+        }
+        else if (argument == "--container") {
+            options.container = value;
+        }
+        else if (argument == "--operation") {
+            options.operation = value;
+        }
+        else {
+            std::fprintf(stderr, "unknown option %s\n", argument.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parse(argc, argv, options)) {
+        return 2;
+    }
+
+    // 8, 64, 512, then powers of ten up to 10^8
+    std::vector<size_t> sizes = {8, 64, 512};
+    for (size_t size = 10000; size <= 100000000; size *= 10) {
+        sizes.push_back(size);
+    }
+
+    std::fprintf(stderr, "parallel backend : %s, %zu thread(s)\n", parallel_backend(), HLM::parallel::thread_count());
+    std::vector<Result> results;
+    std::mt19937 generator(42);
+    for (size_t s = 0; s < sizes.size(); ++s) {
+        const size_t n = sizes[s];
+        if (n < options.min_size || n > options.max_size) {
+            continue;
+        }
+        std::uniform_int_distribution<Element> distribution(0, static_cast<Element>(n - 1));
+        std::vector<Element> source(n);
+        for (size_t i = 0; i < n; ++i) {
+            source[i] = distribution(generator);
+        }
+        if (options.container.empty() || options.container == "std::vector") {
+            run_container<std::vector<Element>>(options, "std::vector", source, results);
+        }
+        if (options.container.empty() || options.container == "Vector") {
+            run_container<HLM::Vector<Element>>(options, "Vector", source, results);
+        }
+        if (options.container.empty() || options.container == "SharedVector") {
+            run_container<HELIUM_API::SharedVector<Element>>(options, "SharedVector", source, results);
+        }
+        run_copy_share<HLM::SingleThreaded>(options, "SharedVector/SingleThreaded", source, results);
+        run_copy_share<HLM::MultiThreaded>(options, "SharedVector/MultiThreaded", source, results);
+        if (options.container.empty() || options.container == "legacy_layout") {
+            run_legacy_layout(options, source, results);
+        }
+        if (options.container.empty() || options.container == "Vector") {
+            run_first_touch<HLM::Vector<Element>>(options, "Vector", n, results);
+        }
+        if (options.container.empty() || options.container == "SharedVector") {
+            run_first_touch<HELIUM_API::SharedVector<Element>>(options, "SharedVector", n, results);
+        }
+        if (options.operation.empty() || options.operation == "sort" || options.operation == "sort_float" ||
+            options.operation == "sort_cmp") {
+            // Negative and positive keys with a fractional part
+            std::vector<float> floats(n);
+            for (size_t i = 0; i < n; ++i) {
+                floats[i] = static_cast<float>(source[i]) * 0.5f - static_cast<float>(n / 4);
+            }
+            run_sort<std::vector<Element>, std::vector<float>>(options, "std::vector", HLM_SERIAL, source, floats, results);
+            run_sort<HLM::Vector<Element>, HLM::Vector<float>>(options, "Vector/serial", HLM_SERIAL, source, floats, results);
+            run_sort<HLM::Vector<Element>, HLM::Vector<float>>(options, "Vector/parallel", HLM_PARALLEL, source, floats, results);
+            run_sort<HELIUM_API::SharedVector<Element>, HELIUM_API::SharedVector<float>>(
+                options, "SharedVector/serial", HLM_SERIAL, source, floats, results);
+            run_sort<HELIUM_API::SharedVector<Element>, HELIUM_API::SharedVector<float>>(
+                options, "SharedVector/parallel", HLM_PARALLEL, source, floats, results);
+        }
+        run_indexed_find(options, source, results);
+        if (options.operation.empty() || options.operation == "sequential_scan" || options.operation == "random_scan") {
+            std::vector<uint32_t> order(n);
+            for (size_t i = 0; i < n; ++i) {
+                order[i] = static_cast<uint32_t>(distribution(generator));
+            }
+            HLM::AlignedResource aligned(HLM_ALIGN_CACHE_LINE);
+            HLM::AlignedResource thp(HLM_ALIGN_CACHE_LINE, HLM_HUGE_PAGES_TRANSPARENT);
+            HLM::AlignedResource hugetlb(HLM_ALIGN_CACHE_LINE, HLM_HUGE_PAGES_EXPLICIT);
+            const struct {
+                const char*                name;
+                std::pmr::memory_resource* resource;
+            } storages[] = {
+                {"SharedVector/new", nullptr},
+                {"SharedVector/aligned64", &aligned},
+                {"SharedVector/thp", &thp},
+                {"SharedVector/hugetlb", &hugetlb},
+            };
+            for (size_t k = 0; k < sizeof(storages) / sizeof(storages[0]); ++k) {
+                if (options.container.empty() || options.container == storages[k].name) {
+                    run_scans(options, storages[k].name, storages[k].resource, source, order, results);
+                }
+            }
+        }
+        if (options.operation.empty() || options.operation == "indexed_read") {
+            run_bounds<std::vector<Element>>(options, "std::vector/operator[]", source, results);
+            run_bounds_policy<HLM::BoundsUnchecked>(options, "BoundsUnchecked", source, results);
+            run_bounds_policy<HLM::BoundsAssert>(options, "BoundsAssert", source, results);
+            run_bounds_policy<HLM::BoundsClamp>(options, "BoundsClamp", source, results);
+            run_bounds_policy<HLM::BoundsThrow>(options, "BoundsThrow", source, results);
+            run_bounds_policy<HLM::BoundsTrap>(options, "BoundsTrap", source, results);
+            run_bounds_policy<HLM::BoundsWarn>(options, "BoundsWarn", source, results);
+        }
+        if (n >= 10000) {
+            run_concurrent_append(options, n, results);
+            run_fan_out(options, source, results);
+        }
+        if (n <= 10000000) {
+            run_serialize(options, source, results);
+            run_small_vectors(options, source, results);
+            if (options.container.empty() || options.container == "SharedVector<Particle>") {
+                run_particles<ops::ParticleRows>(options, "SharedVector<Particle>", n, results);
+            }
+            if (options.container.empty() || options.container == "SoAVector") {
+                run_particles<ops::Particles>(options, "SoAVector", n, results);
+            }
+        }
+    }
+
+    run_publication(options, results);
+
+    std::FILE* file = stdout;
+    if (!options.out.empty()) {
+        file = std::fopen(options.out.c_str(), "w");
+        if (file == nullptr) {
+            std::fprintf(stderr, "cannot write %s\n", options.out.c_str());
+            return 1;
+        }
+    }
+    write_json(file, options, results);
+    if (file != stdout) {
+        std::fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,148 @@
+#ifndef _HLM_BOUNDS_HPP_
+#define _HLM_BOUNDS_HPP_
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include <cstddef>
+#include "hlm_config.hpp"
+
+namespace HLM {
+
+namespace detail {
+
+    // Out-of-bounds and invalid-handle reporting, kept out of line so the inlined
+    // accessors only carry a compare and a branch to these
+    HLM_COLD inline void warn_out_of_bounds(const size_t& index, const size_t& length)
+    {
+        std::cerr << "\nWarning : Index " << index << " out of bound (size " << length
+                  << "). Returning back or default value \n";
+    }
+
+    [[noreturn]] HLM_COLD inline void throw_out_of_bounds(const size_t& index, const size_t& length)
+    {
+        throw std::out_of_range("Index " + std::to_string(index) + " out of bound (size " + std::to_string(length) + ")");
+    }
+
+    [[noreturn]] HLM_COLD inline void trap_out_of_bounds()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_trap();
+#else
+        std::abort();
+#endif
+    }
+
+    [[noreturn]] HLM_COLD inline void throw_invalid_handle()
+    {
+        throw std::runtime_error("Accessing null or released vector");
+    }
+
+} // namespace detail
+
+/// @brief Bounds-checking policies for operator[]
+/// A policy provides at(elements, length, index, fallback) returning the element to access,
+/// and validates_handle : whether operator[] first runs is_valid() on the handle
+/// Negative int indices have already been wrapped (index + length) by the container,
+/// so a single unsigned compare covers both ends
+/// fallback is DefaultValue(), returned when there is no element to fall back to
+
+/// @brief struct BoundsUnchecked
+// No check at all (not even the handle), same code as indexing a raw std::vector
+struct BoundsUnchecked {
+    static const bool validates_handle = false;
+
+    template <typename T, typename Fallback>
+    static T& at(T* elements, const size_t&, const size_t& index, Fallback&) { return elements[index]; }
+};
+
+/// @brief struct BoundsAssert
+// assert() in debug builds, unchecked once NDEBUG is defined
+struct BoundsAssert {
+#ifdef NDEBUG
+    static const bool validates_handle = false;
+#else
+    static const bool validates_handle = true;
+#endif
+
+    template <typename T, typename Fallback>
+    static T& at(T* elements, const size_t& length, const size_t& index, Fallback&)
+    {
+        assert(index < length && "HLM : index out of bound");
+        (void)length;
+        return elements[index];
+    }
+};
+
+/// @brief struct BoundsClamp
+// Out-of-range indices silently read the nearest end (the last element), or the fallback when empty
+struct BoundsClamp {
+    static const bool validates_handle = true;
+
+    template <typename T, typename Fallback>
+    static T& at(T* elements, const size_t& length, const size_t& index, Fallback& fallback)
+    {
+        if (HLM_UNLIKELY(index >= length)) {
+            return (length != 0) ? elements[length - 1] : fallback;
+        }
+        return elements[index];
+    }
+};
+
+/// @brief struct BoundsThrow
+// std::out_of_range
+struct BoundsThrow {
+    static const bool validates_handle = true;
+
+    template <typename T, typename Fallback>
+    static T& at(T* elements, const size_t& length, const size_t& index, Fallback&)
+    {
+        if (HLM_UNLIKELY(index >= length)) {
+            detail::throw_out_of_bounds(index, length);
+        }
+        return elements[index];
+    }
+};
+
+/// @brief struct BoundsTrap
+// Abort on the spot (__builtin_trap), no unwinding code in the caller
+struct BoundsTrap {
+    static const bool validates_handle = true;
+
+    template <typename T, typename Fallback>
+    static T& at(T* elements, const size_t& length, const size_t& index, Fallback&)
+    {
+        if (HLM_UNLIKELY(index >= length)) {
+            detail::trap_out_of_bounds();
+        }
+        return elements[index];
+    }
+};
+
+/// @brief struct BoundsWarn
+// The historical behaviour and the default : print a warning to std::cerr and return back()
+// (or the fallback when empty)
+struct BoundsWarn {
+    static const bool validates_handle = true;
+
+    template <typename T, typename Fallback>
+    static T& at(T* elements, const size_t& length, const size_t& index, Fallback& fallback)
+    {
+        if (HLM_UNLIKELY(index >= length)) {
+            detail::warn_out_of_bounds(index, length);
+            return (length != 0) ? elements[length - 1] : fallback;
+        }
+        return elements[index];
+    }
+};
+
+// Python-style negative index : -1 is the last element
+// Anything below -length wraps to a huge value and fails the bounds check
+inline size_t wrap_index(const int& index, const size_t& length)
+{
+    return (index >= 0) ? static_cast<size_t>(index) : length - static_cast<size_t>(-static_cast<long long>(index));
+}
+
+} // namespace HLM
+#endif
@@ -0,0 +1,44 @@
+#ifndef _HLM_CONFIG_HPP_
+#define _HLM_CONFIG_HPP_
+
+// Compiler hints shared by the HLM containers
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HLM_NOINLINE    __attribute__((noinline))
+#define HLM_COLD        __attribute__((noinline, cold))
+#define HLM_LIKELY(x)   __builtin_expect(!!(x), 1)
+#define HLM_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define HLM_RESTRICT    __restrict__
+#elif defined(_MSC_VER)
+#define HLM_NOINLINE    __declspec(noinline)
+#define HLM_COLD        __declspec(noinline)
+#define HLM_LIKELY(x)   (x)
+#define HLM_UNLIKELY(x) (x)
+#define HLM_RESTRICT    __restrict
+#else
+#define HLM_NOINLINE
+#define HLM_COLD
+#define HLM_LIKELY(x)   (x)
+#define HLM_UNLIKELY(x) (x)
+#define HLM_RESTRICT
+#endif
+
+// Last-reference decrements : a release decrement, then an acquire fence for the owner that
+// destroys. ThreadSanitizer does not model fences, under TSan the decrement itself is acq_rel
+#if defined(__SANITIZE_THREAD__)
+#define HLM_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define HLM_TSAN 1
+#endif
+#endif
+
+#ifdef HLM_TSAN
+#define HLM_DECREMENT_ORDER std::memory_order_acq_rel
+#define HLM_ACQUIRE_FENCE() ((void)0)
+#else
+#define HLM_DECREMENT_ORDER std::memory_order_release
+#define HLM_ACQUIRE_FENCE() std::atomic_thread_fence(std::memory_order_acquire)
+#endif
+
+#endif
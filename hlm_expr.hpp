@@ -0,0 +1,213 @@
+#ifndef _HLM_EXPR_HPP_
+#define _HLM_EXPR_HPP_
+#include <stdexcept>
+#include <type_traits>
+#include <cstddef>
+#include "hlm_parallel.hpp"
+
+// Lazy element-wise arithmetic over HLM::Vector and HELIUM_API::SharedVector :
+//
+//     SharedVector<float> c = HLM::ew(a) * 2.0f + HLM::ew(b);   // one fused loop, no temporaries
+//     c = HLM::ew(c) - HLM::ew(a) / HLM::ew(b);                 // in place is fine, element i only reads index i
+//
+// ew() keeps a refcounted handle to its vector (never a reference), so an expression can be stored
+// and evaluated later without dangling, even when the original handle is gone
+// Operands are read through the handles when the expression is assigned, all vectors of one
+// expression must then have the same size (std::runtime_error otherwise)
+
+namespace HLM {
+
+/// @brief Expression
+// CRTP base of every expression node, E provides :
+//   value_type, is_scalar, size() and bind() returning a Kernel with operator[](i)
+template <typename E>
+struct Expression {
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+namespace expr {
+
+    struct Add { template <typename T> static T apply(const T& a, const T& b) { return a + b; } };
+    struct Sub { template <typename T> static T apply(const T& a, const T& b) { return a - b; } };
+    struct Mul { template <typename T> static T apply(const T& a, const T& b) { return a * b; } };
+    struct Div { template <typename T> static T apply(const T& a, const T& b) { return a / b; } };
+    struct Neg { template <typename T> static T apply(const T& a) { return -a; } };
+
+    /// @brief Terminal
+    // Leaf holding a shared handle to a vector, the copy only bumps the refcount
+    template <typename Container>
+    class Terminal : public Expression<Terminal<Container>> {
+    public:
+        typedef typename Container::value_type value_type;
+        static const bool is_scalar = false;
+
+        struct Kernel {
+            const value_type* elements;
+            value_type operator[](const size_t& i) const { return elements[i]; }
+        };
+
+        explicit Terminal(const Container& vector) : handle_(vector) {}
+
+        size_t size() const { return handle_.size(); }
+        Kernel bind() const { return Kernel{ handle_.data() }; }
+
+    private:
+        Container handle_;
+    };
+
+    /// @brief Scalar
+    // Constant broadcast to every element
+    template <typename T>
+    class Scalar : public Expression<Scalar<T>> {
+    public:
+        typedef T value_type;
+        static const bool is_scalar = true;
+
+        struct Kernel {
+            T value;
+            T operator[](const size_t&) const { return value; }
+        };
+
+        explicit Scalar(const T& value) : value_(value) {}
+
+        size_t size() const { return 0; }
+        Kernel bind() const { return Kernel{ value_ }; }
+
+    private:
+        T value_;
+    };
+
+    /// @brief Binary
+    // Operands are stored by value, the nodes are small and the leaves only hold handles
+    template <typename Op, typename L, typename R>
+    class Binary : public Expression<Binary<Op, L, R>> {
+    public:
+        static_assert(std::is_same<typename L::value_type, typename R::value_type>::value,
+                      "HLM::ew : operands must have the same element type");
+        typedef typename L::value_type value_type;
+        static const bool is_scalar = L::is_scalar && R::is_scalar;
+
+        struct Kernel {
+            typename L::Kernel left;
+            typename R::Kernel right;
+            value_type operator[](const size_t& i) const { return Op::apply(left[i], right[i]); }
+        };
+
+        Binary(const L& left, const R& right) : left_(left), right_(right) {}
+
+        size_t size() const
+        {
+            if (L::is_scalar) {
+                return right_.size();
+            }
+            if (R::is_scalar) {
+                return left_.size();
+            }
+            const size_t n = left_.size();
+            if (n != right_.size()) {
+                throw std::runtime_error("HLM::ew : operands of different sizes");
+            }
+            return n;
+        }
+
+        Kernel bind() const { return Kernel{ left_.bind(), right_.bind() }; }
+
+    private:
+        L left_;
+        R right_;
+    };
+
+    /// @brief Unary
+    template <typename Op, typename E>
+    class Unary : public Expression<Unary<Op, E>> {
+    public:
+        typedef typename E::value_type value_type;
+        static const bool is_scalar = E::is_scalar;
+
+        struct Kernel {
+            typename E::Kernel operand;
+            value_type operator[](const size_t& i) const { return Op::apply(operand[i]); }
+        };
+
+        explicit Unary(const E& operand) : operand_(operand) {}
+
+        size_t size() const { return operand_.size(); }
+        Kernel bind() const { return Kernel{ operand_.bind() }; }
+
+    private:
+        E operand_;
+    };
+
+} // namespace expr
+
+/// @brief ew
+// Wrap a vector for element-wise arithmetic
+template <typename Container>
+expr::Terminal<Container> ew(const Container& vector)
+{
+    return expr::Terminal<Container>(vector);
+}
+
+/// @brief assign
+// Evaluate expr into dst in a single loop, dst is resized to the expression size
+// The operands are bound before dst is written, so a copy-on-write dst that is also an operand
+// forks first and the expression keeps reading the original block
+template <typename Container, typename E>
+void assign(Container& dst, const Expression<E>& expression)
+{
+    static_assert(!E::is_scalar, "HLM::assign : expression has no vector operand");
+    const E& e = expression.self();
+    const size_t n = e.size();
+    const typename E::Kernel kernel = e.bind();
+    if (dst.size() != n) {
+        dst.resize(n);
+    }
+    typename Container::value_type* out = dst.data();
+#ifdef HLM_OMP_PARALLEL
+    #pragma omp parallel for schedule(static) if (n >= HLM_PARALLEL_THRESHOLD)
+    for (long i = 0; i < static_cast<long>(n); ++i) {
+        out[i] = kernel[static_cast<size_t>(i)];
+    }
+#else
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = kernel[i];
+    }
+#endif
+}
+
+#define HLM_EXPR_BINARY_OPERATOR(OP, NAME)                                                                       \
+    template <typename L, typename R>                                                                            \
+    expr::Binary<expr::NAME, L, R> operator OP(const Expression<L>& left, const Expression<R>& right)            \
+    {                                                                                                            \
+        return expr::Binary<expr::NAME, L, R>(left.self(), right.self());                                        \
+    }                                                                                                            \
+    template <typename L>                                                                                        \
+    expr::Binary<expr::NAME, L, expr::Scalar<typename L::value_type>>                                            \
+    operator OP(const Expression<L>& left, const typename L::value_type& right)                                  \
+    {                                                                                                            \
+        return expr::Binary<expr::NAME, L, expr::Scalar<typename L::value_type>>(                                \
+            left.self(), expr::Scalar<typename L::value_type>(right));                                           \
+    }                                                                                                            \
+    template <typename R>                                                                                        \
+    expr::Binary<expr::NAME, expr::Scalar<typename R::value_type>, R>                                            \
+    operator OP(const typename R::value_type& left, const Expression<R>& right)                                  \
+    {                                                                                                            \
+        return expr::Binary<expr::NAME, expr::Scalar<typename R::value_type>, R>(                                \
+            expr::Scalar<typename R::value_type>(left), right.self());                                           \
+    }
+
+HLM_EXPR_BINARY_OPERATOR(+, Add)
+HLM_EXPR_BINARY_OPERATOR(-, Sub)
+HLM_EXPR_BINARY_OPERATOR(*, Mul)
+HLM_EXPR_BINARY_OPERATOR(/, Div)
+
+#undef HLM_EXPR_BINARY_OPERATOR
+
+template <typename E>
+expr::Unary<expr::Neg, E> operator-(const Expression<E>& operand)
+{
+    return expr::Unary<expr::Neg, E>(operand.self());
+}
+
+} // namespace HLM
+#endif
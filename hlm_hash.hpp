@@ -0,0 +1,215 @@
+#ifndef _HLM_HASH_HPP_
+#define _HLM_HASH_HPP_
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+// Hash tables behind filter_stable() and the lookup index of SharedVector
+// The tables never store elements, only positions into the caller's array : nothing is copied,
+// the caller keeps the elements at those positions unchanged (or tells the table)
+// Open addressing with linear probing, power of two capacity, at most 3/4 full
+// std::hash is remixed first : the standard integer hashes are the identity, which would
+// cluster every run of consecutive keys under linear probing
+
+namespace HLM {
+namespace hashing {
+
+    /// @brief is_hashable
+    // std::hash<T> is enabled (disabled specialisations are not default constructible)
+    template <typename T>
+    struct is_hashable : std::integral_constant<bool,
+        std::is_default_constructible<std::hash<T>>::value> {};
+
+    // 64-bit finaliser of MurmurHash3
+    inline std::uint64_t mix(std::uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    template <typename T>
+    struct Hasher {
+        size_t operator()(const T& value) const
+        {
+            return static_cast<size_t>(mix(static_cast<std::uint64_t>(std::hash<T>()(value))));
+        }
+    };
+
+    /// @brief class IndexTable
+    // Maps values to positions in an external array of T, one position per distinct value
+    // Slots hold position + 1, 0 marks an empty slot
+    // Position is the stored integer type : uint32_t halves the table for arrays below 4G elements
+    template <typename T, typename Position = size_t, typename Hash = Hasher<T>, typename Equal = std::equal_to<T>>
+    class IndexTable {
+    public:
+        static const size_t npos = static_cast<size_t>(-1);
+
+        explicit IndexTable(const size_t& expected = 0) : size_(0)
+        {
+            slots_.assign(capacity_for(expected), Position(0));
+        }
+
+        size_t size() const { return size_; }
+
+        void clear()
+        {
+            std::fill(slots_.begin(), slots_.end(), Position(0));
+            size_ = 0;
+        }
+
+        // Position of the element equal to value, npos when absent
+        size_t find(const T* elements, const T& value) const
+        {
+            const size_t mask = slots_.size() - 1;
+            for (size_t slot = Hash()(value) & mask; ; slot = (slot + 1) & mask) {
+                const size_t stored = static_cast<size_t>(slots_[slot]);
+                if (stored == 0) {
+                    return npos;
+                }
+                if (Equal()(elements[stored - 1], value)) {
+                    return stored - 1;
+                }
+            }
+        }
+
+        // Record position for elements[position] unless an equal element is already recorded
+        // Returns the recorded position of that value (position itself when it was inserted)
+        size_t insert(const T* elements, const size_t& position)
+        {
+            reserve_one(elements);
+            const size_t mask = slots_.size() - 1;
+            for (size_t slot = Hash()(elements[position]) & mask; ; slot = (slot + 1) & mask) {
+                const size_t stored = static_cast<size_t>(slots_[slot]);
+                if (stored == 0) {
+                    slots_[slot] = static_cast<Position>(position + 1);
+                    ++size_;
+                    return position;
+                }
+                if (Equal()(elements[stored - 1], elements[position])) {
+                    return stored - 1;
+                }
+            }
+        }
+
+        // Record position for elements[position], the caller knows no equal element is recorded
+        void insert_new(const T* elements, const size_t& position)
+        {
+            reserve_one(elements);
+            place(elements, position);
+            ++size_;
+        }
+
+        // Forget position (recorded for elements[position]), backward-shift deletion keeps
+        // every other probe chain unbroken without tombstones
+        void erase(const T* elements, const size_t& position)
+        {
+            const size_t mask = slots_.size() - 1;
+            size_t hole = Hash()(elements[position]) & mask;
+            while (static_cast<size_t>(slots_[hole]) != position + 1) {
+                if (slots_[hole] == Position(0)) {
+                    return;
+                }
+                hole = (hole + 1) & mask;
+            }
+            for (size_t slot = (hole + 1) & mask; slots_[slot] != Position(0); slot = (slot + 1) & mask) {
+                const size_t home = Hash()(elements[static_cast<size_t>(slots_[slot]) - 1]) & mask;
+                // the entry may fill the hole if its home is not in (hole, slot]
+                if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+                    slots_[hole] = slots_[slot];
+                    hole = slot;
+                }
+            }
+            slots_[hole] = Position(0);
+            --size_;
+        }
+
+        // Index the first occurrence of every value of [elements, elements + n)
+        void rebuild(const T* elements, const size_t& n)
+        {
+            slots_.assign(capacity_for(n), Position(0));
+            size_ = 0;
+            for (size_t i = 0; i < n; ++i) {
+                insert(elements, i);
+            }
+        }
+
+    private:
+        static size_t capacity_for(const size_t& expected)
+        {
+            size_t capacity = 16;
+            while (capacity / 4 * 3 < expected) {
+                capacity *= 2;
+            }
+            return capacity;
+        }
+
+        void place(const T* elements, const size_t& position)
+        {
+            const size_t mask = slots_.size() - 1;
+            size_t slot = Hash()(elements[position]) & mask;
+            while (slots_[slot] != Position(0)) {
+                slot = (slot + 1) & mask;
+            }
+            slots_[slot] = static_cast<Position>(position + 1);
+        }
+
+        void reserve_one(const T* elements)
+        {
+            if (size_ + 1 <= slots_.size() / 4 * 3) {
+                return;
+            }
+            std::vector<Position> old(slots_.size() * 2, Position(0));
+            old.swap(slots_);
+            for (size_t i = 0; i < old.size(); ++i) {
+                if (old[i] != Position(0)) {
+                    place(elements, static_cast<size_t>(old[i]) - 1);
+                }
+            }
+        }
+
+        std::vector<Position> slots_;
+        size_t size_;
+    };
+
+    template <typename T, typename Position>
+    size_t unique_stable_with(T* first, const size_t& n)
+    {
+        IndexTable<T, Position> seen;
+        size_t kept = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (seen.find(first, first[i]) == IndexTable<T, Position>::npos) {
+                // [kept, i) only holds dropped duplicates, first[kept] may be overwritten
+                if (kept != i) {
+                    first[kept] = std::move(first[i]);
+                }
+                seen.insert_new(first, kept);
+                ++kept;
+            }
+        }
+        return kept;
+    }
+
+    /// @brief unique_stable
+    // Keep the first occurrence of every value of [first, first + n) in their original order,
+    // returns the new length (elements past it are moved-from). O(n) expected, T must be hashable
+    // The table only grows with the distinct values and records the compacted positions
+    template <typename T>
+    size_t unique_stable(T* first, const size_t& n)
+    {
+        if (n < static_cast<size_t>(UINT32_MAX)) {
+            return unique_stable_with<T, std::uint32_t>(first, n);
+        }
+        return unique_stable_with<T, size_t>(first, n);
+    }
+
+} // namespace hashing
+} // namespace HLM
+#endif
@@ -0,0 +1,264 @@
+#ifndef _HLM_INSTRUMENT_HPP_
+#define _HLM_INSTRUMENT_HPP_
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "hlm_config.hpp"
+
+// Hot-path counters of the HLM containers, compiled in only when HLM_INSTRUMENT is defined
+// Without it every hook below expands to nothing and Data blocks carry no counters
+// (HELIUM_API_DEBUG_PROFILE_ENABLE, which printed every create / delete, now turns the counters on)
+//
+// Counted per Data block and globally :
+//   allocations          blocks and element buffers obtained from the allocator
+//   reallocations        element buffers replaced to grow or shrink (their elements moved)
+//   deep_copies          element-wise copies out of a block : HLM_COPY, COW forks, copies into
+//                        another resource, operator std::vector<T>(), operator+ (both operands)
+//   refcount_increments  handles added to a block
+//   refcount_decrements  handles released
+//   bounds_fallbacks     operator[] indices out of range (whatever the BoundsPolicy does then)
+// and globally only, the live totals :
+//   bytes_reserved       element capacity of every live block, inline tails and mappings included
+//   bytes_used           bytes of the live elements
+//
+// Global counters are per thread, the owner thread updates its shard without any read-modify-write,
+// snapshot() adds the shards up. Block counters are relaxed atomics, blocks are shared across threads
+
+#if defined(HELIUM_API_DEBUG_PROFILE_ENABLE) && !defined(HLM_INSTRUMENT)
+#define HLM_INSTRUMENT
+#endif
+
+#define HLM_DUMP_TEXT 0
+#define HLM_DUMP_JSON 1
+
+namespace HLM {
+namespace instrument {
+
+    enum Counter {
+        allocations,
+        reallocations,
+        deep_copies,
+        refcount_increments,
+        refcount_decrements,
+        bounds_fallbacks,
+        block_counter_count,   // counters above are also kept per block
+        bytes_reserved = block_counter_count,
+        bytes_used,
+        counter_count
+    };
+
+    inline const char* counter_name(const size_t& counter)
+    {
+        static const char* const names[counter_count] = {
+            "allocations", "reallocations", "deep_copies", "refcount_increments",
+            "refcount_decrements", "bounds_fallbacks", "bytes_reserved", "bytes_used"
+        };
+        return names[counter];
+    }
+
+    /// @brief struct Counters
+    // Plain values, a snapshot of the global counters or of one block (see SharedVector::counters())
+    struct Counters {
+        std::int64_t values[counter_count];
+
+        Counters()
+        {
+            for (size_t i = 0; i < counter_count; ++i) {
+                values[i] = 0;
+            }
+        }
+
+        std::int64_t operator[](const size_t& counter) const { return values[counter]; }
+        std::int64_t& operator[](const size_t& counter) { return values[counter]; }
+    };
+
+    /// @brief struct BlockCounters
+    // Member of every Data block when HLM_INSTRUMENT is defined
+    struct BlockCounters {
+        std::atomic<std::int64_t> values[block_counter_count];
+
+        BlockCounters()
+        {
+            for (size_t i = 0; i < block_counter_count; ++i) {
+                values[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        // element_size * reserved and element_size * length fill in the byte counters
+        Counters snapshot(const size_t& reserved_bytes, const size_t& used_bytes) const
+        {
+            Counters counters;
+            for (size_t i = 0; i < block_counter_count; ++i) {
+                counters[i] = values[i].load(std::memory_order_relaxed);
+            }
+            counters[bytes_reserved] = static_cast<std::int64_t>(reserved_bytes);
+            counters[bytes_used]     = static_cast<std::int64_t>(used_bytes);
+            return counters;
+        }
+    };
+
+namespace detail {
+
+    struct Shard {
+        std::atomic<std::int64_t> values[counter_count];
+
+        Shard()
+        {
+            for (size_t i = 0; i < counter_count; ++i) {
+                values[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Shards outlive their threads (the counts stay in the totals) and are reused by new threads
+    struct Registry {
+        std::mutex          mutex;
+        std::vector<Shard*> shards;
+        std::vector<Shard*> free_shards;
+    };
+
+    // Intentionally immortal, blocks may be released by static destructors
+    inline Registry& registry()
+    {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    struct LocalShard {
+        Shard* shard;
+
+        LocalShard() : shard(nullptr)
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.free_shards.empty()) {
+                shard = reg.free_shards.back();
+                reg.free_shards.pop_back();
+            }
+            else {
+                shard = new Shard();
+                reg.shards.push_back(shard);
+            }
+        }
+
+        ~LocalShard()
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.free_shards.push_back(shard);
+        }
+    };
+
+    inline Shard& local_shard()
+    {
+        static thread_local LocalShard local;
+        return *local.shard;
+    }
+
+    // Only the owner thread writes its shard : load + store, no locked instruction
+    inline void add(const size_t& counter, const std::int64_t& delta)
+    {
+        std::atomic<std::int64_t>& value = local_shard().values[counter];
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    inline void count(BlockCounters& block, const size_t& counter)
+    {
+        block.values[counter].fetch_add(1, std::memory_order_relaxed);
+        add(counter, 1);
+    }
+
+} // namespace detail
+
+    /// @brief snapshot
+    // Sum of every thread's counters, the counts of exited threads included
+    // Taken while other threads run, each counter is exact but they are not one atomic cut
+    inline Counters snapshot()
+    {
+        detail::Registry& reg = detail::registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        Counters total;
+        for (size_t s = 0; s < reg.shards.size(); ++s) {
+            for (size_t i = 0; i < counter_count; ++i) {
+                total[i] += reg.shards[s]->values[i].load(std::memory_order_relaxed);
+            }
+        }
+        return total;
+    }
+
+    // Zero the event counters, the live byte totals are kept (they are balanced by later releases)
+    // Only meaningful while no other thread updates counters
+    inline void reset()
+    {
+        detail::Registry& reg = detail::registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (size_t s = 0; s < reg.shards.size(); ++s) {
+            for (size_t i = 0; i < block_counter_count; ++i) {
+                reg.shards[s]->values[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief dump
+    // HLM_DUMP_TEXT : one "name value" line per counter, HLM_DUMP_JSON : one flat object
+    inline void dump(std::ostream& out, const Counters& counters, const int& format = HLM_DUMP_TEXT)
+    {
+        if (format == HLM_DUMP_JSON) {
+            out << "{";
+            for (size_t i = 0; i < counter_count; ++i) {
+                out << ((i != 0) ? ", " : "") << "\"" << counter_name(i) << "\": " << counters[i];
+            }
+            out << "}\n";
+            return;
+        }
+        for (size_t i = 0; i < counter_count; ++i) {
+            out << counter_name(i) << " " << counters[i] << "\n";
+        }
+    }
+
+    // Global counters
+    inline void dump(std::ostream& out, const int& format = HLM_DUMP_TEXT)
+    {
+        dump(out, snapshot(), format);
+    }
+
+    // Compiled-in state, for tools that read the dump
+    inline bool enabled()
+    {
+#ifdef HLM_INSTRUMENT
+        return true;
+#else
+        return false;
+#endif
+    }
+
+} // namespace instrument
+} // namespace HLM
+
+// Hooks used by the containers
+// HLM_INSTRUMENT_COUNT(block, counter)  one event on a Data block (and globally)
+// HLM_INSTRUMENT_BOUNDS(block, index)   bounds_fallbacks when index is past the block's length
+// HLM_INSTRUMENT_EVENT(counter)         one event with no block at hand, global only
+// HLM_INSTRUMENT_RESIZE(counter, from, to)  a byte total going from `from` to `to` elements
+//                                           of the enclosing T, global only
+#ifdef HLM_INSTRUMENT
+#define HLM_INSTRUMENT_COUNT(block, counter) \
+    HLM::instrument::detail::count((block)->counters, HLM::instrument::counter)
+#define HLM_INSTRUMENT_BOUNDS(block, index) \
+    do { if (HLM_UNLIKELY((index) >= (block)->length)) { HLM_INSTRUMENT_COUNT(block, bounds_fallbacks); } } while (0)
+#define HLM_INSTRUMENT_EVENT(counter) \
+    HLM::instrument::detail::add(HLM::instrument::counter, 1)
+#define HLM_INSTRUMENT_RESIZE(counter, from, to) \
+    HLM::instrument::detail::add(HLM::instrument::counter, \
+        (static_cast<std::int64_t>(to) - static_cast<std::int64_t>(from)) * static_cast<std::int64_t>(sizeof(T)))
+#else
+#define HLM_INSTRUMENT_COUNT(block, counter)     ((void)0)
+#define HLM_INSTRUMENT_BOUNDS(block, index)      ((void)0)
+#define HLM_INSTRUMENT_EVENT(counter)            ((void)0)
+#define HLM_INSTRUMENT_RESIZE(counter, from, to) ((void)0)
+#endif
+
+#endif
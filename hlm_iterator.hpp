@@ -0,0 +1,177 @@
+#ifndef _HLM_ITERATOR_HPP_
+#define _HLM_ITERATOR_HPP_
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+#include "hlm_config.hpp"
+
+// Container iterators :
+//   release builds (NDEBUG)       raw element pointers, nothing to pay
+//   debug builds, or any build defining HLM_CHECKED_ITERATORS
+//                                 CheckedIterator : holds a reference on the block, an index and the
+//                                 block generation seen at creation. Every reallocation (growth,
+//                                 shrink_to_fit, assign) bumps the generation, so an iterator used
+//                                 after one throws std::logic_error instead of reading freed memory
+// Define HLM_UNCHECKED_ITERATORS to keep raw pointers in a debug build
+// All translation units of a program must agree on the mode, the iterator types differ
+// A checked iterator keeps its block alive but is not a sharer for copy-on-write : writing through
+// the handle it came from does not fork. A write through another handle of a shared copy-on-write
+// block forks that handle as usual, and the iterator keeps reading the block it was created on
+
+#if !defined(HLM_CHECKED_ITERATORS) && !defined(HLM_UNCHECKED_ITERATORS) && !defined(NDEBUG)
+#define HLM_CHECKED_ITERATORS
+#endif
+
+namespace HLM {
+
+namespace detail {
+
+    [[noreturn]] HLM_COLD inline void throw_invalid_iterator()
+    {
+        throw std::logic_error("HLM : iterator used after its vector was reallocated, or out of range");
+    }
+
+    [[noreturn]] HLM_COLD inline void throw_mismatched_iterators()
+    {
+        throw std::logic_error("HLM : comparing iterators of different vectors");
+    }
+
+} // namespace detail
+
+/// @brief class CheckedIterator
+// Random access iterator over the elements of a Data block
+// Data provides elements, length, generation, pin() taking a reference for the iterator and
+// unpin() dropping it (true when it was the last reference of the block)
+// Value is T or const T
+template <typename Data, typename Value>
+class CheckedIterator {
+public:
+    typedef std::random_access_iterator_tag      iterator_category;
+    typedef typename std::remove_const<Value>::type value_type;
+    typedef std::ptrdiff_t                       difference_type;
+    typedef Value*                               pointer;
+    typedef Value&                               reference;
+
+    CheckedIterator() : data_(nullptr), index_(0), generation_(0) {}
+
+    CheckedIterator(Data* data, const size_t& index)
+    : data_(data), index_(index), generation_(data->generation)
+    {
+        data_->pin();
+    }
+
+    CheckedIterator(const CheckedIterator& other)
+    : data_(other.data_), index_(other.index_), generation_(other.generation_)
+    {
+        if (data_ != nullptr) {
+            data_->pin();
+        }
+    }
+
+    // iterator -> const_iterator
+    template <typename Other, typename = typename std::enable_if<
+        std::is_const<Value>::value && std::is_same<Other, value_type>::value>::type>
+    CheckedIterator(const CheckedIterator<Data, Other>& other)
+    : CheckedIterator(other.data_, other.index_, other.generation_) {}
+
+    CheckedIterator& operator=(const CheckedIterator& other)
+    {
+        if (this != &other) {
+            CheckedIterator copy(other);
+            std::swap(data_, copy.data_);
+            index_      = copy.index_;
+            generation_ = copy.generation_;
+        }
+        return *this;
+    }
+
+    ~CheckedIterator() { release(); }
+
+    reference operator*() const { check(index_); return data_->elements[index_]; }
+    pointer operator->() const { check(index_); return data_->elements + index_; }
+    reference operator[](const difference_type& n) const
+    {
+        const size_t index = index_ + static_cast<size_t>(n);
+        check(index);
+        return data_->elements[index];
+    }
+
+    CheckedIterator& operator++() { ++index_; return *this; }
+    CheckedIterator& operator--() { --index_; return *this; }
+    CheckedIterator operator++(int) { CheckedIterator old(*this); ++index_; return old; }
+    CheckedIterator operator--(int) { CheckedIterator old(*this); --index_; return old; }
+    CheckedIterator& operator+=(const difference_type& n) { index_ += static_cast<size_t>(n); return *this; }
+    CheckedIterator& operator-=(const difference_type& n) { index_ -= static_cast<size_t>(n); return *this; }
+
+    friend CheckedIterator operator+(CheckedIterator it, const difference_type& n) { it += n; return it; }
+    friend CheckedIterator operator+(const difference_type& n, CheckedIterator it) { it += n; return it; }
+    friend CheckedIterator operator-(CheckedIterator it, const difference_type& n) { it -= n; return it; }
+
+    friend difference_type operator-(const CheckedIterator& a, const CheckedIterator& b)
+    {
+        a.same_block(b);
+        return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+    }
+
+    friend bool operator==(const CheckedIterator& a, const CheckedIterator& b) { a.same_block(b); return a.index_ == b.index_; }
+    friend bool operator!=(const CheckedIterator& a, const CheckedIterator& b) { a.same_block(b); return a.index_ != b.index_; }
+    friend bool operator<(const CheckedIterator& a, const CheckedIterator& b)  { a.same_block(b); return a.index_ < b.index_; }
+    friend bool operator>(const CheckedIterator& a, const CheckedIterator& b)  { a.same_block(b); return a.index_ > b.index_; }
+    friend bool operator<=(const CheckedIterator& a, const CheckedIterator& b) { a.same_block(b); return a.index_ <= b.index_; }
+    friend bool operator>=(const CheckedIterator& a, const CheckedIterator& b) { a.same_block(b); return a.index_ >= b.index_; }
+
+private:
+    template <typename, typename> friend class CheckedIterator;
+
+    CheckedIterator(Data* data, const size_t& index, const size_t& generation)
+    : data_(data), index_(index), generation_(generation)
+    {
+        if (data_ != nullptr) {
+            data_->pin();
+        }
+    }
+
+    void check(const size_t& index) const
+    {
+        if (HLM_UNLIKELY(data_ == nullptr || generation_ != data_->generation || index >= data_->length)) {
+            detail::throw_invalid_iterator();
+        }
+    }
+
+    void same_block(const CheckedIterator& other) const
+    {
+        if (HLM_UNLIKELY(data_ != other.data_)) {
+            detail::throw_mismatched_iterators();
+        }
+    }
+
+    void release()
+    {
+        if (data_ != nullptr && data_->unpin()) {
+            Data::destroy(data_);
+        }
+        data_ = nullptr;
+    }
+
+    Data*  data_;
+    size_t index_;
+    size_t generation_;
+};
+
+/// @brief IteratorSelect
+// iterator / const_iterator type of a container and how to build one at an index
+template <typename Data, typename Value>
+struct IteratorSelect {
+#ifdef HLM_CHECKED_ITERATORS
+    typedef CheckedIterator<Data, Value> type;
+    static type make(Data* data, const size_t& index) { return type(data, index); }
+#else
+    typedef Value* type;
+    static type make(Data* data, const size_t& index) { return data->elements + index; }
+#endif
+};
+
+} // namespace HLM
+#endif
@@ -0,0 +1,211 @@
+#ifndef _HLM_LEAK_TRACKER_HPP_
+#define _HLM_LEAK_TRACKER_HPP_
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <typeinfo>
+#include <cstdlib>
+#include <cstddef>
+
+namespace HLM {
+
+namespace detail {
+
+    // UUIDs are handed out in per-thread blocks so construction never touches a shared counter
+    // except once every 1024 blocks
+    inline size_t next_uuid()
+    {
+        static std::atomic<size_t> global_next(1);
+        static thread_local size_t next = 0;
+        static thread_local size_t last = 0;
+        if (next == last) {
+            next = global_next.fetch_add(1024, std::memory_order_relaxed);
+            last = next + 1024;
+        }
+        return next++;
+    }
+
+} // namespace detail
+
+/// @brief class LeakTracker
+// Tracks the live Data blocks of one container type (Tag) :
+// Every thread owns a shard holding an intrusive list of the blocks it created,
+// so construction only takes that shard's uncontended lock
+// The shards are merged only when queried or by the exit check,
+// which is registered exactly once per Tag with std::atexit
+// Define HLM_DISABLE_LEAK_TRACKER to compile the tracking out (UUIDs are still assigned)
+// Caution : Not meant for external use, Data blocks derive from LeakTracker<Data>::Node
+template <typename Tag>
+class LeakTracker {
+public:
+#ifndef HLM_DISABLE_LEAK_TRACKER
+    struct Shard;
+
+    struct Node {
+        Node*  prev;
+        Node*  next;
+        Shard* shard;
+        size_t UUID;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        Node       head;
+        size_t     live;
+
+        Shard() : live(0) { head.prev = head.next = &head; }
+    };
+
+    static void track(Node& node)
+    {
+        Shard* shard = local_shard();
+        node.UUID  = detail::next_uuid();
+        node.shard = shard;
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        node.prev = &shard->head;
+        node.next = shard->head.next;
+        shard->head.next->prev = &node;
+        shard->head.next = &node;
+        ++shard->live;
+    }
+
+    // May run on another thread than track(), the node remembers its shard
+    static void untrack(Node& node)
+    {
+        Shard* shard = node.shard;
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        node.prev->next = node.next;
+        node.next->prev = node.prev;
+        --shard->live;
+    }
+
+    // Merge the per-thread shards
+    static size_t live_count()
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        size_t total = 0;
+        for (size_t i = 0; i < reg.shards.size(); ++i) {
+            std::lock_guard<std::mutex> shard_lock(reg.shards[i]->mutex);
+            total += reg.shards[i]->live;
+        }
+        return total;
+    }
+
+    static std::vector<size_t> live_uuids()
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        std::vector<size_t> uuids;
+        for (size_t i = 0; i < reg.shards.size(); ++i) {
+            Shard* shard = reg.shards[i];
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            for (Node* node = shard->head.next; node != &shard->head; node = node->next) {
+                uuids.push_back(node->UUID);
+            }
+        }
+        return uuids;
+    }
+
+    // visit(Node&) on every live block, under its shard's lock : visit must not create or
+    // release a block of this type
+    template <typename Visit>
+    static void for_each(Visit&& visit)
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (size_t i = 0; i < reg.shards.size(); ++i) {
+            Shard* shard = reg.shards[i];
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            for (Node* node = shard->head.next; node != &shard->head; node = node->next) {
+                visit(*node);
+            }
+        }
+    }
+
+    static void report(std::ostream& out)
+    {
+        std::vector<size_t> uuids = live_uuids();
+        if (uuids.empty()) {
+            return;
+        }
+        out << "Leak check : " << uuids.size() << " instance(s) of " << typeid(Tag).name()
+            << " have not been deleted, UUIDs =";
+        for (size_t i = 0; i < uuids.size(); ++i) {
+            out << " " << uuids[i];
+        }
+        out << "\n";
+    }
+
+private:
+    struct Registry {
+        std::mutex          mutex;
+        std::vector<Shard*> shards;
+        std::vector<Shard*> free_shards;
+
+        Registry() { std::atexit(&LeakTracker::check_at_exit); }
+    };
+
+    // Returns the shard to the free list when its thread exits
+    // The shard itself is never freed, blocks created by that thread may outlive it
+    struct LocalShard {
+        Shard* shard;
+
+        LocalShard() : shard(nullptr)
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.free_shards.empty()) {
+                shard = reg.free_shards.back();
+                reg.free_shards.pop_back();
+            }
+            else {
+                shard = new Shard();
+                reg.shards.push_back(shard);
+            }
+        }
+
+        ~LocalShard()
+        {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.free_shards.push_back(shard);
+        }
+    };
+
+    // Intentionally immortal so the exit check and late destructors can still use it
+    static Registry& registry()
+    {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    static Shard* local_shard()
+    {
+        static thread_local LocalShard local;
+        return local.shard;
+    }
+
+    static void check_at_exit()
+    {
+        report(std::cerr);
+    }
+
+#else
+    struct Node {
+        size_t UUID;
+    };
+
+    static void track(Node& node) { node.UUID = detail::next_uuid(); }
+    static void untrack(Node&) {}
+    static size_t live_count() { return 0; }
+    static std::vector<size_t> live_uuids() { return std::vector<size_t>(); }
+    template <typename Visit>
+    static void for_each(Visit&&) {}
+    static void report(std::ostream&) {}
+#endif
+};
+
+} // namespace HLM
+#endif
@@ -0,0 +1,321 @@
+#ifndef _HLM_MEMORY_REGISTRY_HPP_
+#define _HLM_MEMORY_REGISTRY_HPP_
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <typeinfo>
+#include <cstdint>
+#include <cstddef>
+#include "hlm_config.hpp"
+#include "hlm_leak_tracker.hpp"
+
+// Memory accounting of the live Data blocks, compiled in only when HLM_MEMORY_REGISTRY is defined
+// (the hooks below expand to nothing otherwise, blocks() and totals() then report nothing)
+//
+// Every container type registers itself with its first block, blocks() lists the live blocks of
+// all of them (UUID, container, element type, size, capacity, bytes) through their LeakTracker
+// shards, totals() adds them up into used and wasted (reserved but unused) bytes
+//
+// Budget : the registry keeps one running total of the reserved element bytes, updated whenever
+// a block's capacity changes (not on every push_back). Once a growth takes it past the budget,
+// the thread that grew calls the pressure callbacks, then the automatic shrink pass if enabled
+// The shrink pass runs shrink_to_fit on the blocks of every registered type, except the block
+// that grew, blocks held by more than one handle, pinned by checked iterators or backed by a file
+// mapping. Shrinking reallocates the elements : with the automatic pass enabled, any growth
+// (push_back, resize, insert, a deep copy ...) that crosses the budget may invalidate raw pointers,
+// T& references and release-build iterators into any other exclusively owned vector, on the same
+// thread too : after w.push_back(x), a pointer taken earlier from v.data() may dangle. Only
+// checked iterators are safe, their pin keeps the block out of the pass
+// It does not synchronise with the threads using those blocks either : enable it only where
+// no other thread mutates or reads an exclusively owned vector at the same time (single-threaded
+// processes, or between phases), and where no code keeps pointers into vectors across a growth,
+// or shrink from a callback that knows its own vectors
+// Reports read sizes of blocks other threads may be growing, they are approximate under load
+//
+// Block sizes count element storage only : the inline tail of a block counts as capacity,
+// the control block itself is not counted
+
+#if defined(HLM_MEMORY_REGISTRY) && defined(HLM_DISABLE_LEAK_TRACKER)
+#error "HLM_MEMORY_REGISTRY walks the LeakTracker shards, it cannot be used with HLM_DISABLE_LEAK_TRACKER"
+#endif
+
+namespace HLM {
+namespace memory {
+
+    /// @brief struct BlockInfo
+    // One live block, as seen by blocks()
+    struct BlockInfo {
+        size_t      uuid;
+        const char* container;       // "Vector", "SharedVector"
+        const char* element_type;    // typeid(T).name()
+        size_t      element_size;
+        size_t      size;            // elements
+        size_t      capacity;        // elements
+        size_t      handles;         // reference count
+        bool        mapped;          // elements live in a file mapping
+
+        size_t bytes_used() const { return size * element_size; }
+        size_t bytes_reserved() const { return capacity * element_size; }
+        size_t bytes_wasted() const { return (capacity - size) * element_size; }
+    };
+
+    struct Totals {
+        size_t blocks;
+        size_t bytes_used;
+        size_t bytes_reserved;
+        size_t bytes_wasted;
+    };
+
+    // Called with the bytes over budget, on the thread whose growth crossed it
+    typedef std::function<void(const size_t& excess)> PressureCallback;
+
+namespace detail {
+
+    // One per container type : lists its blocks, shrinks them (skipping except), returns bytes reclaimed
+    struct Source {
+        void   (*collect)(std::vector<BlockInfo>& out);
+        size_t (*shrink)(const void* except);
+    };
+
+    struct Registry {
+        std::mutex                    mutex;
+        std::vector<Source>           sources;
+        std::vector<PressureCallback> callbacks;
+        std::atomic<std::int64_t>     reserved;
+        std::atomic<size_t>           budget;
+        std::atomic<bool>             auto_shrink;
+
+        Registry() : reserved(0), budget(0), auto_shrink(false) {}
+    };
+
+    // Intentionally immortal, blocks may be released by static destructors
+    inline Registry& registry()
+    {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+
+    inline bool register_source(const Source& source)
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.sources.push_back(source);
+        return true;
+    }
+
+    // Snapshot of the sources, so a pass never holds the registry lock while visiting blocks
+    inline std::vector<Source> sources()
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        return reg.sources;
+    }
+
+    /// @brief Source for a Data type
+    // Data provides describe(BlockInfo&) and size_t try_shrink() (bytes reclaimed, 0 when skipped)
+    template <typename Data>
+    struct SourceOf {
+        static void collect(std::vector<BlockInfo>& out)
+        {
+            LeakTracker<Data>::for_each([&out](typename LeakTracker<Data>::Node& node) {
+                BlockInfo info;
+                info.uuid = node.UUID;
+                static_cast<Data&>(node).describe(info);
+                out.push_back(info);
+            });
+        }
+
+        static size_t shrink(const void* except)
+        {
+            size_t reclaimed = 0;
+            LeakTracker<Data>::for_each([&reclaimed, except](typename LeakTracker<Data>::Node& node) {
+                Data& data = static_cast<Data&>(node);
+                if (&data != except) {
+                    reclaimed += data.try_shrink();
+                }
+            });
+            return reclaimed;
+        }
+
+        // Registers the type once, from its first block
+        static void ensure_registered()
+        {
+            static const bool registered = register_source(Source{&SourceOf::collect, &SourceOf::shrink});
+            (void)registered;
+        }
+    };
+
+    inline void account(const std::int64_t& delta)
+    {
+        registry().reserved.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    // Bytes reclaimed over every registered type, except is the block left alone
+    inline size_t shrink_all(const void* except)
+    {
+        std::vector<Source> list = sources();
+        size_t reclaimed = 0;
+        for (size_t i = 0; i < list.size(); ++i) {
+            reclaimed += list[i].shrink(except);
+        }
+        return reclaimed;
+    }
+
+    HLM_COLD inline void on_pressure(const void* block, const size_t& excess)
+    {
+        // a callback or the shrink pass may grow a vector itself
+        static thread_local bool running = false;
+        if (running) {
+            return;
+        }
+        running = true;
+        try {
+            std::vector<PressureCallback> callbacks;
+            {
+                Registry& reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                callbacks = reg.callbacks;
+            }
+            for (size_t i = 0; i < callbacks.size(); ++i) {
+                callbacks[i](excess);
+            }
+            if (registry().auto_shrink.load(std::memory_order_relaxed)) {
+                shrink_all(block);
+            }
+        }
+        catch (...) {
+            running = false;
+            throw;
+        }
+        running = false;
+    }
+
+    // After a growth of block : cheap compare, the pressure path is out of line
+    inline void check(const void* block)
+    {
+        Registry& reg = registry();
+        const size_t budget = reg.budget.load(std::memory_order_relaxed);
+        if (budget == 0) {
+            return;
+        }
+        const std::int64_t reserved = reg.reserved.load(std::memory_order_relaxed);
+        if (HLM_UNLIKELY(reserved > static_cast<std::int64_t>(budget))) {
+            on_pressure(block, static_cast<size_t>(reserved) - budget);
+        }
+    }
+
+} // namespace detail
+
+    // Live blocks of every registered container type
+    inline std::vector<BlockInfo> blocks()
+    {
+        std::vector<detail::Source> list = detail::sources();
+        std::vector<BlockInfo> out;
+        for (size_t i = 0; i < list.size(); ++i) {
+            list[i].collect(out);
+        }
+        return out;
+    }
+
+    inline Totals totals()
+    {
+        const std::vector<BlockInfo> live = blocks();
+        Totals sum = {live.size(), 0, 0, 0};
+        for (size_t i = 0; i < live.size(); ++i) {
+            sum.bytes_used     += live[i].bytes_used();
+            sum.bytes_reserved += live[i].bytes_reserved();
+            sum.bytes_wasted   += live[i].bytes_wasted();
+        }
+        return sum;
+    }
+
+    // Running total the budget is checked against, without walking the blocks
+    inline size_t reserved_bytes()
+    {
+        const std::int64_t reserved = detail::registry().reserved.load(std::memory_order_relaxed);
+        return (reserved > 0) ? static_cast<size_t>(reserved) : 0;
+    }
+
+    // 0 disables the budget (the default)
+    inline void set_budget(const size_t& bytes)
+    {
+        detail::registry().budget.store(bytes, std::memory_order_relaxed);
+    }
+
+    inline size_t budget()
+    {
+        return detail::registry().budget.load(std::memory_order_relaxed);
+    }
+
+    inline void on_pressure(const PressureCallback& callback)
+    {
+        detail::Registry& reg = detail::registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.callbacks.push_back(callback);
+    }
+
+    inline void clear_callbacks()
+    {
+        detail::Registry& reg = detail::registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.callbacks.clear();
+    }
+
+    // See the header comment before enabling : once enabled, any growth past the budget may
+    // reallocate every other exclusively owned vector, pointers and references into them
+    // (data(), operator[], release iterators) do not survive it, on the calling thread included
+    inline void set_auto_shrink(const bool& enabled)
+    {
+        detail::registry().auto_shrink.store(enabled, std::memory_order_relaxed);
+    }
+
+    // Run the shrink pass now, returns the bytes reclaimed
+    inline size_t shrink_all()
+    {
+        return detail::shrink_all(nullptr);
+    }
+
+    // One line per block then the totals
+    inline void report(std::ostream& out)
+    {
+        const std::vector<BlockInfo> live = blocks();
+        Totals sum = {live.size(), 0, 0, 0};
+        for (size_t i = 0; i < live.size(); ++i) {
+            const BlockInfo& info = live[i];
+            out << "UUID " << info.uuid << " " << info.container << "<" << info.element_type << "> size "
+                << info.size << " capacity " << info.capacity << " used " << info.bytes_used() << " B wasted "
+                << info.bytes_wasted() << " B handles " << info.handles << (info.mapped ? " mapped" : "") << "\n";
+            sum.bytes_used     += info.bytes_used();
+            sum.bytes_reserved += info.bytes_reserved();
+            sum.bytes_wasted   += info.bytes_wasted();
+        }
+        out << sum.blocks << " block(s), " << sum.bytes_used << " B used, " << sum.bytes_reserved
+            << " B reserved, " << sum.bytes_wasted << " B wasted";
+        if (budget() != 0) {
+            out << ", budget " << budget() << " B";
+        }
+        out << "\n";
+    }
+
+} // namespace memory
+} // namespace HLM
+
+// Hooks used by the containers
+// HLM_MEMORY_REGISTER(Data)          from the block constructor, registers the type once
+// HLM_MEMORY_ACCOUNT(from, to)       a block's capacity going from `from` to `to` elements of T
+// HLM_MEMORY_CHECK(block)            after a growth, runs the pressure path when over budget
+#ifdef HLM_MEMORY_REGISTRY
+#define HLM_MEMORY_REGISTER(Data) HLM::memory::detail::SourceOf<Data>::ensure_registered()
+#define HLM_MEMORY_ACCOUNT(from, to) \
+    HLM::memory::detail::account( \
+        (static_cast<std::int64_t>(to) - static_cast<std::int64_t>(from)) * static_cast<std::int64_t>(sizeof(T)))
+#define HLM_MEMORY_CHECK(block) HLM::memory::detail::check(block)
+#else
+#define HLM_MEMORY_REGISTER(Data)    ((void)0)
+#define HLM_MEMORY_ACCOUNT(from, to) ((void)0)
+#define HLM_MEMORY_CHECK(block)      ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,372 @@
+#ifndef _HLM_MEMORY_RESOURCE_HPP_
+#define _HLM_MEMORY_RESOURCE_HPP_
+#include <memory_resource>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include "hlm_mmap.hpp"
+
+// Memory resources for the HLM containers (any std::pmr::memory_resource works as well)
+// A container built with a resource takes its control block and its element buffer from it,
+// copies derived from it (HLM_COPY, operator+, copy-on-write forks) use the same resource
+// The resource must outlive every block allocated from it
+// ArenaResource and PoolResource are not synchronised : with MultiThreaded handles the last release
+// may run on any thread, share such vectors across threads only through a synchronised resource
+// (e.g. std::pmr::synchronized_pool_resource). AlignedResource is safe to share
+
+namespace HLM {
+
+/// @brief class ArenaResource
+// Monotonic bump allocator : deallocation is a no-op and release() frees everything at once,
+// e.g. per-request vectors dropped together at the end of the request
+// Chunks are taken from the upstream resource and grow geometrically
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(const size_t& initial_chunk = 64 * 1024,
+                           std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream), chunks_(nullptr), current_(nullptr), remaining_(0),
+          initial_chunk_(initial_chunk < 256 ? 256 : initial_chunk), next_chunk_(initial_chunk_), allocated_(0) {}
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource() { release(); }
+
+    // Return every chunk upstream and restart from the initial chunk size,
+    // all blocks from this arena become invalid
+    void release()
+    {
+        while (chunks_ != nullptr) {
+            Chunk* next = chunks_->next;
+            upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+            chunks_ = next;
+        }
+        current_    = nullptr;
+        remaining_  = 0;
+        next_chunk_ = initial_chunk_;
+        allocated_  = 0;
+    }
+
+    // Bytes handed out since construction or the last release()
+    size_t bytes_allocated() const { return allocated_; }
+
+    std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+private:
+    struct Chunk {
+        Chunk* next;
+        size_t size;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        size_t padding = (alignment - reinterpret_cast<size_t>(current_) % alignment) % alignment;
+        if (current_ == nullptr || padding + bytes > remaining_) {
+            grow(bytes, alignment);
+            padding = (alignment - reinterpret_cast<size_t>(current_) % alignment) % alignment;
+        }
+        char* result = current_ + padding;
+        current_   += padding + bytes;
+        remaining_ -= padding + bytes;
+        allocated_ += bytes;
+        return result;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void grow(const size_t& bytes, const size_t& alignment)
+    {
+        const size_t header = (sizeof(Chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+        const size_t needed = header + bytes + alignment;
+        size_t size = next_chunk_;
+        while (size < needed) {
+            size *= 2;
+        }
+        Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+        chunk->next = chunks_;
+        chunk->size = size;
+        chunks_     = chunk;
+        current_    = reinterpret_cast<char*>(chunk) + header;
+        remaining_  = size - header;
+        next_chunk_ = size * 2;
+    }
+
+    std::pmr::memory_resource* upstream_;
+    Chunk*                     chunks_;
+    char*                      current_;
+    size_t                     remaining_;
+    size_t                     initial_chunk_;
+    size_t                     next_chunk_;
+    size_t                     allocated_;
+};
+
+/// @brief class PoolResource
+// Size-class pools : requests up to max_pooled bytes are rounded up to a power of two and served
+// from per-class free lists carved out of upstream slabs, so freed blocks are reused without
+// touching the global heap. Larger requests go straight to the upstream resource
+// Slabs are only returned upstream by release() or the destructor
+class PoolResource : public std::pmr::memory_resource {
+public:
+    static const size_t min_class    = 16;
+    static const size_t max_pooled   = 4096;
+    static const size_t slab_bytes   = 64 * 1024;
+
+    explicit PoolResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream)
+    {
+        for (size_t i = 0; i < class_count; ++i) {
+            free_[i] = nullptr;
+        }
+    }
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    ~PoolResource() { release(); }
+
+    // Return every slab upstream, all pooled blocks become invalid
+    void release()
+    {
+        for (size_t i = 0; i < slabs_.size(); ++i) {
+            upstream_->deallocate(slabs_[i].memory, slab_bytes, slabs_[i].alignment);
+        }
+        slabs_.clear();
+        for (size_t i = 0; i < class_count; ++i) {
+            free_[i] = nullptr;
+        }
+    }
+
+    std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+private:
+    static const size_t class_count = 9;   // 16, 32, ... 4096
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Slab {
+        void*  memory;
+        size_t alignment;
+    };
+
+    static size_t size_class(const size_t& bytes, const size_t& alignment)
+    {
+        const size_t wanted = (bytes > alignment) ? bytes : alignment;
+        size_t index = 0;
+        size_t size  = min_class;
+        while (size < wanted) {
+            size *= 2;
+            ++index;
+        }
+        return index;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (bytes > max_pooled || alignment > max_pooled) {
+            return upstream_->allocate(bytes, alignment);
+        }
+        const size_t index = size_class(bytes, alignment);
+        if (free_[index] == nullptr) {
+            refill(index);
+        }
+        FreeBlock* block = free_[index];
+        free_[index] = block->next;
+        return block;
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        if (bytes > max_pooled || alignment > max_pooled) {
+            upstream_->deallocate(memory, bytes, alignment);
+            return;
+        }
+        const size_t index = size_class(bytes, alignment);
+        FreeBlock* block = static_cast<FreeBlock*>(memory);
+        block->next  = free_[index];
+        free_[index] = block;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    // Carve a new slab into blocks of the class size, the slab is aligned to that size
+    void refill(const size_t& index)
+    {
+        const size_t block_size = min_class << index;
+        slabs_.reserve(slabs_.size() + 1);
+        char* slab = static_cast<char*>(upstream_->allocate(slab_bytes, block_size));
+        slabs_.push_back(Slab{ slab, block_size });
+        for (size_t offset = slab_bytes; offset >= block_size; offset -= block_size) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + offset - block_size);
+            block->next  = free_[index];
+            free_[index] = block;
+        }
+    }
+
+    std::pmr::memory_resource* upstream_;
+    FreeBlock*                 free_[class_count];
+    std::vector<Slab>          slabs_;
+};
+
+#define HLM_ALIGN_AVX2       32
+#define HLM_ALIGN_CACHE_LINE 64
+#define HLM_ALIGN_AVX512     64
+
+#define HLM_HUGE_PAGES_NONE        0
+#define HLM_HUGE_PAGES_TRANSPARENT 1
+#define HLM_HUGE_PAGES_EXPLICIT    2
+
+/// @brief class AlignedResource
+// Every allocation aligned to at least alignment (a power of two, e.g. HLM_ALIGN_AVX512)
+// Containers built on it also start their inline tail on that boundary, so data() is aligned
+// whether the elements sit in the control block or in a separate buffer
+// Allocations of huge_threshold bytes or more can be backed by 2 MiB pages, a large vector then
+// needs a few hundred TLB entries instead of a few hundred thousand :
+//   HLM_HUGE_PAGES_NONE         aligned operator new only
+//   HLM_HUGE_PAGES_TRANSPARENT  anonymous mapping on a 2 MiB boundary + madvise(MADV_HUGEPAGE),
+//                               plain pages where transparent huge pages are disabled
+//   HLM_HUGE_PAGES_EXPLICIT     mmap(MAP_HUGETLB) from the reserved pool (vm.nr_hugepages),
+//                               the transparent path when the pool is empty or absent
+// Without mmap (non-POSIX) every allocation goes to the aligned operator new
+// Mapped sizes are rounded up to 2 MiB : keep the threshold at or above it
+// Holds no free lists, only counters : unlike the resources above it is safe to share across threads
+class AlignedResource : public std::pmr::memory_resource {
+public:
+    static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+    explicit AlignedResource(const size_t& alignment = HLM_ALIGN_CACHE_LINE, const int& huge_pages = HLM_HUGE_PAGES_NONE,
+                             const size_t& huge_threshold = huge_page_size)
+        : alignment_(alignment), huge_pages_(huge_pages), huge_threshold_(huge_threshold),
+          hugetlb_(0), transparent_(0), fallbacks_(0)
+    {
+        if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+            throw std::invalid_argument("HLM::AlignedResource : alignment must be a power of two");
+        }
+    }
+
+    AlignedResource(const AlignedResource&) = delete;
+    AlignedResource& operator=(const AlignedResource&) = delete;
+
+    size_t alignment() const { return alignment_; }
+    int huge_pages() const { return huge_pages_; }
+
+    // Allocations served by MAP_HUGETLB, advised with MADV_HUGEPAGE, and MAP_HUGETLB requests
+    // that fell back to the transparent path, since construction
+    size_t hugetlb_allocations() const { return hugetlb_.load(std::memory_order_relaxed); }
+    size_t transparent_allocations() const { return transparent_.load(std::memory_order_relaxed); }
+    size_t hugetlb_fallbacks() const { return fallbacks_.load(std::memory_order_relaxed); }
+
+private:
+    size_t effective_alignment(const size_t& alignment) const
+    {
+        return (alignment > alignment_) ? alignment : alignment_;
+    }
+
+    // Decided on the size alone, deallocation takes the same path as the allocation
+    bool is_mapped(const size_t& bytes) const
+    {
+#ifdef HLM_HAS_MMAP
+        return huge_pages_ != HLM_HUGE_PAGES_NONE && bytes >= huge_threshold_ && bytes != 0;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static size_t mapped_length(const size_t& bytes)
+    {
+        return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (is_mapped(bytes)) {
+            return map(mapped_length(bytes));
+        }
+        return ::operator new(bytes, std::align_val_t(effective_alignment(alignment)));
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        if (is_mapped(bytes)) {
+            HLM::unmap_region(memory, mapped_length(bytes));
+            return;
+        }
+        ::operator delete(memory, std::align_val_t(effective_alignment(alignment)));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void* map(const size_t& length)
+    {
+#ifdef HLM_HAS_MMAP
+#ifdef MAP_HUGETLB
+        if (huge_pages_ == HLM_HUGE_PAGES_EXPLICIT) {
+            void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (address != MAP_FAILED) {
+                hugetlb_.fetch_add(1, std::memory_order_relaxed);
+                return address;
+            }
+            fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        }
+#endif
+        // One extra huge page, trimmed again, so the range starts on a huge page boundary
+        char* raw = static_cast<char*>(::mmap(nullptr, length + huge_page_size, PROT_READ | PROT_WRITE,
+                                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(raw);
+        char* start = raw + ((huge_page_size - base % huge_page_size) % huge_page_size);
+        if (start != raw) {
+            ::munmap(raw, static_cast<size_t>(start - raw));
+        }
+        const size_t tail = static_cast<size_t>(raw + length + huge_page_size - (start + length));
+        if (tail != 0) {
+            ::munmap(start + length, tail);
+        }
+#ifdef MADV_HUGEPAGE
+        if (::madvise(start, length, MADV_HUGEPAGE) == 0) {
+            transparent_.fetch_add(1, std::memory_order_relaxed);
+        }
+#endif
+        return start;
+#else
+        (void)length;
+        throw std::bad_alloc();
+#endif
+    }
+
+    const size_t        alignment_;
+    const int           huge_pages_;
+    const size_t        huge_threshold_;
+    std::atomic<size_t> hugetlb_;
+    std::atomic<size_t> transparent_;
+    std::atomic<size_t> fallbacks_;
+};
+
+namespace detail {
+
+    // Alignment of the elements of a block taken from resource : natural (alignof(T)),
+    // or the alignment of an AlignedResource when it is larger
+    inline size_t element_alignment(std::pmr::memory_resource* resource, const size_t& natural)
+    {
+        if (resource != nullptr) {
+            const AlignedResource* aligned = dynamic_cast<const AlignedResource*>(resource);
+            if (aligned != nullptr && aligned->alignment() > natural) {
+                return aligned->alignment();
+            }
+        }
+        return natural;
+    }
+
+} // namespace detail
+
+} // namespace HLM
+#endif
@@ -0,0 +1,102 @@
+#ifndef _HLM_MMAP_HPP_
+#define _HLM_MMAP_HPP_
+#include <string>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <cstddef>
+#include <new>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HLM_HAS_MMAP
+#else
+#include <fstream>
+#endif
+
+// Whole-file mappings backing SharedVector::map_file
+// On POSIX systems the file is mmap'd : nothing is read up front and the pages stay in the
+// page cache, shared with every other process mapping the same file
+// Elsewhere the file is read into a page-aligned heap buffer, same interface
+
+namespace HLM {
+
+/// @brief struct MappedRegion
+struct MappedRegion {
+    void*  address;   // nullptr for an empty file
+    size_t bytes;
+};
+
+namespace detail {
+
+    [[noreturn]] inline void throw_map_error(const char* what, const std::string& path)
+    {
+        throw std::runtime_error(std::string("HLM::map_file : ") + what + " " + path + " (" + std::strerror(errno) + ")");
+    }
+
+} // namespace detail
+
+// Map the whole file at path
+// writable = false : read-only pages (PROT_READ, MAP_SHARED)
+// writable = true  : private copy-on-write pages (MAP_PRIVATE), writes never reach the file
+inline MappedRegion map_region(const std::string& path, const bool& writable)
+{
+#ifdef HLM_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        detail::throw_map_error("cannot open", path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        detail::throw_map_error("cannot stat", path);
+    }
+    const size_t bytes = static_cast<size_t>(info.st_size);
+    if (bytes == 0) {
+        ::close(fd);
+        return MappedRegion{ nullptr, 0 };
+    }
+    void* address = ::mmap(nullptr, bytes, writable ? (PROT_READ | PROT_WRITE) : PROT_READ,
+                           writable ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+    ::close(fd);   // the mapping keeps its own reference on the file
+    if (address == MAP_FAILED) {
+        detail::throw_map_error("cannot map", path);
+    }
+    return MappedRegion{ address, bytes };
+#else
+    (void)writable;
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        detail::throw_map_error("cannot open", path);
+    }
+    const size_t bytes = static_cast<size_t>(file.tellg());
+    if (bytes == 0) {
+        return MappedRegion{ nullptr, 0 };
+    }
+    void* address = ::operator new(bytes, std::align_val_t(4096));
+    file.seekg(0);
+    if (!file.read(static_cast<char*>(address), static_cast<std::streamsize>(bytes))) {
+        ::operator delete(address, std::align_val_t(4096));
+        detail::throw_map_error("cannot read", path);
+    }
+    return MappedRegion{ address, bytes };
+#endif
+}
+
+inline void unmap_region(void* address, const size_t& bytes)
+{
+    if (address == nullptr) {
+        return;
+    }
+#ifdef HLM_HAS_MMAP
+    ::munmap(address, bytes);
+#else
+    (void)bytes;
+    ::operator delete(address, std::align_val_t(4096));
+#endif
+}
+
+} // namespace HLM
+#endif
@@ -0,0 +1,250 @@
+#ifndef _HLM_PARALLEL_HPP_
+#define _HLM_PARALLEL_HPP_
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <exception>
+#include <cstddef>
+#ifdef HLM_OMP_PARALLEL
+#include <omp.h>
+#endif
+
+// Parallel execution is opt-in, like the rest of the library :
+//   HLM_OMP_PARALLEL     use OpenMP
+//   HLM_THREAD_PARALLEL  use a plain std::thread fallback (no OpenMP needed)
+// Without either, every helper below runs serially on the calling thread
+
+// The 'parallel' argument of the container functions (resize, broadcast, sort, filter) :
+// HLM_PARALLEL hands large ranges to the helpers below, HLM_SERIAL stays on the calling thread
+#define HLM_SERIAL   0
+#define HLM_PARALLEL 1
+
+// Ranges shorter than this are not worth waking threads for
+#ifndef HLM_PARALLEL_THRESHOLD
+#define HLM_PARALLEL_THRESHOLD 65536
+#endif
+
+// Chunk size of the deterministic reduction, fixed so results do not depend on the thread count
+#ifndef HLM_DETERMINISTIC_CHUNK
+#define HLM_DETERMINISTIC_CHUNK 16384
+#endif
+
+namespace HLM {
+namespace parallel {
+
+    inline size_t thread_count()
+    {
+#if defined(HLM_OMP_PARALLEL)
+        return static_cast<size_t>(omp_get_max_threads());
+#elif defined(HLM_THREAD_PARALLEL)
+        // hardware_concurrency() reads /sys on Linux, microseconds per call : ask once
+        static const size_t hardware = std::thread::hardware_concurrency();
+        return (hardware != 0) ? hardware : 1;
+#else
+        return 1;
+#endif
+    }
+
+    // Number of workers worth using for n elements
+    inline size_t worker_count(const size_t& n)
+    {
+        const size_t useful = n / HLM_PARALLEL_THRESHOLD;
+        const size_t threads = thread_count();
+        if (useful <= 1) {
+            return 1;
+        }
+        return (useful < threads) ? useful : threads;
+    }
+
+    // Contiguous block k out of parts, the same split as OpenMP schedule(static)
+    inline void static_range(const size_t& n, const size_t& parts, const size_t& k, size_t& begin, size_t& end)
+    {
+        const size_t base  = n / parts;
+        const size_t extra = n % parts;
+        begin = k * base + ((k < extra) ? k : extra);
+        end   = begin + base + ((k < extra) ? 1 : 0);
+    }
+
+    // Run task(k) for every k in [0, parts), part k always on worker k
+    // The first exception thrown by a task is rethrown on the calling thread
+    template <typename Task>
+    void run(const size_t& parts, Task&& task)
+    {
+        if (parts <= 1) {
+            if (parts == 1) {
+                task(static_cast<size_t>(0));
+            }
+            return;
+        }
+        std::vector<std::exception_ptr> errors(parts);
+#if defined(HLM_OMP_PARALLEL)
+        #pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(parts))
+        for (long k = 0; k < static_cast<long>(parts); ++k) {
+            try {
+                task(static_cast<size_t>(k));
+            }
+            catch (...) {
+                errors[static_cast<size_t>(k)] = std::current_exception();
+            }
+        }
+#else
+        std::vector<std::thread> workers;
+        workers.reserve(parts - 1);
+        for (size_t k = 1; k < parts; ++k) {
+            workers.emplace_back([&task, &errors, k]() {
+                try {
+                    task(k);
+                }
+                catch (...) {
+                    errors[k] = std::current_exception();
+                }
+            });
+        }
+        try {
+            task(static_cast<size_t>(0));
+        }
+        catch (...) {
+            errors[0] = std::current_exception();
+        }
+        for (size_t k = 0; k < workers.size(); ++k) {
+            workers[k].join();
+        }
+#endif
+        for (size_t k = 0; k < parts; ++k) {
+            if (errors[k]) {
+                std::rethrow_exception(errors[k]);
+            }
+        }
+    }
+
+    /// @brief for_blocks
+    // task(begin, end) over the static split of [0, n) into worker_count(n) blocks, block k on worker k
+    // From n >= thread_count() * HLM_PARALLEL_THRESHOLD on, that is the split of an OpenMP
+    // schedule(static) loop over the whole team, and the one of reduce_range in fast mode
+    template <typename Task>
+    void for_blocks(const size_t& n, Task&& task)
+    {
+        const size_t parts = worker_count(n);
+        run(parts, [&](const size_t& k) {
+            size_t begin, end;
+            static_range(n, parts, k, begin, end);
+            task(begin, end);
+        });
+    }
+
+    /// @brief First-touch initialisation
+    // The OS places a page on the NUMA node of the thread that first writes it : filling a fresh
+    // buffer with for_blocks puts every block next to the worker that later loops over it
+
+    // std::fill_n over the workers
+    template <typename T>
+    void fill(T* first, const size_t& n, const T& value)
+    {
+        for_blocks(n, [first, &value](const size_t& begin, const size_t& end) {
+            std::fill_n(first + begin, end - begin, value);
+        });
+    }
+
+    // std::uninitialized_value_construct_n over the workers, nothing is left constructed if one throws
+    template <typename T>
+    void uninitialized_value_construct(T* first, const size_t& n)
+    {
+        const size_t parts = worker_count(n);
+        std::vector<char> constructed(parts, 0);
+        try {
+            run(parts, [&](const size_t& k) {
+                size_t begin, end;
+                static_range(n, parts, k, begin, end);
+                std::uninitialized_value_construct_n(first + begin, end - begin);
+                constructed[k] = 1;
+            });
+        }
+        catch (...) {
+            for (size_t k = 0; k < parts; ++k) {
+                if (constructed[k]) {
+                    size_t begin, end;
+                    static_range(n, parts, k, begin, end);
+                    std::destroy_n(first + begin, end - begin);
+                }
+            }
+            throw;
+        }
+    }
+
+    // Serial left fold of [first, first + n), n >= 1
+    template <typename T, typename Combine>
+    T fold(const T* first, const size_t& n, Combine& combine)
+    {
+        T accum = first[0];
+        for (size_t i = 1; i < n; ++i) {
+            accum = combine(accum, first[i]);
+        }
+        return accum;
+    }
+
+    /// @brief reduce_range
+    // Blocked reduction of the index range [0, n), n >= 1 :
+    // fold_range(begin, end) reduces one block, combine(left, right) merges two partials (associative)
+    // seed only initialises the partials, it is never combined
+    // Fast mode    : one contiguous block per worker, partials combined left to right
+    // Deterministic: fixed HLM_DETERMINISTIC_CHUNK blocks, then combined in a fixed pairwise tree,
+    //                so floating point results are bit-identical for any thread count
+    //                (including the serial build)
+    template <typename T, typename FoldRange, typename Combine>
+    T reduce_range(const size_t& n, const T& seed, FoldRange fold_range, Combine combine, const bool& deterministic)
+    {
+        const size_t chunk  = HLM_DETERMINISTIC_CHUNK;
+        const size_t blocks = deterministic ? (n + chunk - 1) / chunk : worker_count(n);
+        if (blocks <= 1) {
+            return fold_range(static_cast<size_t>(0), n);
+        }
+
+        std::vector<T> partials(blocks, seed);
+        size_t workers = deterministic ? worker_count(n) : blocks;
+        if (workers > blocks) {
+            workers = blocks;
+        }
+        run(workers, [&](const size_t& k) {
+            size_t block_begin, block_end;
+            static_range(blocks, workers, k, block_begin, block_end);
+            for (size_t b = block_begin; b < block_end; ++b) {
+                size_t begin, end;
+                if (deterministic) {
+                    begin = b * chunk;
+                    end   = (begin + chunk < n) ? begin + chunk : n;
+                }
+                else {
+                    static_range(n, blocks, b, begin, end);
+                }
+                partials[b] = fold_range(begin, end);
+            }
+        });
+
+        if (!deterministic) {
+            return fold(partials.data(), blocks, combine);
+        }
+        for (size_t step = 1; step < blocks; step *= 2) {
+            for (size_t i = 0; i + step < blocks; i += 2 * step) {
+                partials[i] = combine(partials[i], partials[i + step]);
+            }
+        }
+        return partials[0];
+    }
+
+    /// @brief reduce
+    // Tree reduction of [first, first + n), n >= 1, with combine(acc, element) assumed associative
+    // Every block is a serial left fold, see reduce_range for the two modes
+    template <typename T, typename Combine>
+    T reduce(const T* first, const size_t& n, Combine combine, const bool& deterministic)
+    {
+        return reduce_range(n, first[0],
+                            [first, &combine](const size_t& begin, const size_t& end) {
+                                return fold(first + begin, end - begin, combine);
+                            },
+                            combine, deterministic);
+    }
+
+} // namespace parallel
+} // namespace HLM
+#endif
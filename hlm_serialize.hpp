@@ -0,0 +1,435 @@
+#ifndef _HLM_SERIALIZE_HPP_
+#define _HLM_SERIALIZE_HPP_
+#include <istream>
+#include <ostream>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+// Binary format of a saved HLM::Vector / HELIUM_API::SharedVector, T trivially copyable :
+//
+//   offset  size
+//        0     4  magic "HLMV"
+//        4     2  format version (1)
+//        6     2  header size (64)
+//        8     4  endianness marker 0x01020304 as written by the saving machine
+//       12     4  type tag (HLM::TypeTag<T>, 0 : opaque type, only the element size is checked)
+//       16     8  element size
+//       24     8  element count
+//       32     8  payload offset, a multiple of 64 and of alignof(T)
+//       40     8  checksum of the payload (XXH64, seed 0)
+//       48    16  reserved, zero
+//   payload offset  count * element size bytes, the raw elements
+//
+// The payload is aligned so a saved file or buffer can be used in place :
+//   HLM::view_buffer<T>(buffer, bytes)          borrow the elements of an in-memory image
+//   SharedVector<T>::map_saved(path, mode)      map a saved file (see hlm_mmap.hpp)
+// Files saved on a machine of the other endianness load through the streaming load(), which swaps
+// arithmetic elements, the zero-copy paths reject them
+
+#define HLM_SKIP_CHECKSUM   0
+#define HLM_VERIFY_CHECKSUM 1
+
+namespace HLM {
+
+/// @brief TypeTag
+// Identifies the element type in the header, specialise it for your own records (values >= 256)
+// to have load() reject files of another type with the same size
+template <typename T> struct TypeTag { static const uint32_t value = 0; };
+template <> struct TypeTag<int8_t>   { static const uint32_t value = 1; };
+template <> struct TypeTag<uint8_t>  { static const uint32_t value = 2; };
+template <> struct TypeTag<int16_t>  { static const uint32_t value = 3; };
+template <> struct TypeTag<uint16_t> { static const uint32_t value = 4; };
+template <> struct TypeTag<int32_t>  { static const uint32_t value = 5; };
+template <> struct TypeTag<uint32_t> { static const uint32_t value = 6; };
+template <> struct TypeTag<int64_t>  { static const uint32_t value = 7; };
+template <> struct TypeTag<uint64_t> { static const uint32_t value = 8; };
+template <> struct TypeTag<float>    { static const uint32_t value = 9; };
+template <> struct TypeTag<double>   { static const uint32_t value = 10; };
+template <> struct TypeTag<char>     { static const uint32_t value = 11; };
+template <> struct TypeTag<bool>     { static const uint32_t value = 12; };
+
+/// @brief struct SavedHeader
+struct SavedHeader {
+    char     magic[4];
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t endianness;
+    uint32_t type_tag;
+    uint64_t element_size;
+    uint64_t count;
+    uint64_t payload_offset;
+    uint64_t checksum;
+    uint8_t  reserved[16];
+};
+static_assert(sizeof(SavedHeader) == 64, "HLM::SavedHeader must stay 64 bytes");
+
+static const uint16_t saved_format_version = 1;
+static const uint32_t endianness_marker    = 0x01020304u;
+
+namespace detail {
+
+    inline uint16_t byte_swap(const uint16_t& x) { return static_cast<uint16_t>((x << 8) | (x >> 8)); }
+    inline uint32_t byte_swap(const uint32_t& x)
+    {
+        return (x >> 24) | ((x >> 8) & 0x0000FF00u) | ((x << 8) & 0x00FF0000u) | (x << 24);
+    }
+    inline uint64_t byte_swap(const uint64_t& x)
+    {
+        return (static_cast<uint64_t>(byte_swap(static_cast<uint32_t>(x))) << 32) | byte_swap(static_cast<uint32_t>(x >> 32));
+    }
+
+    inline bool host_is_little_endian()
+    {
+        const uint32_t one = 1;
+        unsigned char first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+    }
+
+    // Little-endian reads, so the checksum of a payload does not depend on the host
+    inline uint64_t read_le64(const unsigned char* p)
+    {
+        uint64_t x;
+        std::memcpy(&x, p, 8);
+        return host_is_little_endian() ? x : byte_swap(x);
+    }
+
+    inline uint32_t read_le32(const unsigned char* p)
+    {
+        uint32_t x;
+        std::memcpy(&x, p, 4);
+        return host_is_little_endian() ? x : byte_swap(x);
+    }
+
+    inline uint64_t rotl64(const uint64_t& x, const int& r) { return (x << r) | (x >> (64 - r)); }
+
+    static const uint64_t xxh_p1 = 11400714785074694791ULL;
+    static const uint64_t xxh_p2 = 14029467366897019727ULL;
+    static const uint64_t xxh_p3 = 1609587929392839161ULL;
+    static const uint64_t xxh_p4 = 9650029242287828579ULL;
+    static const uint64_t xxh_p5 = 2870177450012600261ULL;
+
+    inline uint64_t xxh_round(uint64_t acc, const uint64_t& input)
+    {
+        acc += input * xxh_p2;
+        acc  = rotl64(acc, 31);
+        return acc * xxh_p1;
+    }
+
+    inline uint64_t xxh_merge(uint64_t acc, const uint64_t& lane)
+    {
+        acc ^= xxh_round(0, lane);
+        return acc * xxh_p1 + xxh_p4;
+    }
+
+    [[noreturn]] inline void throw_load_error(const std::string& what)
+    {
+        throw std::runtime_error("HLM::load : " + what);
+    }
+
+    // Bytes left in a seekable stream, -1 when the stream cannot tell (pipes, sockets)
+    inline std::streamoff remaining_bytes(std::istream& in)
+    {
+        const std::streampos here = in.tellg();
+        if (here == std::streampos(-1)) {
+            return -1;
+        }
+        in.seekg(0, std::ios::end);
+        const std::streampos end = in.tellg();
+        in.clear();
+        in.seekg(here);
+        if (end == std::streampos(-1) || !in) {
+            in.clear();
+            return -1;
+        }
+        return static_cast<std::streamoff>(end - here);
+    }
+
+    // First chunk of a payload read from a stream of unknown length, the chunks double from there
+    static const size_t load_chunk_bytes = size_t(1) << 20;
+
+    template <typename T>
+    constexpr size_t payload_alignment()
+    {
+        return (alignof(T) > 64) ? alignof(T) : 64;
+    }
+
+    // Validate a header against T, swapping its fields when it comes from the other endianness
+    // Returns true when the payload is in the other endianness
+    template <typename T>
+    bool check_header(SavedHeader& header)
+    {
+        if (std::memcmp(header.magic, "HLMV", 4) != 0) {
+            throw_load_error("not an HLM vector image");
+        }
+        bool foreign = false;
+        if (header.endianness != endianness_marker) {
+            if (header.endianness != byte_swap(endianness_marker)) {
+                throw_load_error("corrupt header");
+            }
+            foreign = true;
+            header.version        = byte_swap(header.version);
+            header.header_size    = byte_swap(header.header_size);
+            header.type_tag       = byte_swap(header.type_tag);
+            header.element_size   = byte_swap(header.element_size);
+            header.count          = byte_swap(header.count);
+            header.payload_offset = byte_swap(header.payload_offset);
+            header.checksum       = byte_swap(header.checksum);
+        }
+        if (header.version == 0 || header.version > saved_format_version) {
+            throw_load_error("unsupported format version " + std::to_string(header.version));
+        }
+        if (header.element_size != sizeof(T) || header.type_tag != TypeTag<T>::value) {
+            throw_load_error("element type mismatch");
+        }
+        if (header.payload_offset < sizeof(SavedHeader) || header.payload_offset % alignof(T) != 0 ||
+            header.count > (static_cast<uint64_t>(-1) - header.payload_offset) / sizeof(T)) {
+            throw_load_error("corrupt header");
+        }
+        return foreign;
+    }
+
+    // Swap every element of a foreign payload, only arithmetic types can be swapped
+    template <typename T>
+    void swap_elements(T* elements, const size_t& n)
+    {
+        if constexpr (std::is_arithmetic<T>::value && sizeof(T) > 1) {
+            typedef typename std::conditional<sizeof(T) == 2, uint16_t,
+                    typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type>::type Word;
+            static_assert(sizeof(Word) == sizeof(T), "HLM::load : unsupported arithmetic size");
+            for (size_t i = 0; i < n; ++i) {
+                Word w;
+                std::memcpy(&w, elements + i, sizeof(T));
+                w = byte_swap(w);
+                std::memcpy(elements + i, &w, sizeof(T));
+            }
+        }
+        else if constexpr (sizeof(T) > 1) {
+            (void)elements;
+            if (n != 0) {
+                throw_load_error("saved with the other endianness, elements cannot be swapped");
+            }
+        }
+        else {
+            (void)elements;
+            (void)n;
+        }
+    }
+
+} // namespace detail
+
+/// @brief checksum64
+// XXH64 of [data, data + bytes), four independent lanes so it runs at memory speed
+inline uint64_t checksum64(const void* data, const size_t& bytes, const uint64_t& seed = 0)
+{
+    using namespace detail;
+    const unsigned char* p   = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + bytes;
+    uint64_t h;
+    if (bytes >= 32) {
+        uint64_t v1 = seed + xxh_p1 + xxh_p2;
+        uint64_t v2 = seed + xxh_p2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - xxh_p1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = xxh_round(v1, read_le64(p));
+            v2 = xxh_round(v2, read_le64(p + 8));
+            v3 = xxh_round(v3, read_le64(p + 16));
+            v4 = xxh_round(v4, read_le64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    }
+    else {
+        h = seed + xxh_p5;
+    }
+    h += static_cast<uint64_t>(bytes);
+    while (p + 8 <= end) {
+        h ^= xxh_round(0, read_le64(p));
+        h  = rotl64(h, 27) * xxh_p1 + xxh_p4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read_le32(p)) * xxh_p1;
+        h  = rotl64(h, 23) * xxh_p2 + xxh_p3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * xxh_p5;
+        h  = rotl64(h, 11) * xxh_p1;
+        ++p;
+    }
+    h ^= h >> 33;
+    h *= xxh_p2;
+    h ^= h >> 29;
+    h *= xxh_p3;
+    h ^= h >> 32;
+    return h;
+}
+
+/// @brief struct SavedPayload
+// Where the elements of a saved image are
+struct SavedPayload {
+    size_t offset;
+    size_t count;
+};
+
+/// @brief parse_saved
+// Check the image [image, image + bytes) for T and locate its payload, the zero-copy loaders use it
+// Throws std::runtime_error on a bad header, a truncated image, a checksum mismatch or
+// an image of the other endianness
+template <typename T>
+SavedPayload parse_saved(const void* image, const size_t& bytes, const bool& verify = HLM_VERIFY_CHECKSUM)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "HLM::load : T must be trivially copyable");
+    if (bytes < sizeof(SavedHeader)) {
+        detail::throw_load_error("truncated image");
+    }
+    SavedHeader header;
+    std::memcpy(&header, image, sizeof(SavedHeader));
+    if (detail::check_header<T>(header) && header.count != 0 && sizeof(T) > 1) {
+        detail::throw_load_error("saved with the other endianness, use the streaming load");
+    }
+    const size_t payload_bytes = static_cast<size_t>(header.count) * sizeof(T);
+    if (header.payload_offset + payload_bytes > bytes) {
+        detail::throw_load_error("truncated image");
+    }
+    const char* payload = static_cast<const char*>(image) + header.payload_offset;
+    if (reinterpret_cast<uintptr_t>(payload) % alignof(T) != 0) {
+        detail::throw_load_error("image is not aligned for T");
+    }
+    if (verify && checksum64(payload, payload_bytes) != header.checksum) {
+        detail::throw_load_error("checksum mismatch");
+    }
+    return SavedPayload{ static_cast<size_t>(header.payload_offset), static_cast<size_t>(header.count) };
+}
+
+/// @brief save
+// Write vector (HLM::Vector or HELIUM_API::SharedVector of a trivially copyable T) to out
+// Throws std::runtime_error when the stream fails
+template <typename Container>
+void save(std::ostream& out, const Container& vector)
+{
+    typedef typename Container::value_type T;
+    static_assert(std::is_trivially_copyable<T>::value, "HLM::save : T must be trivially copyable");
+    const size_t n = vector.size();
+    const T* elements = vector.data();
+    const size_t payload_bytes = n * sizeof(T);
+
+    SavedHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "HLMV", 4);
+    header.version        = saved_format_version;
+    header.header_size    = sizeof(SavedHeader);
+    header.endianness     = endianness_marker;
+    header.type_tag       = TypeTag<T>::value;
+    header.element_size   = sizeof(T);
+    header.count          = n;
+    header.payload_offset = detail::payload_alignment<T>();
+    header.checksum       = checksum64(elements, payload_bytes);
+
+    static const char zeros[64] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t pad = header.payload_offset - sizeof(header); pad != 0; ) {
+        const size_t chunk = (pad < sizeof(zeros)) ? pad : sizeof(zeros);
+        out.write(zeros, static_cast<std::streamsize>(chunk));
+        pad -= chunk;
+    }
+    out.write(reinterpret_cast<const char*>(elements), static_cast<std::streamsize>(payload_bytes));
+    if (!out) {
+        throw std::runtime_error("HLM::save : write failed");
+    }
+}
+
+/// @brief load
+// Read a vector written by save(), the stream is left right after the payload
+// Images of the other endianness are swapped for arithmetic T
+// The header count is not trusted for the allocation : a seekable stream shorter than the payload
+// is rejected up front, other streams are read in doubling chunks, so a corrupt count costs
+// at most twice the bytes actually received before the truncation is detected
+template <typename Container>
+Container load(std::istream& in, const bool& verify = HLM_VERIFY_CHECKSUM)
+{
+    typedef typename Container::value_type T;
+    static_assert(std::is_trivially_copyable<T>::value, "HLM::load : T must be trivially copyable");
+    SavedHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        detail::throw_load_error("truncated stream");
+    }
+    const bool foreign = detail::check_header<T>(header);
+    in.ignore(static_cast<std::streamsize>(header.payload_offset - sizeof(header)));
+
+    const size_t count = static_cast<size_t>(header.count);
+    const size_t payload_bytes = count * sizeof(T);
+    const std::streamoff remaining = detail::remaining_bytes(in);
+    if (remaining >= 0 && static_cast<uint64_t>(remaining) < payload_bytes) {
+        detail::throw_load_error("truncated stream");
+    }
+
+    Container vector;
+    const size_t first_chunk = (detail::load_chunk_bytes + sizeof(T) - 1) / sizeof(T);
+    size_t loaded = 0;
+    while (loaded < count) {
+        size_t chunk = count - loaded;
+        if (remaining < 0) {
+            const size_t limit = (loaded > first_chunk) ? loaded : first_chunk;
+            chunk = (chunk < limit) ? chunk : limit;
+        }
+        vector.resize(loaded + chunk);
+        if (!in.read(reinterpret_cast<char*>(vector.data() + loaded), static_cast<std::streamsize>(chunk * sizeof(T)))) {
+            detail::throw_load_error("truncated stream");
+        }
+        loaded += chunk;
+    }
+    const T* elements = vector.data();
+    if (verify && checksum64(elements, payload_bytes) != header.checksum) {
+        detail::throw_load_error("checksum mismatch");
+    }
+    if (foreign) {
+        detail::swap_elements(vector.data(), vector.size());
+    }
+    return vector;
+}
+
+/// @brief class BufferView
+// Elements of a saved image used in place, the image must outlive the view
+template <typename T>
+class BufferView {
+public:
+    typedef T        value_type;
+    typedef const T* const_iterator;
+
+    BufferView(const T* elements, const size_t& count) : elements_(elements), count_(count) {}
+
+    size_t size() const { return count_; }
+    const T* data() const { return elements_; }
+    const T& operator[](const size_t& index) const { return elements_[index]; }
+    const_iterator begin() const { return elements_; }
+    const_iterator end() const { return elements_ + count_; }
+
+private:
+    const T* elements_;
+    size_t   count_;
+};
+
+/// @brief view_buffer
+// Zero-copy load from an in-memory image written by save() (e.g. received over the network)
+// The image start must be aligned to alignof(T)
+template <typename T>
+BufferView<T> view_buffer(const void* image, const size_t& bytes, const bool& verify = HLM_VERIFY_CHECKSUM)
+{
+    const SavedPayload payload = parse_saved<T>(image, bytes, verify);
+    return BufferView<T>(reinterpret_cast<const T*>(static_cast<const char*>(image) + payload.offset), payload.count);
+}
+
+} // namespace HLM
+#endif
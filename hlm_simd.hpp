@@ -0,0 +1,433 @@
+#ifndef _HLM_SIMD_HPP_
+#define _HLM_SIMD_HPP_
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+// Vectorised kernels for the arithmetic element types int32_t, int64_t, float and double :
+//   sum, min, max, dot, find (first index of) and replace (masked replace)
+// On x86-64 with GCC / Clang the widest of AVX2 / SSE2 supported by the running CPU is picked
+// at first use, everything else (and HLM_DISABLE_SIMD) uses the scalar kernels
+// Integer sums and dot products wrap around on overflow on every path
+// Floating point sums and dot products are reassociated, so they may differ from a serial loop
+// in the last bits, min / max of ranges containing NaN are unspecified
+
+#if !defined(HLM_DISABLE_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define HLM_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace HLM {
+namespace simd {
+
+    /// @brief is_accelerated
+    // True for the element types that have SIMD kernels
+    template <typename T>
+    struct is_accelerated : std::integral_constant<bool,
+        std::is_same<T, int32_t>::value || std::is_same<T, int64_t>::value ||
+        std::is_same<T, float>::value   || std::is_same<T, double>::value> {};
+
+    enum Isa { ISA_SCALAR = 0, ISA_SSE2 = 1, ISA_AVX2 = 2 };
+
+    // Instruction set used by the dispatching kernels, detected once
+    inline Isa active_isa()
+    {
+#ifdef HLM_SIMD_X86
+        static const Isa isa = []() {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return ISA_AVX2;
+            }
+            if (__builtin_cpu_supports("sse2")) {
+                return ISA_SSE2;
+            }
+            return ISA_SCALAR;
+        }();
+        return isa;
+#else
+        return ISA_SCALAR;
+#endif
+    }
+
+namespace scalar {
+
+    // Integer arithmetic goes through the unsigned type so overflow wraps like the vector lanes do
+    template <typename T>
+    inline T add(const T& a, const T& b)
+    {
+        if constexpr (std::is_integral<T>::value) {
+            typedef typename std::make_unsigned<T>::type U;
+            return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+        }
+        else {
+            return a + b;
+        }
+    }
+
+    template <typename T>
+    inline T mul(const T& a, const T& b)
+    {
+        if constexpr (std::is_integral<T>::value) {
+            typedef typename std::make_unsigned<T>::type U;
+            return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+        }
+        else {
+            return a * b;
+        }
+    }
+
+    template <typename T>
+    T sum(const T* first, const size_t& n)
+    {
+        T accum = T();
+        for (size_t i = 0; i < n; ++i) {
+            accum = add(accum, first[i]);
+        }
+        return accum;
+    }
+
+    template <typename T>
+    T dot(const T* a, const T* b, const size_t& n)
+    {
+        T accum = T();
+        for (size_t i = 0; i < n; ++i) {
+            accum = add(accum, mul(a[i], b[i]));
+        }
+        return accum;
+    }
+
+    // n >= 1
+    template <typename T>
+    T min(const T* first, const size_t& n)
+    {
+        T result = first[0];
+        for (size_t i = 1; i < n; ++i) {
+            result = (first[i] < result) ? first[i] : result;
+        }
+        return result;
+    }
+
+    // n >= 1
+    template <typename T>
+    T max(const T* first, const size_t& n)
+    {
+        T result = first[0];
+        for (size_t i = 1; i < n; ++i) {
+            result = (result < first[i]) ? first[i] : result;
+        }
+        return result;
+    }
+
+    template <typename T>
+    size_t find(const T* first, const size_t& n, const T& value)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            if (first[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    template <typename T>
+    void replace(T* first, const size_t& n, const T& old_value, const T& new_value)
+    {
+        for (size_t i = 0; i < n; ++i) {
+            if (first[i] == old_value) {
+                first[i] = new_value;
+            }
+        }
+    }
+
+} // namespace scalar
+
+#ifdef HLM_SIMD_X86
+
+namespace detail {
+
+    // Horizontal reductions spill the register, they run once per kernel call
+    template <typename T, size_t Lanes, typename Op>
+    inline T reduce_lanes(const T (&lanes)[Lanes], Op op)
+    {
+        T result = lanes[0];
+        for (size_t i = 1; i < Lanes; ++i) {
+            result = op(result, lanes[i]);
+        }
+        return result;
+    }
+
+    template <typename T> inline T lane_add(const T& a, const T& b) { return scalar::add(a, b); }
+    template <typename T> inline T lane_min(const T& a, const T& b) { return (b < a) ? b : a; }
+    template <typename T> inline T lane_max(const T& a, const T& b) { return (a < b) ? b : a; }
+
+} // namespace detail
+
+#define HLM_SIMD_REDUCTIONS(TYPE, LANES, STORE)                                                                         \
+    static HLM_SIMD_TARGET TYPE reduce_add(reg x) { TYPE l[LANES]; STORE(l, x); return detail::reduce_lanes(l, detail::lane_add<TYPE>); } \
+    static HLM_SIMD_TARGET TYPE reduce_min(reg x) { TYPE l[LANES]; STORE(l, x); return detail::reduce_lanes(l, detail::lane_min<TYPE>); } \
+    static HLM_SIMD_TARGET TYPE reduce_max(reg x) { TYPE l[LANES]; STORE(l, x); return detail::reduce_lanes(l, detail::lane_max<TYPE>); }
+
+namespace sse2 {
+
+#define HLM_SIMD_TARGET
+
+    template <typename T> struct Ops;
+
+    template <> struct Ops<int32_t> {
+        typedef __m128i reg;
+        static const size_t lanes = 4;
+        static reg load(const int32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        static void store(int32_t* p, reg x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+        static reg set1(int32_t v) { return _mm_set1_epi32(v); }
+        static reg zero() { return _mm_setzero_si128(); }
+        static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+        // No pmulld before SSE4.1 : multiply even and odd lanes as 64 bit and keep the low halves
+        static reg mul(reg a, reg b)
+        {
+            const reg even = _mm_mul_epu32(a, b);
+            const reg odd  = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                      _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+        static reg blend(reg a, reg b, reg mask) { return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a)); }
+        static reg min(reg a, reg b) { return blend(a, b, _mm_cmpgt_epi32(a, b)); }
+        static reg max(reg a, reg b) { return blend(a, b, _mm_cmpgt_epi32(b, a)); }
+        static reg eq(reg a, reg b) { return _mm_cmpeq_epi32(a, b); }
+        static unsigned movemask(reg m) { return static_cast<unsigned>(_mm_movemask_epi8(m)); }
+        HLM_SIMD_REDUCTIONS(int32_t, 4, store)
+    };
+
+    template <> struct Ops<int64_t> {
+        typedef __m128i reg;
+        static const size_t lanes = 2;
+        static reg load(const int64_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        static void store(int64_t* p, reg x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+        static reg set1(int64_t v) { return _mm_set1_epi64x(v); }
+        static reg zero() { return _mm_setzero_si128(); }
+        static reg add(reg a, reg b) { return _mm_add_epi64(a, b); }
+        // Low 64 bits of the product from three 32 x 32 multiplies
+        static reg mul(reg a, reg b)
+        {
+            const reg low   = _mm_mul_epu32(a, b);
+            const reg cross = _mm_add_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), b),
+                                            _mm_mul_epu32(a, _mm_srli_epi64(b, 32)));
+            return _mm_add_epi64(low, _mm_slli_epi64(cross, 32));
+        }
+        static reg blend(reg a, reg b, reg mask) { return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a)); }
+        // Signed 64 bit a > b from 32 bit compares : high halves signed, low halves unsigned
+        static reg gt(reg a, reg b)
+        {
+            const reg sign   = _mm_set1_epi32(static_cast<int>(0x80000000u));
+            const reg hi_gt  = _mm_cmpgt_epi32(a, b);
+            const reg hi_eq  = _mm_cmpeq_epi32(a, b);
+            const reg lo_gt  = _mm_cmpgt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+            const reg result = _mm_or_si128(hi_gt, _mm_and_si128(hi_eq, _mm_shuffle_epi32(lo_gt, _MM_SHUFFLE(2, 2, 0, 0))));
+            return _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 3, 1, 1));
+        }
+        static reg min(reg a, reg b) { return blend(a, b, gt(a, b)); }
+        static reg max(reg a, reg b) { return blend(a, b, gt(b, a)); }
+        static reg eq(reg a, reg b)
+        {
+            const reg halves = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+        static unsigned movemask(reg m) { return static_cast<unsigned>(_mm_movemask_epi8(m)); }
+        HLM_SIMD_REDUCTIONS(int64_t, 2, store)
+    };
+
+    template <> struct Ops<float> {
+        typedef __m128 reg;
+        static const size_t lanes = 4;
+        static reg load(const float* p) { return _mm_loadu_ps(p); }
+        static void store(float* p, reg x) { _mm_storeu_ps(p, x); }
+        static reg set1(float v) { return _mm_set1_ps(v); }
+        static reg zero() { return _mm_setzero_ps(); }
+        static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+        static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+        static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+        static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+        static reg eq(reg a, reg b) { return _mm_cmpeq_ps(a, b); }
+        static reg blend(reg a, reg b, reg mask) { return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a)); }
+        static unsigned movemask(reg m) { return static_cast<unsigned>(_mm_movemask_epi8(_mm_castps_si128(m))); }
+        HLM_SIMD_REDUCTIONS(float, 4, store)
+    };
+
+    template <> struct Ops<double> {
+        typedef __m128d reg;
+        static const size_t lanes = 2;
+        static reg load(const double* p) { return _mm_loadu_pd(p); }
+        static void store(double* p, reg x) { _mm_storeu_pd(p, x); }
+        static reg set1(double v) { return _mm_set1_pd(v); }
+        static reg zero() { return _mm_setzero_pd(); }
+        static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+        static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+        static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+        static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+        static reg eq(reg a, reg b) { return _mm_cmpeq_pd(a, b); }
+        static reg blend(reg a, reg b, reg mask) { return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a)); }
+        static unsigned movemask(reg m) { return static_cast<unsigned>(_mm_movemask_epi8(_mm_castpd_si128(m))); }
+        HLM_SIMD_REDUCTIONS(double, 2, store)
+    };
+
+#include "hlm_simd_kernels.inl"
+
+#undef HLM_SIMD_TARGET
+
+} // namespace sse2
+
+namespace avx2 {
+
+// Compiled for AVX2 regardless of -march, only ever called after the runtime check
+#define HLM_SIMD_TARGET __attribute__((target("avx2")))
+
+    template <typename T> struct Ops;
+
+    template <> struct Ops<int32_t> {
+        typedef __m256i reg;
+        static const size_t lanes = 8;
+        static HLM_SIMD_TARGET reg load(const int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static HLM_SIMD_TARGET void store(int32_t* p, reg x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+        static HLM_SIMD_TARGET reg set1(int32_t v) { return _mm256_set1_epi32(v); }
+        static HLM_SIMD_TARGET reg zero() { return _mm256_setzero_si256(); }
+        static HLM_SIMD_TARGET reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+        static HLM_SIMD_TARGET reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+        static HLM_SIMD_TARGET reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+        static HLM_SIMD_TARGET reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+        static HLM_SIMD_TARGET reg eq(reg a, reg b) { return _mm256_cmpeq_epi32(a, b); }
+        static HLM_SIMD_TARGET reg blend(reg a, reg b, reg mask) { return _mm256_blendv_epi8(a, b, mask); }
+        static HLM_SIMD_TARGET unsigned movemask(reg m) { return static_cast<unsigned>(_mm256_movemask_epi8(m)); }
+        HLM_SIMD_REDUCTIONS(int32_t, 8, store)
+    };
+
+    template <> struct Ops<int64_t> {
+        typedef __m256i reg;
+        static const size_t lanes = 4;
+        static HLM_SIMD_TARGET reg load(const int64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        static HLM_SIMD_TARGET void store(int64_t* p, reg x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+        static HLM_SIMD_TARGET reg set1(int64_t v) { return _mm256_set1_epi64x(v); }
+        static HLM_SIMD_TARGET reg zero() { return _mm256_setzero_si256(); }
+        static HLM_SIMD_TARGET reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+        // No vpmullq before AVX-512 : low 64 bits of the product from three 32 x 32 multiplies
+        static HLM_SIMD_TARGET reg mul(reg a, reg b)
+        {
+            const reg low   = _mm256_mul_epu32(a, b);
+            const reg cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                               _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+            return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+        }
+        static HLM_SIMD_TARGET reg min(reg a, reg b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+        static HLM_SIMD_TARGET reg max(reg a, reg b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a)); }
+        static HLM_SIMD_TARGET reg eq(reg a, reg b) { return _mm256_cmpeq_epi64(a, b); }
+        static HLM_SIMD_TARGET reg blend(reg a, reg b, reg mask) { return _mm256_blendv_epi8(a, b, mask); }
+        static HLM_SIMD_TARGET unsigned movemask(reg m) { return static_cast<unsigned>(_mm256_movemask_epi8(m)); }
+        HLM_SIMD_REDUCTIONS(int64_t, 4, store)
+    };
+
+    template <> struct Ops<float> {
+        typedef __m256 reg;
+        static const size_t lanes = 8;
+        static HLM_SIMD_TARGET reg load(const float* p) { return _mm256_loadu_ps(p); }
+        static HLM_SIMD_TARGET void store(float* p, reg x) { _mm256_storeu_ps(p, x); }
+        static HLM_SIMD_TARGET reg set1(float v) { return _mm256_set1_ps(v); }
+        static HLM_SIMD_TARGET reg zero() { return _mm256_setzero_ps(); }
+        static HLM_SIMD_TARGET reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+        static HLM_SIMD_TARGET reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+        static HLM_SIMD_TARGET reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+        static HLM_SIMD_TARGET reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+        static HLM_SIMD_TARGET reg eq(reg a, reg b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        static HLM_SIMD_TARGET reg blend(reg a, reg b, reg mask) { return _mm256_blendv_ps(a, b, mask); }
+        static HLM_SIMD_TARGET unsigned movemask(reg m) { return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castps_si256(m))); }
+        HLM_SIMD_REDUCTIONS(float, 8, store)
+    };
+
+    template <> struct Ops<double> {
+        typedef __m256d reg;
+        static const size_t lanes = 4;
+        static HLM_SIMD_TARGET reg load(const double* p) { return _mm256_loadu_pd(p); }
+        static HLM_SIMD_TARGET void store(double* p, reg x) { _mm256_storeu_pd(p, x); }
+        static HLM_SIMD_TARGET reg set1(double v) { return _mm256_set1_pd(v); }
+        static HLM_SIMD_TARGET reg zero() { return _mm256_setzero_pd(); }
+        static HLM_SIMD_TARGET reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+        static HLM_SIMD_TARGET reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+        static HLM_SIMD_TARGET reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+        static HLM_SIMD_TARGET reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+        static HLM_SIMD_TARGET reg eq(reg a, reg b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+        static HLM_SIMD_TARGET reg blend(reg a, reg b, reg mask) { return _mm256_blendv_pd(a, b, mask); }
+        static HLM_SIMD_TARGET unsigned movemask(reg m) { return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_castpd_si256(m))); }
+        HLM_SIMD_REDUCTIONS(double, 4, store)
+    };
+
+#include "hlm_simd_kernels.inl"
+
+#undef HLM_SIMD_TARGET
+
+} // namespace avx2
+
+#undef HLM_SIMD_REDUCTIONS
+
+// Expands to the body of a dispatching kernel
+#define HLM_SIMD_DISPATCH(KERNEL, ...)                                       \
+    switch (active_isa()) {                                                  \
+    case ISA_AVX2: return avx2::KERNEL(__VA_ARGS__);                         \
+    case ISA_SSE2: return sse2::KERNEL(__VA_ARGS__);                         \
+    default:       return scalar::KERNEL(__VA_ARGS__);                       \
+    }
+
+#else
+
+#define HLM_SIMD_DISPATCH(KERNEL, ...) return scalar::KERNEL(__VA_ARGS__);
+
+#endif // HLM_SIMD_X86
+
+    /// @brief Dispatching kernels, T must satisfy is_accelerated<T>
+
+    template <typename T>
+    inline T sum(const T* first, const size_t& n)
+    {
+        static_assert(is_accelerated<T>::value, "HLM::simd : unsupported element type");
+        HLM_SIMD_DISPATCH(sum, first, n)
+    }
+
+    template <typename T>
+    inline T dot(const T* a, const T* b, const size_t& n)
+    {
+        static_assert(is_accelerated<T>::value, "HLM::simd : unsupported element type");
+        HLM_SIMD_DISPATCH(dot, a, b, n)
+    }
+
+    // n >= 1
+    template <typename T>
+    inline T min(const T* first, const size_t& n)
+    {
+        static_assert(is_accelerated<T>::value, "HLM::simd : unsupported element type");
+        HLM_SIMD_DISPATCH(min, first, n)
+    }
+
+    // n >= 1
+    template <typename T>
+    inline T max(const T* first, const size_t& n)
+    {
+        static_assert(is_accelerated<T>::value, "HLM::simd : unsupported element type");
+        HLM_SIMD_DISPATCH(max, first, n)
+    }
+
+    // Index of the first element equal to value, n if there is none
+    template <typename T>
+    inline size_t find(const T* first, const size_t& n, const T& value)
+    {
+        static_assert(is_accelerated<T>::value, "HLM::simd : unsupported element type");
+        HLM_SIMD_DISPATCH(find, first, n, value)
+    }
+
+    template <typename T>
+    inline void replace(T* first, const size_t& n, const T& old_value, const T& new_value)
+    {
+        static_assert(is_accelerated<T>::value, "HLM::simd : unsupported element type");
+        HLM_SIMD_DISPATCH(replace, first, n, old_value, new_value)
+    }
+
+#undef HLM_SIMD_DISPATCH
+
+} // namespace simd
+} // namespace HLM
+#endif
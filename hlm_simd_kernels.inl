@@ -0,0 +1,132 @@
+// Generic SIMD kernels, included once per instruction set by hlm_simd.hpp
+// Expects HLM_SIMD_TARGET (function attribute) and an Ops<T> table in the enclosing namespace :
+//   reg, lanes, load, store, set1, zero, add, mul, min, max, eq, movemask, blend, reduce_add/min/max
+// Caution : Not meant for external use
+
+template <typename T>
+HLM_SIMD_TARGET T sum(const T* first, const size_t& n)
+{
+    typedef Ops<T> V;
+    const size_t lanes = V::lanes;
+    typename V::reg acc0 = V::zero();
+    typename V::reg acc1 = V::zero();
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        acc0 = V::add(acc0, V::load(first + i));
+        acc1 = V::add(acc1, V::load(first + i + lanes));
+    }
+    for (; i + lanes <= n; i += lanes) {
+        acc0 = V::add(acc0, V::load(first + i));
+    }
+    T accum = V::reduce_add(V::add(acc0, acc1));
+    for (; i < n; ++i) {
+        accum = scalar::add(accum, first[i]);
+    }
+    return accum;
+}
+
+template <typename T>
+HLM_SIMD_TARGET T dot(const T* a, const T* b, const size_t& n)
+{
+    typedef Ops<T> V;
+    const size_t lanes = V::lanes;
+    typename V::reg acc0 = V::zero();
+    typename V::reg acc1 = V::zero();
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        acc0 = V::add(acc0, V::mul(V::load(a + i), V::load(b + i)));
+        acc1 = V::add(acc1, V::mul(V::load(a + i + lanes), V::load(b + i + lanes)));
+    }
+    for (; i + lanes <= n; i += lanes) {
+        acc0 = V::add(acc0, V::mul(V::load(a + i), V::load(b + i)));
+    }
+    T accum = V::reduce_add(V::add(acc0, acc1));
+    for (; i < n; ++i) {
+        accum = scalar::add(accum, scalar::mul(a[i], b[i]));
+    }
+    return accum;
+}
+
+// n >= 1
+template <typename T>
+HLM_SIMD_TARGET T min(const T* first, const size_t& n)
+{
+    typedef Ops<T> V;
+    const size_t lanes = V::lanes;
+    if (n < lanes) {
+        return scalar::min(first, n);
+    }
+    typename V::reg acc = V::load(first);
+    size_t i = lanes;
+    for (; i + lanes <= n; i += lanes) {
+        acc = V::min(acc, V::load(first + i));
+    }
+    T result = V::reduce_min(acc);
+    for (; i < n; ++i) {
+        result = (first[i] < result) ? first[i] : result;
+    }
+    return result;
+}
+
+// n >= 1
+template <typename T>
+HLM_SIMD_TARGET T max(const T* first, const size_t& n)
+{
+    typedef Ops<T> V;
+    const size_t lanes = V::lanes;
+    if (n < lanes) {
+        return scalar::max(first, n);
+    }
+    typename V::reg acc = V::load(first);
+    size_t i = lanes;
+    for (; i + lanes <= n; i += lanes) {
+        acc = V::max(acc, V::load(first + i));
+    }
+    T result = V::reduce_max(acc);
+    for (; i < n; ++i) {
+        result = (result < first[i]) ? first[i] : result;
+    }
+    return result;
+}
+
+// Index of the first element equal to value, n if there is none
+template <typename T>
+HLM_SIMD_TARGET size_t find(const T* first, const size_t& n, const T& value)
+{
+    typedef Ops<T> V;
+    const size_t lanes = V::lanes;
+    const typename V::reg needle = V::set1(value);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        const unsigned mask = V::movemask(V::eq(V::load(first + i), needle));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(mask)) / sizeof(T);
+        }
+    }
+    for (; i < n; ++i) {
+        if (first[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+// Masked replace : every element equal to old_value becomes new_value
+template <typename T>
+HLM_SIMD_TARGET void replace(T* first, const size_t& n, const T& old_value, const T& new_value)
+{
+    typedef Ops<T> V;
+    const size_t lanes = V::lanes;
+    const typename V::reg from = V::set1(old_value);
+    const typename V::reg to   = V::set1(new_value);
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        const typename V::reg x = V::load(first + i);
+        V::store(first + i, V::blend(x, to, V::eq(x, from)));
+    }
+    for (; i < n; ++i) {
+        if (first[i] == old_value) {
+            first[i] = new_value;
+        }
+    }
+}
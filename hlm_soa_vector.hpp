@@ -0,0 +1,919 @@
+#ifndef _HLM_SOA_VECTOR_HPP_
+#define _HLM_SOA_VECTOR_HPP_
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <functional>
+#include "hlm_config.hpp"
+#include "hlm_thread_policy.hpp"
+#include "hlm_leak_tracker.hpp"
+#include "hlm_simd.hpp"
+#include "hlm_memory_resource.hpp"
+#include "hlm_bounds.hpp"
+#include "hlm_instrument.hpp"
+#include "hlm_memory_registry.hpp"
+#ifdef HLM_OMP_PARALLEL
+#include <omp.h>
+#endif
+
+namespace HLM {
+
+/// @brief class HLM::BasicSoAVector
+/// Structure-of-arrays container for record types : SoAVector<float, float, int> stores the
+/// first, second and third field of every row in three separate contiguous columns,
+/// so a loop over two fields of a twelve-field record only pulls those two columns into the cache
+/// Handles share a refcounted Data block exactly like HLM::Vector (copies share, HLM_COPY deep
+/// copies, the block dies with its last handle), nothing hands out a reference that outlives it :
+/// operator[] returns a Row proxy which holds its own reference to the block
+/// Every column starts on a cache line, the column-wide broadcast / reduce / sum / min / max
+/// run over one raw aligned array (the SIMD kernels of hlm_simd.hpp where the field type has one)
+/// ThreadPolicy and BoundsPolicy as for HLM::Vector, SoAVector<Fields...> picks the defaults
+
+template <typename ThreadPolicy, typename BoundsPolicy, typename... Fields>
+class BasicSoAVector {
+    static_assert(sizeof...(Fields) != 0, "SoAVector : at least one field");
+
+public:
+    static constexpr size_t field_count = sizeof...(Fields);
+
+    template <size_t I>
+    using field_type = typename std::tuple_element<I, std::tuple<Fields...>>::type;
+
+    // One row, as pushed and as read back whole
+    typedef std::tuple<Fields...> value_type;
+
+    // Columns start on a cache line, or on the field's own alignment when it is larger
+    static constexpr size_t column_alignment = std::max({size_t(64), alignof(Fields)...});
+
+private:
+    // The byte hooks (HLM_INSTRUMENT_RESIZE, HLM_MEMORY_ACCOUNT) count sizeof(T) per element :
+    // here an element is one row, its bytes summed over the columns
+    struct RowBytes {
+        unsigned char bytes[(sizeof(Fields) + ...)];
+    };
+    typedef RowBytes T;
+
+    typedef std::index_sequence_for<Fields...> Columns;
+
+    /// @brief struct Data
+    // Control block of a SoAVector : refcount, UUID, size/capacity and one pointer per column
+    // All the columns share a single heap buffer : [ column 0 | pad | column 1 | pad | ... ]
+    // each padded to column_alignment, so growing reallocates once whatever the field count
+    // Caution : Not meant for external use
+    struct Data : public LeakTracker<Data>::Node {
+
+        void* buffer;                  // every column, nullptr while the capacity is 0
+        void* columns[sizeof...(Fields)];
+        size_t length;
+        size_t reserved;
+        size_t generation;             // bumped whenever the columns move
+        std::pmr::memory_resource* resource;   // block and column buffer source, nullptr : operator new
+#ifdef HLM_INSTRUMENT
+        HLM::instrument::BlockCounters counters;
+#endif
+        typename ThreadPolicy::counter_type count;
+
+        static Data* create(const size_t& capacity, std::pmr::memory_resource* resource = nullptr)
+        {
+            Data* data = allocate(capacity, resource);
+            HLM_MEMORY_CHECK(data);
+            return data;
+        }
+
+        // Deep copy of source into a new block sized to fit, the budget is checked once the
+        // columns are copied so that the shrink pass never runs in the middle of the copy
+        static Data* create(const Data& source, std::pmr::memory_resource* resource)
+        {
+            Data* data = allocate(source.length, resource);
+            try {
+                data->copy_columns(Columns(), source);
+            }
+            catch(...) {
+                destroy(data);
+                throw;
+            }
+            data->length = source.length;
+            HLM_INSTRUMENT_RESIZE(bytes_used, 0, source.length);
+            HLM_MEMORY_CHECK(data);
+            return data;
+        }
+
+        // create() without the budget check
+        static Data* allocate(const size_t& capacity, std::pmr::memory_resource* resource)
+        {
+            Data* data = new (allocate_bytes(resource, sizeof(Data), alignof(Data))) Data(resource);
+            try {
+                data->relocate(capacity);
+            }
+            catch(...) {
+                destroy(data);
+                throw;
+            }
+            return data;
+        }
+
+        // References held by row proxies
+        void pin()
+        {
+            HLM_INSTRUMENT_COUNT(this, refcount_increments);
+            ThreadPolicy::increment(count);
+        }
+        bool unpin()
+        {
+            HLM_INSTRUMENT_COUNT(this, refcount_decrements);
+            return ThreadPolicy::decrement(count);
+        }
+
+        static void destroy(Data* data)
+        {
+            data->truncate(0);
+            data->deallocate_buffer(data->buffer, data->reserved);
+            data->buffer = nullptr;
+            std::pmr::memory_resource* resource = data->resource;
+            data->~Data();
+            deallocate_bytes(resource, data, sizeof(Data), alignof(Data));
+        }
+
+        template <size_t I>
+        field_type<I>* column() const {
+            return static_cast<field_type<I>*>(columns[I]);
+        }
+
+        void reserve(const size_t& new_capacity)
+        {
+            if (new_capacity > reserved) {
+                relocate(new_capacity);
+            }
+        }
+
+        void push_back(const Fields&... values)
+        {
+            if (length < reserved) {
+                construct_row(Columns(), length, values...);
+                HLM_INSTRUMENT_RESIZE(bytes_used, 0, 1);
+                ++length;
+                return;
+            }
+            // a value may alias an element of this block, copy the row before the columns move
+            value_type row(values...);
+            relocate(grown_capacity(length + 1));
+            std::apply([this](Fields&... fields) { construct_row(Columns(), length, std::move(fields)...); }, row);
+            HLM_INSTRUMENT_RESIZE(bytes_used, 0, 1);
+            ++length;
+            HLM_MEMORY_CHECK(this);
+        }
+
+        void resize(const size_t& new_length)
+        {
+            if (new_length <= length) {
+                truncate(new_length);
+                return;
+            }
+            if (new_length > reserved) {
+                relocate(grown_capacity(new_length));
+            }
+            value_construct_rows(Columns(), new_length);
+            HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+            length = new_length;
+            HLM_MEMORY_CHECK(this);
+        }
+
+        void truncate(const size_t& new_length)
+        {
+            if (new_length < length) {
+                destroy_rows(Columns(), new_length, length);
+                HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+                length = new_length;
+            }
+        }
+
+        // Move the columns into a buffer of exactly length rows
+        void shrink_to_fit()
+        {
+            if (length != reserved) {
+                relocate(length);
+            }
+        }
+
+        // Memory registry (see hlm_memory_registry.hpp)
+        void describe(HLM::memory::BlockInfo& info) const
+        {
+            info.container    = "SoAVector";
+            info.element_type = typeid(value_type).name();
+            info.element_size = sizeof(T);
+            info.size         = length;
+            info.capacity     = reserved;
+            info.handles      = ThreadPolicy::load(count);
+            info.mapped       = false;
+        }
+
+        // Shared blocks (row proxies included) are left alone, their holders may be reading
+        size_t try_shrink()
+        {
+            if (ThreadPolicy::load(count) != 1 || length == reserved) {
+                return 0;
+            }
+            const size_t before = reserved;
+            shrink_to_fit();
+            return (before - reserved) * sizeof(T);
+        }
+
+    private:
+        explicit Data(std::pmr::memory_resource* resource)
+        : buffer(nullptr), length(0), reserved(0), generation(0), resource(resource), count(1)
+        {
+            for (size_t i = 0; i < field_count; ++i) {
+                columns[i] = nullptr;
+            }
+            LeakTracker<Data>::track(*this);
+            HLM_MEMORY_REGISTER(Data);
+            HLM_INSTRUMENT_COUNT(this, allocations);
+        }
+
+       ~Data()
+        {
+           LeakTracker<Data>::untrack(*this);
+           HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, 0);
+           HLM_MEMORY_ACCOUNT(reserved, 0);
+        }
+
+        // Byte offset of every column in a buffer of capacity rows, returns the buffer size
+        static size_t layout(const size_t& capacity, size_t (&offsets)[sizeof...(Fields)])
+        {
+            static constexpr size_t field_sizes[] = {sizeof(Fields)...};
+            size_t bytes = 0;
+            for (size_t i = 0; i < field_count; ++i) {
+                offsets[i] = bytes;
+                bytes += (capacity * field_sizes[i] + column_alignment - 1) / column_alignment * column_alignment;
+            }
+            return bytes;
+        }
+
+        // Move every column into a new buffer of new_capacity rows (>= length), 0 frees the buffer
+        void relocate(const size_t& new_capacity)
+        {
+            void* new_columns[sizeof...(Fields)] = {};
+            void* new_buffer = nullptr;
+            if (new_capacity != 0) {
+                size_t offsets[sizeof...(Fields)];
+                const size_t bytes = layout(new_capacity, offsets);
+                HLM_INSTRUMENT_COUNT(this, allocations);
+                new_buffer = allocate_bytes(resource, bytes, column_alignment);
+                for (size_t i = 0; i < field_count; ++i) {
+                    new_columns[i] = static_cast<char*>(new_buffer) + offsets[i];
+                }
+                try {
+                    move_columns(Columns(), new_columns);
+                }
+                catch(...) {
+                    deallocate_buffer(new_buffer, new_capacity);
+                    throw;
+                }
+            }
+            destroy_rows(Columns(), 0, length);
+            deallocate_buffer(buffer, reserved);
+            if (buffer != nullptr) {
+                HLM_INSTRUMENT_COUNT(this, reallocations);
+            }
+            HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, new_capacity);
+            HLM_MEMORY_ACCOUNT(reserved, new_capacity);
+            buffer = new_buffer;
+            for (size_t i = 0; i < field_count; ++i) {
+                columns[i] = new_columns[i];
+            }
+            reserved = new_capacity;
+            ++generation;
+        }
+
+        // Column by column, undoing the finished columns when one throws
+        template <size_t... I>
+        void move_columns(std::index_sequence<I...>, void* const (&to)[sizeof...(Fields)])
+        {
+            size_t done = 0;
+            try {
+                ((std::uninitialized_move_n(column<I>(), length, static_cast<field_type<I>*>(to[I])), ++done), ...);
+            }
+            catch(...) {
+                ((I < done ? (void)std::destroy_n(static_cast<field_type<I>*>(to[I]), length) : (void)0), ...);
+                throw;
+            }
+        }
+
+        template <size_t... I>
+        void copy_columns(std::index_sequence<I...>, const Data& source)
+        {
+            size_t done = 0;
+            try {
+                ((std::uninitialized_copy_n(source.template column<I>(), source.length, column<I>()), ++done), ...);
+            }
+            catch(...) {
+                ((I < done ? (void)std::destroy_n(column<I>(), source.length) : (void)0), ...);
+                throw;
+            }
+        }
+
+        template <size_t... I, typename... Values>
+        void construct_row(std::index_sequence<I...>, const size_t& position, Values&&... values)
+        {
+            size_t done = 0;
+            try {
+                ((new (column<I>() + position) field_type<I>(std::forward<Values>(values)), ++done), ...);
+            }
+            catch(...) {
+                ((I < done ? std::destroy_at(column<I>() + position) : (void)0), ...);
+                throw;
+            }
+        }
+
+        // Rows [length, new_length) of every column
+        template <size_t... I>
+        void value_construct_rows(std::index_sequence<I...>, const size_t& new_length)
+        {
+            size_t done = 0;
+            try {
+                ((std::uninitialized_value_construct_n(column<I>() + length, new_length - length), ++done), ...);
+            }
+            catch(...) {
+                ((I < done ? (void)std::destroy_n(column<I>() + length, new_length - length) : (void)0), ...);
+                throw;
+            }
+        }
+
+        template <size_t... I>
+        void destroy_rows(std::index_sequence<I...>, const size_t& first, const size_t& last)
+        {
+            ((void)std::destroy(column<I>() + first, column<I>() + last), ...);
+        }
+
+        size_t grown_capacity(const size_t& min_capacity) const
+        {
+            size_t doubled = reserved * 2;
+            return (doubled > min_capacity) ? doubled : min_capacity;
+        }
+
+        void deallocate_buffer(void* memory, const size_t& capacity)
+        {
+            if (memory != nullptr) {
+                size_t offsets[sizeof...(Fields)];
+                deallocate_bytes(resource, memory, layout(capacity, offsets), column_alignment);
+            }
+        }
+
+        // The block's memory resource if it has one, else plain operator new
+        static void* allocate_bytes(std::pmr::memory_resource* resource, const size_t& bytes, const size_t& alignment)
+        {
+            if (resource != nullptr) {
+                return resource->allocate(bytes, alignment);
+            }
+            if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return ::operator new(bytes, std::align_val_t(alignment));
+            }
+            return ::operator new(bytes);
+        }
+
+        static void deallocate_bytes(std::pmr::memory_resource* resource, void* memory, const size_t& bytes, const size_t& alignment)
+        {
+            if (resource != nullptr) {
+                resource->deallocate(memory, bytes, alignment);
+                return;
+            }
+            if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(memory, std::align_val_t(alignment));
+                return;
+            }
+            ::operator delete(memory);
+        }
+    };
+
+    /// @brief class RowProxy
+    // One row of a block : get<I>() reads field I through the column, the row converts to and
+    // (when not Const) assigns from value_type
+    // The proxy keeps the block alive like a handle, and reads the column pointers on every access,
+    // so it stays usable across growth. Meant for row-at-a-time code, hot loops belong to the
+    // column functions : taking a proxy costs a refcount increment and decrement
+    template <bool Const>
+    class RowProxy {
+    public:
+        template <size_t I>
+        using reference = typename std::conditional<Const, const field_type<I>&, field_type<I>&>::type;
+
+        RowProxy(Data* data, const size_t& index) : data_(data), index_(index)
+        {
+            data_->pin();
+        }
+
+        RowProxy(const RowProxy& other) : data_(other.data_), index_(other.index_)
+        {
+            data_->pin();
+        }
+
+        ~RowProxy()
+        {
+            if (data_->unpin()) {
+                Data::destroy(data_);
+            }
+        }
+
+        // Out-of-range rows are handled by the BoundsPolicy, column by column
+        template <size_t I>
+        reference<I> get() const {
+            return BoundsPolicy::at(data_->template column<I>(), data_->length, index_, DefaultValue<I>());
+        }
+
+        size_t index() const {
+            return index_;
+        }
+
+        operator value_type() const {
+            return read(Columns());
+        }
+
+        // Assigning a row writes the values, the proxy keeps pointing at the same row
+        const RowProxy& operator=(const value_type& values) const {
+            static_assert(!Const, "SoAVector : row of a const vector");
+            write(Columns(), values);
+            return *this;
+        }
+
+        const RowProxy& operator=(const RowProxy& other) const {
+            return (*this = static_cast<value_type>(other));
+        }
+
+    private:
+        template <size_t... I>
+        value_type read(std::index_sequence<I...>) const {
+            return value_type(get<I>()...);
+        }
+
+        template <size_t... I>
+        void write(std::index_sequence<I...>, const value_type& values) const {
+            ((get<I>() = std::get<I>(values)), ...);
+        }
+
+        Data*  data_;
+        size_t index_;
+    };
+
+    // Caution : Not meant for external use
+    Data* m_data_;
+
+    // Caution : Not meant for external use
+    // Adopt a freshly created block (refcount already 1)
+    explicit BasicSoAVector(Data* data) : m_data_(data) {}
+
+    // Release the data
+    void release_reference() {
+        if (m_data_ != nullptr) {
+            HLM_INSTRUMENT_COUNT(m_data_, refcount_decrements);
+            if (ThreadPolicy::decrement(m_data_->count)) {
+                Data::destroy(m_data_);
+            }
+        }
+        // release the data
+        m_data_ = nullptr;
+    }
+
+    // Protect operator new and operator delete
+    void* operator new(std::size_t);
+    void  operator delete(void*);
+
+    // Callables over the columns I... : void(field_type<I>&...)
+    template <typename Function, size_t... I>
+    using EnableIfColumnsCallable = typename std::enable_if<
+        (sizeof...(I) != 0) && std::is_invocable<Function&, field_type<I>&...>::value>::type;
+
+    template <size_t I, typename Function>
+    using EnableIfReduceCallable = typename std::enable_if<
+        std::is_invocable_r<field_type<I>, Function&, const field_type<I>&, const field_type<I>&>::value>::type;
+
+    // reduce<I>(std::plus) is routed to the SIMD sum
+    template <size_t I, typename Function>
+    using IsPlus = std::integral_constant<bool,
+        std::is_same<typename std::decay<Function>::type, std::plus<field_type<I>>>::value ||
+        std::is_same<typename std::decay<Function>::type, std::plus<>>::value>;
+
+public:
+
+    typedef RowProxy<false> Row;
+    typedef RowProxy<true>  ConstRow;
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////  Smart & Safety check functions //////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+    // check validity
+    bool is_valid() const
+    {
+         if (HLM_LIKELY(m_data_ != nullptr && ThreadPolicy::load(m_data_->count) != 0))
+         {
+            return true;
+         }
+         else
+         {
+          detail::throw_invalid_handle();
+         }
+    }
+
+    // Fallback of field I, returned where HLM::Vector returns DefaultValue()
+    template <size_t I>
+    static field_type<I>& DefaultValue()
+    {
+      static field_type<I> default_value;
+      return default_value;
+    }
+
+    size_t ref_count() const
+    {
+        return ThreadPolicy::load(m_data_->count);
+    }
+
+    size_t data_id() const
+    {
+        return m_data_->UUID;
+    }
+
+    // Number of live Data blocks of this type, merged across all threads
+    static size_t live_instances()
+    {
+        return LeakTracker<Data>::live_count();
+    }
+
+    // Counters of the block (see hlm_instrument.hpp), only the byte counters unless HLM_INSTRUMENT
+    HLM::instrument::Counters counters() const
+    {
+        HLM::instrument::Counters block;
+        if (is_valid()) {
+#ifdef HLM_INSTRUMENT
+            block = m_data_->counters.snapshot(m_data_->reserved * sizeof(T), m_data_->length * sizeof(T));
+#else
+            block[HLM::instrument::bytes_reserved] = static_cast<std::int64_t>(m_data_->reserved * sizeof(T));
+            block[HLM::instrument::bytes_used]     = static_cast<std::int64_t>(m_data_->length * sizeof(T));
+#endif
+        }
+        return block;
+    }
+
+    // Memory resource of the block, nullptr when it uses the global operator new
+    std::pmr::memory_resource* get_resource() const {
+        return (is_valid()) ? m_data_->resource : nullptr;
+    }
+
+///////////////////////////////////////////////////////////////////////////////////////
+///// Construction, from and to rows (std::vector<value_type>) ////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////
+
+    // Constructor
+    BasicSoAVector() : m_data_(Data::create(0)) {}
+
+    #define HLM_MOVE 1
+    #define HLM_COPY 0
+
+    // Transpose an array of rows into the columns
+    BasicSoAVector(const std::vector<value_type>& rows, std::pmr::memory_resource* resource = nullptr)
+    : m_data_(Data::create(rows.size(), resource))
+    {
+        for (size_t i = 0; i < rows.size(); ++i) {
+            push_back(rows[i]);
+        }
+    }
+
+    BasicSoAVector(const BasicSoAVector& other, const int& move_semantic = HLM_MOVE)
+    {
+         if (move_semantic == HLM_MOVE) {
+           m_data_ = other.m_data_;
+           HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+           ThreadPolicy::increment(m_data_->count);
+         }
+         else
+         {
+             HLM_INSTRUMENT_COUNT(other.m_data_, deep_copies);
+             m_data_ = Data::create(*other.m_data_, other.m_data_->resource);
+         }
+    }
+
+    // Take the block and the column buffer from a memory resource (see hlm_memory_resource.hpp)
+    // nullptr selects the global operator new, the resource must outlive the block
+    explicit BasicSoAVector(std::pmr::memory_resource* resource) : m_data_(Data::create(0, resource)) {}
+
+    // Deep copy into another resource
+    BasicSoAVector(const BasicSoAVector& other, std::pmr::memory_resource* resource)
+    : m_data_(Data::create(*other.m_data_, resource)) {
+        HLM_INSTRUMENT_COUNT(other.m_data_, deep_copies);
+    }
+
+    // Destructor
+    ~BasicSoAVector() {
+        release_reference();
+    }
+
+    const BasicSoAVector& operator=(const BasicSoAVector& other) {
+        if (m_data_ == other.m_data_) {
+            return *this;
+        }
+        release_reference();
+        m_data_ = other.m_data_;
+        HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+        ThreadPolicy::increment(m_data_->count);
+        return *this;
+    }
+
+    // Same block
+    bool operator==(const BasicSoAVector& other) const {
+        return (m_data_ == other.m_data_);
+    }
+
+    bool operator!=(const BasicSoAVector& other) const {
+        return !(m_data_ == other.m_data_);
+    }
+
+    // Back to an array of rows
+    operator std::vector<value_type>() const {
+        std::vector<value_type> rows;
+        if (is_valid()) {
+            HLM_INSTRUMENT_COUNT(m_data_, deep_copies);
+            rows.reserve(m_data_->length);
+            for (size_t i = 0; i < m_data_->length; ++i) {
+                rows.push_back(read_row(Columns(), i));
+            }
+        }
+        return rows;
+    }
+
+////////////////////////////////////////////////////////////////////////////////////////
+/////////// Rows
+////////////////////////////////////////////////////////////////////////////////////////
+
+    // Row proxy (allowing negative indices for reverse access)
+    Row operator[](const int& index) {
+        is_valid();
+        return Row(m_data_, wrap_index(index, m_data_->length));
+    }
+
+    Row operator[](const size_t& index) {
+        is_valid();
+        return Row(m_data_, index);
+    }
+
+    ConstRow operator[](const int& index) const {
+        is_valid();
+        return ConstRow(m_data_, wrap_index(index, m_data_->length));
+    }
+
+    ConstRow operator[](const size_t& index) const {
+        is_valid();
+        return ConstRow(m_data_, index);
+    }
+
+    // Field I of a row without a proxy, out-of-range indices are handled by the BoundsPolicy
+    template <size_t I>
+    field_type<I>& get(const size_t& index) {
+        if (!BoundsPolicy::validates_handle || is_valid()) {
+            HLM_INSTRUMENT_BOUNDS(m_data_, index);
+            return BoundsPolicy::at(m_data_->template column<I>(), m_data_->length, index, DefaultValue<I>());
+        }
+        return DefaultValue<I>();
+    }
+
+    template <size_t I>
+    const field_type<I>& get(const size_t& index) const {
+        if (!BoundsPolicy::validates_handle || is_valid()) {
+            HLM_INSTRUMENT_BOUNDS(m_data_, index);
+            return BoundsPolicy::at(static_cast<const field_type<I>*>(m_data_->template column<I>()), m_data_->length,
+                                    index, DefaultValue<I>());
+        }
+        return DefaultValue<I>();
+    }
+
+    // Never checked, whatever the BoundsPolicy
+    template <size_t I>
+    field_type<I>& fast_access(const size_t& index) {
+        return m_data_->template column<I>()[index];
+    }
+
+    // First element of column I (column_alignment aligned), valid until the next growth
+    template <size_t I>
+    field_type<I>* data() {
+        return (is_valid() && size()) ? m_data_->template column<I>() : &(DefaultValue<I>());
+    }
+
+    template <size_t I>
+    const field_type<I>* data() const {
+        return (is_valid() && size()) ? m_data_->template column<I>() : &(DefaultValue<I>());
+    }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+/////////// Wrapper functions around std::vector member functions
+/////////////////////////////////////////////////////////////////////////////////////////
+
+    // Get the size of the vector
+    size_t size() const {
+        return (is_valid()) ? m_data_->length : 0;
+    }
+
+    // Get the capacity of the vector
+    size_t capacity() const {
+        return (is_valid()) ? m_data_->reserved : 0;
+    }
+
+    // Grow every column to new_capacity rows at once
+    void reserve(const size_t& new_capacity) {
+        if (is_valid()) {
+            m_data_->reserve(new_capacity);
+        }
+    }
+
+    // Clear the vector
+    void clear() {
+        if (is_valid()) {
+            m_data_->truncate(0);
+        }
+    }
+
+    // Append one row, one value per field
+    void push_back(const Fields&... values) {
+        if (is_valid()) {
+            m_data_->push_back(values...);
+        }
+    }
+
+    void push_back(const value_type& row) {
+        if (is_valid()) {
+            std::apply([this](const Fields&... values) { m_data_->push_back(values...); }, row);
+        }
+    }
+
+    void emplace_back(const Fields&... values) {
+        push_back(values...);
+    }
+
+    // Remove the last row and return it, value_type() when empty
+    value_type pop_back() {
+        if (is_valid() && size()) {
+            value_type row = read_row(Columns(), m_data_->length - 1);
+            m_data_->truncate(m_data_->length - 1);
+            return row;
+        }
+        return value_type();
+    }
+
+    // resize the vector, new rows are value-initialised
+    void resize(const size_t& value = 0) {
+        if (is_valid()) {
+            m_data_->resize(value);
+        }
+    }
+
+    // Release the unused capacity of every column
+    void shrink_to_fit() {
+        if (is_valid()) {
+            m_data_->shrink_to_fit();
+        }
+    }
+
+    // Swap external vector with internal
+    void swap(BasicSoAVector& other)
+    {
+        Data* temp = m_data_;
+        m_data_ = other.m_data_;
+        other.m_data_ = temp;
+    }
+
+////////////////////////////////////////////////////////////////////
+////////// Column Functions  //////////////////////////////////////
+///////////////////////////////////////////////////////////////////
+
+    // Broadcast a value to field I of every row
+    template <size_t I>
+    void broadcast(const field_type<I>& value) {
+        if (is_valid()) {
+            std::fill_n(m_data_->template column<I>(), m_data_->length, value);
+        }
+    }
+
+    // Broadcast void(field_type<I>&...) over the columns I... row by row : soa.broadcast<0, 3>(
+    // [](float& x, const float& vx) { x += vx; }) streams columns 0 and 3 only
+    // The call is inlined into one loop over the raw columns, which the compiler can vectorise
+    template <size_t... I, typename Function, typename = EnableIfColumnsCallable<Function, I...>>
+    void broadcast(Function&& function) {
+        if (is_valid()) {
+            broadcast_columns(function, m_data_->length, m_data_->template column<I>()...);
+        }
+    }
+
+    // Reduce field I with any callable T(const T& acc, const T& element), DefaultValue<I>() when empty
+    template <size_t I, typename Function, typename = EnableIfReduceCallable<I, Function>>
+    field_type<I> reduce(Function&& function) const {
+        if (is_valid() && m_data_->length != 0) {
+            if constexpr (IsPlus<I, Function>::value && HLM::simd::is_accelerated<field_type<I>>::value) {
+                return sum<I>();
+            }
+            const field_type<I>* elements = m_data_->template column<I>();
+            const size_t n = m_data_->length;
+            field_type<I> accum = elements[0];
+            for (size_t i = 1; i < n; ++i) {
+                accum = function(accum, elements[i]);
+            }
+            return accum;
+        }
+        return DefaultValue<I>();
+    }
+
+    // Arithmetic shortcuts over column I, SIMD kernels for int32_t, int64_t, float and double
+    // Sum of field I, field_type<I>() when empty
+    template <size_t I>
+    field_type<I> sum() const {
+        if (!is_valid() || m_data_->length == 0) {
+            return field_type<I>();
+        }
+        const field_type<I>* elements = m_data_->template column<I>();
+        if constexpr (HLM::simd::is_accelerated<field_type<I>>::value) {
+            return HLM::simd::sum(elements, m_data_->length);
+        }
+        else {
+            field_type<I> accum = elements[0];
+            for (size_t i = 1; i < m_data_->length; ++i) {
+                accum = accum + elements[i];
+            }
+            return accum;
+        }
+    }
+
+    // Smallest field I, DefaultValue<I>() when empty
+    template <size_t I>
+    field_type<I> min() const {
+        if (!is_valid() || m_data_->length == 0) {
+            return DefaultValue<I>();
+        }
+        const field_type<I>* elements = m_data_->template column<I>();
+        if constexpr (HLM::simd::is_accelerated<field_type<I>>::value) {
+            return HLM::simd::min(elements, m_data_->length);
+        }
+        else {
+            return *std::min_element(elements, elements + m_data_->length);
+        }
+    }
+
+    // Largest field I, DefaultValue<I>() when empty
+    template <size_t I>
+    field_type<I> max() const {
+        if (!is_valid() || m_data_->length == 0) {
+            return DefaultValue<I>();
+        }
+        const field_type<I>* elements = m_data_->template column<I>();
+        if constexpr (HLM::simd::is_accelerated<field_type<I>>::value) {
+            return HLM::simd::max(elements, m_data_->length);
+        }
+        else {
+            return *std::max_element(elements, elements + m_data_->length);
+        }
+    }
+
+    // Row of the first field I equal to value, size() when absent
+    template <size_t I>
+    size_t find(const field_type<I>& value) const {
+        if (!is_valid()) {
+            return 0;
+        }
+        const field_type<I>* elements = m_data_->template column<I>();
+        if constexpr (HLM::simd::is_accelerated<field_type<I>>::value) {
+            return HLM::simd::find(elements, m_data_->length, value);
+        }
+        else {
+            return static_cast<size_t>(std::find(elements, elements + m_data_->length, value) - elements);
+        }
+    }
+
+private:
+    template <size_t... I>
+    value_type read_row(std::index_sequence<I...>, const size_t& index) const {
+        return value_type(m_data_->template column<I>()[index]...);
+    }
+
+    template <typename Function, typename... Column>
+    static void broadcast_columns(Function& function, const size_t& n, Column* HLM_RESTRICT... columns) {
+        #ifdef HLM_OMP_PARALLEL
+        #pragma omp parallel for schedule(static)
+        #endif
+        for (size_t i = 0; i < n; ++i)
+        {
+            function(columns[i]...);
+        }
+    }
+
+/////////////////////////////////////////////////////////////////////////////
+}; // class BasicSoAVector End
+
+/// @brief SoAVector
+// Single-threaded refcount, BoundsWarn, as HLM::Vector<T>
+template <typename... Fields>
+using SoAVector = BasicSoAVector<SingleThreaded, BoundsWarn, Fields...>;
+
+} // namespace HLM
+#endif
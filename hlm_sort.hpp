@@ -0,0 +1,316 @@
+#ifndef _HLM_SORT_HPP_
+#define _HLM_SORT_HPP_
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+#include "hlm_parallel.hpp"
+
+// Sort engine behind sort() and filter() :
+//   arithmetic keys ordered by std::less   LSD radix sort, one 8-bit digit per pass, passes where
+//                                          every key has the same digit are skipped
+//   anything else                          std::sort, or with several workers : std::sort on one
+//                                          run per worker then rounds of merge-path parallel merges
+// unique() compacts a sorted range, in parallel through a scratch buffer
+// HLM_PARALLEL uses the workers of hlm_parallel.hpp, HLM_SERIAL stays on the calling thread
+// Radix order for floating point keys : -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN
+
+// Below this many elements std::sort beats the radix passes
+#ifndef HLM_RADIX_THRESHOLD
+#define HLM_RADIX_THRESHOLD 2048
+#endif
+
+namespace HLM {
+namespace sorting {
+
+    /// @brief is_radix_key
+    // Types the radix sort handles : integers (not bool), float and double
+    template <typename T>
+    struct is_radix_key : std::integral_constant<bool,
+        (std::is_integral<T>::value && !std::is_same<T, bool>::value) ||
+        std::is_same<T, float>::value || std::is_same<T, double>::value> {};
+
+    // std::less<T> and std::less<> are the orders the radix sort reproduces
+    template <typename T, typename Compare>
+    struct is_natural_order : std::integral_constant<bool,
+        std::is_same<typename std::decay<Compare>::type, std::less<T>>::value ||
+        std::is_same<typename std::decay<Compare>::type, std::less<>>::value> {};
+
+namespace detail {
+
+    template <size_t Bytes> struct unsigned_of;
+    template <> struct unsigned_of<1> { typedef std::uint8_t  type; };
+    template <> struct unsigned_of<2> { typedef std::uint16_t type; };
+    template <> struct unsigned_of<4> { typedef std::uint32_t type; };
+    template <> struct unsigned_of<8> { typedef std::uint64_t type; };
+
+    // Unsigned key whose natural order is the order of value
+    // signed integers : flip the sign bit
+    // floating point  : flip every bit of negatives, only the sign bit of positives
+    template <typename T>
+    inline typename unsigned_of<sizeof(T)>::type radix_key(const T& value)
+    {
+        typedef typename unsigned_of<sizeof(T)>::type Key;
+        const Key sign = static_cast<Key>(static_cast<Key>(1) << (sizeof(T) * 8 - 1));
+        Key bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        if constexpr (std::is_floating_point<T>::value) {
+            return (bits & sign) ? static_cast<Key>(~bits) : static_cast<Key>(bits | sign);
+        }
+        else if constexpr (std::is_signed<T>::value) {
+            return static_cast<Key>(bits ^ sign);
+        }
+        else {
+            return bits;
+        }
+    }
+
+    // Move [from, from + n) to to, split over workers
+    template <typename T>
+    void move_range(T* from, const size_t& n, T* to, const size_t& workers)
+    {
+        parallel::run(workers, [&](const size_t& k) {
+            size_t begin, end;
+            parallel::static_range(n, workers, k, begin, end);
+            std::move(from + begin, from + end, to + begin);
+        });
+    }
+
+    // Number of elements of a taken by the first diagonal elements of merge(a, b)
+    // Ties go to a, so the merge stays stable
+    template <typename T, typename Compare>
+    size_t merge_path(const T* a, const size_t& na, const T* b, const size_t& nb, const size_t& diagonal, Compare& cmp)
+    {
+        size_t low  = (diagonal > nb) ? diagonal - nb : 0;
+        size_t high = (diagonal < na) ? diagonal : na;
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2;
+            if (cmp(b[diagonal - middle - 1], a[middle])) {
+                high = middle;
+            }
+            else {
+                low = middle + 1;
+            }
+        }
+        return low;
+    }
+
+    // Merge a and b into out, the output is cut into equal slices, one per worker
+    // The slices are all located before merging starts : a search must not compare moved-from elements
+    template <typename T, typename Compare>
+    void parallel_merge(T* a, const size_t& na, T* b, const size_t& nb, T* out, Compare& cmp, const size_t& workers)
+    {
+        const size_t n = na + nb;
+        size_t parts = parallel::worker_count(n);
+        if (parts > workers) {
+            parts = workers;
+        }
+        std::vector<size_t> diagonals(parts + 1);
+        std::vector<size_t> splits(parts + 1);
+        for (size_t k = 0; k < parts; ++k) {
+            size_t end;
+            parallel::static_range(n, parts, k, diagonals[k], end);
+            splits[k] = merge_path(a, na, b, nb, diagonals[k], cmp);
+        }
+        diagonals[parts] = n;
+        splits[parts]    = na;
+        parallel::run(parts, [&](const size_t& k) {
+            const size_t begin = diagonals[k];
+            const size_t end   = diagonals[k + 1];
+            std::merge(std::make_move_iterator(a + splits[k]), std::make_move_iterator(a + splits[k + 1]),
+                       std::make_move_iterator(b + (begin - splits[k])), std::make_move_iterator(b + (end - splits[k + 1])),
+                       out + begin, cmp);
+        });
+    }
+
+} // namespace detail
+
+    /// @brief radix_sort
+    // LSD radix sort of [first, first + n), T must satisfy is_radix_key
+    // Every pass histograms the digit per worker, turns the histograms into per-worker
+    // write offsets (digit-major, so the scatter is stable) and scatters into the scratch buffer
+    template <typename T>
+    void radix_sort(T* first, const size_t& n, const bool& parallel_mode)
+    {
+        static_assert(is_radix_key<T>::value, "HLM::sorting::radix_sort : integer, float or double keys only");
+        if (n < 2) {
+            return;
+        }
+        const size_t workers = parallel_mode ? parallel::worker_count(n) : 1;
+        std::unique_ptr<T[]> scratch(new T[n]);
+        std::vector<size_t> counts(workers * 256);
+        T* from = first;
+        T* to   = scratch.get();
+
+        for (size_t shift = 0; shift < sizeof(T) * 8; shift += 8) {
+            parallel::run(workers, [&](const size_t& k) {
+                size_t begin, end;
+                parallel::static_range(n, workers, k, begin, end);
+                size_t* histogram = counts.data() + k * 256;
+                std::fill(histogram, histogram + 256, static_cast<size_t>(0));
+                for (size_t i = begin; i < end; ++i) {
+                    ++histogram[(detail::radix_key(from[i]) >> shift) & 0xFF];
+                }
+            });
+
+            size_t offset = 0;
+            bool   single_digit = false;
+            for (size_t digit = 0; digit < 256 && !single_digit; ++digit) {
+                size_t total = 0;
+                for (size_t k = 0; k < workers; ++k) {
+                    total += counts[k * 256 + digit];
+                }
+                single_digit = (total == n);
+            }
+            if (single_digit) {
+                continue;   // every key has the same digit, the pass would be a copy
+            }
+            for (size_t digit = 0; digit < 256; ++digit) {
+                for (size_t k = 0; k < workers; ++k) {
+                    const size_t count = counts[k * 256 + digit];
+                    counts[k * 256 + digit] = offset;
+                    offset += count;
+                }
+            }
+
+            parallel::run(workers, [&](const size_t& k) {
+                size_t begin, end;
+                parallel::static_range(n, workers, k, begin, end);
+                size_t* next = counts.data() + k * 256;
+                for (size_t i = begin; i < end; ++i) {
+                    to[next[(detail::radix_key(from[i]) >> shift) & 0xFF]++] = from[i];
+                }
+            });
+            std::swap(from, to);
+        }
+
+        if (from != first) {
+            detail::move_range(from, n, first, workers);
+        }
+    }
+
+    /// @brief merge_sort
+    // std::sort with one worker, otherwise std::sort on one run per worker
+    // and rounds of pairwise merges (each merge split over all workers), T must be default constructible
+    template <typename T, typename Compare>
+    void merge_sort(T* first, const size_t& n, Compare cmp, const bool& parallel_mode)
+    {
+        const size_t workers = parallel_mode ? parallel::worker_count(n) : 1;
+        if (workers <= 1) {
+            std::sort(first, first + n, cmp);
+            return;
+        }
+
+        std::vector<size_t> bounds(workers + 1);
+        for (size_t k = 0; k < workers; ++k) {
+            size_t end;
+            parallel::static_range(n, workers, k, bounds[k], end);
+        }
+        bounds[workers] = n;
+        parallel::run(workers, [&](const size_t& k) {
+            std::sort(first + bounds[k], first + bounds[k + 1], cmp);
+        });
+
+        std::vector<T> scratch(n);
+        T* from = first;
+        T* to   = scratch.data();
+        while (bounds.size() > 2) {
+            std::vector<size_t> merged;
+            merged.reserve(bounds.size() / 2 + 2);
+            size_t run = 0;
+            const size_t runs = bounds.size() - 1;
+            for (; run + 1 < runs; run += 2) {
+                merged.push_back(bounds[run]);
+                detail::parallel_merge(from + bounds[run], bounds[run + 1] - bounds[run],
+                                       from + bounds[run + 1], bounds[run + 2] - bounds[run + 1],
+                                       to + bounds[run], cmp, workers);
+            }
+            if (run < runs) {   // odd run out, carried over
+                merged.push_back(bounds[run]);
+                std::move(from + bounds[run], from + bounds[run + 1], to + bounds[run]);
+            }
+            merged.push_back(n);
+            bounds.swap(merged);
+            std::swap(from, to);
+        }
+
+        if (from != first) {
+            detail::move_range(from, n, first, workers);
+        }
+    }
+
+    /// @brief sort
+    // Radix sort for arithmetic keys in natural order, merge_sort otherwise
+    template <typename T, typename Compare>
+    void sort(T* first, const size_t& n, Compare cmp, const bool& parallel_mode)
+    {
+        if constexpr (is_radix_key<T>::value && is_natural_order<T, Compare>::value) {
+            if (n >= HLM_RADIX_THRESHOLD) {
+                radix_sort(first, n, parallel_mode);
+                return;
+            }
+        }
+        merge_sort(first, n, cmp, parallel_mode);
+    }
+
+    /// @brief unique
+    // std::unique for a sorted range, returns the new length (elements past it are moved-from)
+    // In parallel : every worker counts the run heads of its block, the counts give each block
+    // its output offset, heads are moved to a scratch buffer and back
+    // A block decides on its first element before anything moves, so no worker reads another's block
+    // once moving started
+    template <typename T>
+    size_t unique(T* first, const size_t& n, const bool& parallel_mode)
+    {
+        const size_t workers = parallel_mode ? parallel::worker_count(n) : 1;
+        if (workers <= 1) {
+            return static_cast<size_t>(std::unique(first, first + n) - first);
+        }
+
+        std::vector<size_t> offsets(workers + 1, 0);
+        std::vector<char>   head_kept(workers, 0);
+        parallel::run(workers, [&](const size_t& k) {
+            size_t begin, end;
+            parallel::static_range(n, workers, k, begin, end);
+            head_kept[k] = (begin == 0 || !(first[begin] == first[begin - 1])) ? 1 : 0;
+            size_t kept = head_kept[k];
+            for (size_t i = begin + 1; i < end; ++i) {
+                kept += !(first[i] == first[i - 1]) ? 1 : 0;
+            }
+            offsets[k + 1] = kept;
+        });
+        for (size_t k = 0; k < workers; ++k) {
+            offsets[k + 1] += offsets[k];
+        }
+
+        const size_t length = offsets[workers];
+        std::vector<T> scratch(length);
+        parallel::run(workers, [&](const size_t& k) {
+            size_t begin, end;
+            parallel::static_range(n, workers, k, begin, end);
+            size_t out = offsets[k];
+            bool keep_previous = (head_kept[k] != 0);
+            // element i - 1 moves only after being compared with element i
+            for (size_t i = begin + 1; i < end; ++i) {
+                const bool keep = !(first[i] == first[i - 1]);
+                if (keep_previous) {
+                    scratch[out++] = std::move(first[i - 1]);
+                }
+                keep_previous = keep;
+            }
+            if (keep_previous) {
+                scratch[out++] = std::move(first[end - 1]);
+            }
+        });
+        detail::move_range(scratch.data(), length, first, workers);
+        return length;
+    }
+
+} // namespace sorting
+} // namespace HLM
+#endif
@@ -0,0 +1,46 @@
+#ifndef _HLM_THREAD_POLICY_HPP_
+#define _HLM_THREAD_POLICY_HPP_
+#include <atomic>
+#include <cstddef>
+#include "hlm_config.hpp"
+
+namespace HLM {
+
+/// @brief Thread-safety policies for the refcount of a Data block
+/// A policy provides the counter type plus increment / decrement / load
+/// decrement() returns true when the last reference has been dropped
+
+/// @brief struct SingleThreaded
+// Plain integer refcount, handles must not be shared across threads
+struct SingleThreaded {
+    typedef size_t counter_type;
+
+    static void increment(counter_type& count) { ++count; }
+
+    static bool decrement(counter_type& count) { return (--count == 0); }
+
+    static size_t load(const counter_type& count) { return count; }
+};
+
+/// @brief struct MultiThreaded
+// Atomic refcount with the usual shared_ptr orderings :
+// Copies only need a relaxed increment (the copier already holds a reference)
+// The decrement releases this thread's writes and the last owner acquires them before destroying
+struct MultiThreaded {
+    typedef std::atomic<size_t> counter_type;
+
+    static void increment(counter_type& count) { count.fetch_add(1, std::memory_order_relaxed); }
+
+    static bool decrement(counter_type& count) {
+        if (count.fetch_sub(1, HLM_DECREMENT_ORDER) == 1) {
+            HLM_ACQUIRE_FENCE();
+            return true;
+        }
+        return false;
+    }
+
+    static size_t load(const counter_type& count) { return count.load(std::memory_order_acquire); }
+};
+
+} // namespace HLM
+#endif
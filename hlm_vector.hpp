@@ -4,6 +4,26 @@
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <functional>
+#include "hlm_thread_policy.hpp"
+#include "hlm_leak_tracker.hpp"
+#include "hlm_simd.hpp"
+#include "hlm_expr.hpp"
+#include "hlm_memory_resource.hpp"
+#include "hlm_bounds.hpp"
+#include "hlm_vector_view.hpp"
+#include "hlm_iterator.hpp"
+#include "hlm_serialize.hpp"
+#include "hlm_parallel.hpp"
+#include "hlm_sort.hpp"
+#include "hlm_hash.hpp"
+#include "hlm_instrument.hpp"
+#include "hlm_memory_registry.hpp"
 #ifdef HLM_OMP_PARALLEL
 #include <omp.h>
 #endif
@@ -28,115 +48,411 @@ public:
 /// @brief class HLM::Vector
 /// A safe vector container to prevent dangling references or pointers
 /// Never exposes the data pointer or reference outside 
-
-template <typename T>
+/// ThreadPolicy selects the refcount implementation (SingleThreaded by default,
+/// use Vector<T, MultiThreaded> to share handles across threads)
+/// InlineCapacity is the minimum number of elements stored inside the control block itself :
+/// up to that size a vector costs a single allocation, elements spill to the heap only on overflow
+/// BoundsPolicy decides what operator[] does with an out-of-range index (see hlm_bounds.hpp),
+/// BoundsUnchecked compiles it down to a raw array access
+
+template <typename T, typename ThreadPolicy = SingleThreaded, size_t InlineCapacity = 0, typename BoundsPolicy = BoundsWarn>
 class Vector {
 private:
     /// @brief struct Data
-    // Data struct is a simple way to create & manage the vector container
+    // Data struct is the control block of a Vector
+    // The refcount, UUID, size/capacity and the element storage share a single allocation
+    // (make_shared style) :  [ Data | padding | T[inline_reserved] ]
+    // The tail holds at least InlineCapacity elements (more when created from a larger range)
+    // Elements only spill to a separate heap buffer once they outgrow the inline tail
     // Vector Will never expose the pointer or even a reference externaly 
     // Caution : Not meant for external use
-    struct Data {
+    // The UUID and the live-instance bookkeeping come from the LeakTracker node
+    struct Data : public LeakTracker<Data>::Node {
+
+        T* elements;               // inline tail or spilled heap buffer
+        size_t length;
+        size_t reserved;
+        size_t inline_reserved;    // slots in the tail of this allocation
+        size_t alignment;          // of the elements : alignof(T), or more from an AlignedResource
+        size_t generation;         // bumped whenever elements moves, checked iterators compare it
+        std::pmr::memory_resource* resource;   // block and element buffer source, nullptr : operator new
+#ifdef HLM_INSTRUMENT
+        HLM::instrument::BlockCounters counters;
+#endif
+        typename ThreadPolicy::counter_type count;
 
-         static size_t& GlobalCount()
-         {
-           static size_t global_count = 0;
-           return global_count;
-         }
+        // Allocate a block whose inline tail can hold 'capacity' elements
+        // The element alignment of resource is looked up here, when a resource is attached :
+        // blocks made from an existing one take its resource and alignment through 'like'
+        static Data* create(const size_t& capacity, std::pmr::memory_resource* resource = nullptr)
+        {
+            Data* data = allocate(capacity, resource, detail::element_alignment(resource, alignof(T)));
+            HLM_MEMORY_CHECK(data);
+            return data;
+        }
+
+        static Data* create(const size_t& capacity, const Data& like)
+        {
+            Data* data = allocate(capacity, like.resource, like.alignment);
+            HLM_MEMORY_CHECK(data);
+            return data;
+        }
+
+        // Copy of [first, first + n)
+        static Data* create(const T* first, const size_t& n, std::pmr::memory_resource* resource = nullptr)
+        {
+            return copy_in(allocate(n, resource, detail::element_alignment(resource, alignof(T))), first, n);
+        }
+
+        static Data* create(const T* first, const size_t& n, const Data& like)
+        {
+            return copy_in(allocate(n, like.resource, like.alignment), first, n);
+        }
+
+        // create() without the budget check
+        static Data* allocate(const size_t& capacity, std::pmr::memory_resource* resource, const size_t& alignment)
+        {
+            const size_t slots = (capacity > InlineCapacity) ? capacity : InlineCapacity;
+            void* raw = allocate_bytes(resource, tail_offset(alignment) + slots * sizeof(T), block_alignment(alignment));
+            return new (raw) Data(slots, resource, alignment);
+        }
 
-        static void checkGlobalCount() {
-            if (GlobalCount() != 0) {
-                // Throw an exception or print an error message
-                throw std::runtime_error("Not all instances have been deleted");
+        // Fill the empty block data with [first, first + n), the budget is checked once the elements
+        // are copied : the shrink pass may reallocate the block first points into
+        static Data* copy_in(Data* data, const T* first, const size_t& n)
+        {
+            try {
+                std::uninitialized_copy_n(first, n, data->elements);
+            }
+            catch(...) {
+                destroy(data);
+                throw;
             }
+            data->length = n;
+            HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+            HLM_MEMORY_CHECK(data);
+            return data;
         }
 
-        std::vector<T>* vector;
-        size_t count;
-        size_t UUID;
+        // References held by checked iterators (see hlm_iterator.hpp)
+        void pin()
+        {
+            HLM_INSTRUMENT_COUNT(this, refcount_increments);
+            ThreadPolicy::increment(count);
+        }
+        bool unpin()
+        {
+            HLM_INSTRUMENT_COUNT(this, refcount_decrements);
+            return ThreadPolicy::decrement(count);
+        }
 
-        Data() : vector(new std::vector<T>()), count(1) 
-        { 
-            std::atexit(Data::checkGlobalCount);
-            UUID = (++GlobalCount());
-            #ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-            std::cout << "Created New Vector with ID = " << GlobalCount() << "\n"; 
-            #endif
+        static void destroy(Data* data)
+        {
+            std::destroy_n(data->elements, data->length);
+            if (!data->is_inline()) {
+                data->deallocate_elements(data->elements, data->reserved);
+            }
+            std::pmr::memory_resource* resource = data->resource;
+            const size_t alignment = data->alignment;
+            const size_t bytes = tail_offset(alignment) + data->inline_reserved * sizeof(T);
+            data->~Data();
+            deallocate_bytes(resource, data, bytes, block_alignment(alignment));
         }
-        
-        Data(const std::vector<T>& externalVector) : vector(new std::vector<T>(std::move(externalVector))), count(1)  
-        { 
-            std::atexit(Data::checkGlobalCount);
-            UUID = (++GlobalCount());
-            #ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-            std::cout << "Created New Vector with ID = " << GlobalCount() << "\n"; 
-            #endif
+
+        T* inline_storage() {
+            return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + tail_offset(alignment));
+        }
+
+        bool is_inline() const {
+            return elements == const_cast<Data*>(this)->inline_storage();
+        }
+
+        // Spill (or re-spill) the elements into a heap buffer of new_capacity
+        void reserve(const size_t& new_capacity)
+        {
+            if (new_capacity <= reserved) {
+                return;
+            }
+            T* buffer = allocate_elements(new_capacity);
+            try {
+                std::uninitialized_move_n(elements, length, buffer);
+            }
+            catch(...) {
+                deallocate_elements(buffer, new_capacity);
+                throw;
+            }
+            adopt(buffer, new_capacity);
+        }
+
+        void push_back(const T& value)
+        {
+            if (length < reserved) {
+                new (elements + length) T(value);
+                HLM_INSTRUMENT_RESIZE(bytes_used, 0, 1);
+                ++length;
+                return;
+            }
+            // value may alias an element, so construct it in the new buffer before moving the rest
+            const size_t new_capacity = grown_capacity(length + 1);
+            T* buffer = allocate_elements(new_capacity);
+            try {
+                new (buffer + length) T(value);
+            }
+            catch(...) {
+                deallocate_elements(buffer, new_capacity);
+                throw;
+            }
+            std::uninitialized_move_n(elements, length, buffer);
+            adopt(buffer, new_capacity);
+            HLM_INSTRUMENT_RESIZE(bytes_used, 0, 1);
+            ++length;
+            HLM_MEMORY_CHECK(this);
+        }
+
+        void append(const T* first, const size_t& n)
+        {
+            if (length + n <= reserved) {
+                std::uninitialized_copy_n(first, n, elements + length);
+                HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+                length += n;
+                return;
+            }
+            // first may point into our own storage, so copy before releasing the old buffer
+            const size_t new_capacity = grown_capacity(length + n);
+            T* buffer = allocate_elements(new_capacity);
+            try {
+                std::uninitialized_copy_n(first, n, buffer + length);
+            }
+            catch(...) {
+                deallocate_elements(buffer, new_capacity);
+                throw;
+            }
+            std::uninitialized_move_n(elements, length, buffer);
+            adopt(buffer, new_capacity);
+            HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+            length += n;
+            HLM_MEMORY_CHECK(this);
+        }
+
+        // Replaces the whole content, so it invalidates iterators even without a reallocation
+        void assign(const T* first, const size_t& n)
+        {
+            truncate(0);
+            reserve(n);
+            std::uninitialized_copy_n(first, n, elements);
+            HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+            length = n;
+            ++generation;
+            HLM_MEMORY_CHECK(this);
+        }
+
+        // parallel : the new elements are value-initialised by the parallel workers (first touch)
+        void resize(const size_t& new_length, const bool& parallel = HLM_SERIAL)
+        {
+            if (new_length <= length) {
+                truncate(new_length);
+                return;
+            }
+            if (new_length > reserved) {
+                reserve(grown_capacity(new_length));
+            }
+            if (parallel) {
+                HLM::parallel::uninitialized_value_construct(elements + length, new_length - length);
+            }
+            else {
+                std::uninitialized_value_construct_n(elements + length, new_length - length);
+            }
+            HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+            length = new_length;
+            HLM_MEMORY_CHECK(this);
+        }
+
+        // The new elements are left uninitialised, T is trivially default constructible
+        void resize_uninitialized(const size_t& new_length)
+        {
+            if (new_length <= length) {
+                truncate(new_length);
+                return;
+            }
+            if (new_length > reserved) {
+                reserve(grown_capacity(new_length));
+            }
+            HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+            length = new_length;
+            HLM_MEMORY_CHECK(this);
+        }
+
+        void truncate(const size_t& new_length)
+        {
+            if (new_length < length) {
+                std::destroy_n(elements + new_length, length - new_length);
+                HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+                length = new_length;
+            }
+        }
+
+        // Move spilled elements back into the inline tail or into an exactly sized buffer
+        void shrink_to_fit()
+        {
+            if (is_inline() || length == reserved) {
+                return;
+            }
+            if (length <= inline_reserved) {
+                std::uninitialized_move_n(elements, length, inline_storage());
+                std::destroy_n(elements, length);
+                deallocate_elements(elements, reserved);
+                HLM_INSTRUMENT_COUNT(this, reallocations);
+                HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, inline_reserved);
+                HLM_MEMORY_ACCOUNT(reserved, inline_reserved);
+                elements = inline_storage();
+                reserved = inline_reserved;
+                ++generation;
+                return;
+            }
+            T* buffer = allocate_elements(length);
+            std::uninitialized_move_n(elements, length, buffer);
+            adopt(buffer, length);
+        }
+
+        // Memory registry (see hlm_memory_registry.hpp)
+        void describe(HLM::memory::BlockInfo& info) const
+        {
+            info.container    = "Vector";
+            info.element_type = typeid(T).name();
+            info.element_size = sizeof(T);
+            info.size         = length;
+            info.capacity     = reserved;
+            info.handles      = ThreadPolicy::load(count);
+            info.mapped       = false;
         }
 
-        Data(const std::vector<T>&& externalVector) : vector(new std::vector<T>(std::move(externalVector))), count(1)  
+        // Shared blocks (checked iterators included) are left alone, their holders may be reading
+        size_t try_shrink()
+        {
+            if (ThreadPolicy::load(count) != 1 || is_inline() || length == reserved) {
+                return 0;
+            }
+            const size_t before = reserved;
+            shrink_to_fit();
+            return (before - reserved) * sizeof(T);
+        }
+
+    private:
+        Data(const size_t& capacity, std::pmr::memory_resource* resource, const size_t& alignment) 
+        : elements(nullptr), length(0), reserved(capacity), inline_reserved(capacity), alignment(alignment), generation(0), resource(resource), count(1)
         { 
-            std::atexit(Data::checkGlobalCount);
-            UUID = (++GlobalCount());
-            #ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-            std::cout << "Created New Vector with ID = " << GlobalCount() << "\n"; 
-            #endif
+            elements = inline_storage();
+            LeakTracker<Data>::track(*this);
+            HLM_MEMORY_REGISTER(Data);
+            HLM_INSTRUMENT_COUNT(this, allocations);
+            HLM_INSTRUMENT_RESIZE(bytes_reserved, 0, capacity);
+            HLM_MEMORY_ACCOUNT(0, capacity);
         }
- 
-        // Delete the std::vector<T>* vector 
+
        ~Data() 
         {
-           --GlobalCount();
-           #ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-           std::cout << "Deleted Vector with ID =  " << UUID << "\n";            
-           #endif
-           delete vector;
+           LeakTracker<Data>::untrack(*this);
+           HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, 0);
+           HLM_MEMORY_ACCOUNT(reserved, 0);
+           HLM_INSTRUMENT_RESIZE(bytes_used, length, 0);
         }
-    };
 
-    // Caution : Not meant for external use
-    Data* m_data_;
+        // Destroy the moved-from elements and take ownership of buffer
+        void adopt(T* buffer, const size_t& new_capacity)
+        {
+            std::destroy_n(elements, length);
+            if (!is_inline()) {
+                deallocate_elements(elements, reserved);
+            }
+            HLM_INSTRUMENT_COUNT(this, reallocations);
+            HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, new_capacity);
+            HLM_MEMORY_ACCOUNT(reserved, new_capacity);
+            elements = buffer;
+            reserved = new_capacity;
+            ++generation;
+        }
 
-    // Caution : Not meant for external use
-    void delete_vector() {
-        try {
-        if (m_data_ != nullptr) {
-         {
-             if(m_data_->vector != nullptr)
-             delete m_data_->vector;
-         }
-         m_data_->vector = nullptr;
+        size_t grown_capacity(const size_t& min_capacity) const
+        {
+            size_t doubled = reserved * 2;
+            return (doubled > min_capacity) ? doubled : min_capacity;
         }
+
+        // The block's memory resource if it has one, else plain operator new unless T is over-aligned
+        static void* allocate_bytes(std::pmr::memory_resource* resource, const size_t& bytes, const size_t& alignment)
+        {
+            if (resource != nullptr) {
+                return resource->allocate(bytes, alignment);
+            }
+            if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return ::operator new(bytes, std::align_val_t(alignment));
+            }
+            return ::operator new(bytes);
         }
-        catch(...)
+
+        static void deallocate_bytes(std::pmr::memory_resource* resource, void* memory, const size_t& bytes, const size_t& alignment)
         {
-            throw std::runtime_error("Deleting and invalid std::vector Pointer");
+            if (resource != nullptr) {
+                resource->deallocate(memory, bytes, alignment);
+                return;
+            }
+            if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(memory, std::align_val_t(alignment));
+                return;
+            }
+            ::operator delete(memory);
         }
-    }
 
-    // Caution : Not meant for external use
-    // Only meant for reassigning new vector
-    // Delete the data and move new copy
-    void force_delete_data() {
-        if (m_data_ != nullptr) {
-         {
-             delete m_data_;
-         }
-         m_data_ = nullptr;
+        T* allocate_elements(const size_t& n)
+        {
+            HLM_INSTRUMENT_COUNT(this, allocations);
+            return static_cast<T*>(allocate_bytes(resource, n * sizeof(T), alignment));
+        }
+
+        void deallocate_elements(T* buffer, const size_t& n)
+        {
+            deallocate_bytes(resource, buffer, n * sizeof(T), alignment);
+        }
+
+        static constexpr size_t block_alignment(const size_t& alignment) {
+            return alignment > alignof(Data) ? alignment : alignof(Data);
         }
-    }
+
+        // The inline tail starts on the element alignment
+        static constexpr size_t tail_offset(const size_t& alignment) {
+            return (sizeof(Data) + alignment - 1) / alignment * alignment;
+        }
+    };
+
+    // Caution : Not meant for external use
+    Data* m_data_;
+
+    // Caution : Not meant for external use
+    // Adopt a freshly created block (refcount already 1)
+    explicit Vector(Data* data) : m_data_(data) {}
 
     // Release the data
     void release_reference() {
         if (m_data_ != nullptr) {
-            --m_data_->count;
-            if (m_data_->count == 0) {
-                delete m_data_;
+            HLM_INSTRUMENT_COUNT(m_data_, refcount_decrements);
+            if (ThreadPolicy::decrement(m_data_->count)) {
+                Data::destroy(m_data_);
             }
         }
         // release the data
         m_data_ = nullptr;
     }
 
+    // Index of the first element equal to value, length when absent
+    size_t find_index(const T& value) const {
+        if constexpr (HLM::simd::is_accelerated<T>::value) {
+            return HLM::simd::find(m_data_->elements, m_data_->length, value);
+        }
+        else {
+            return static_cast<size_t>(std::find(m_data_->elements, m_data_->elements + m_data_->length, value) - m_data_->elements);
+        }
+    }
+
    // Protect address-of operator with no implementation
     T* operator&();
 
@@ -156,7 +472,36 @@ private:
     void* operator new(std::size_t);
     void  operator delete(void*);
 
+    // Keep the callable overloads away from values and from the virtual functor classes
+    template <typename Function>
+    using EnableIfBroadcastCallable = typename std::enable_if<
+        !std::is_base_of<BroadcastFunctor<T>, typename std::decay<Function>::type>::value &&
+        std::is_invocable<Function&, T&>::value>::type;
+
+    template <typename Function>
+    using EnableIfReduceCallable = typename std::enable_if<
+        !std::is_base_of<ReduceFunctor<T>, typename std::decay<Function>::type>::value &&
+        std::is_invocable_r<T, Function&, const T&, const T&>::value>::type;
+
+    template <typename Compare>
+    using EnableIfCompare = typename std::enable_if<
+        std::is_invocable_r<bool, Compare&, const T&, const T&>::value>::type;
+
+    // reduce(std::plus) is routed to the SIMD sum
+    template <typename Function>
+    using IsPlus = std::integral_constant<bool,
+        std::is_same<typename std::decay<Function>::type, std::plus<T>>::value ||
+        std::is_same<typename std::decay<Function>::type, std::plus<>>::value>;
+
 public:    
+
+    typedef T        value_type;
+    typedef ReduceFunctor<T> reduce_functor_type;
+    typedef BroadcastFunctor<T> broadcast_functor_type;
+    // Raw pointers in release builds, generation-checked in debug builds (see hlm_iterator.hpp)
+    typedef typename IteratorSelect<Data, T>::type       iterator;
+    typedef typename IteratorSelect<Data, const T>::type const_iterator;
+
 ////////////////////////////////////////////////////////////////////////////////////////
 ////////  Smart & Safety check functions //////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////  
@@ -164,14 +509,13 @@ public:
     // check validity
     bool is_valid() const
     {
-         if(m_data_ != nullptr && m_data_->vector != nullptr  && (m_data_->count) != 0 ) 
+         if(HLM_LIKELY(m_data_ != nullptr && ThreadPolicy::load(m_data_->count) != 0)) 
          {
             return true;
          }
          else
          {
-          throw std::runtime_error("Accessing null or released vector"); 
-          return false;  
+          detail::throw_invalid_handle(); 
          }
     }
     
@@ -183,12 +527,12 @@ public:
 
     size_t ref_count()
     {
-        return m_data_->count;
+        return ThreadPolicy::load(m_data_->count);
     }
     
     const size_t ref_count() const
     {
-        return m_data_->count;
+        return ThreadPolicy::load(m_data_->count);
     }
 
     size_t data_id()
@@ -201,56 +545,89 @@ public:
         return m_data_->UUID;
     }
 
+    // Number of live Data blocks of this type, merged across all threads
+    static size_t live_instances()
+    {
+        return LeakTracker<Data>::live_count();
+    }
+
+    // Counters of the block (see hlm_instrument.hpp), only the byte counters unless HLM_INSTRUMENT
+    HLM::instrument::Counters counters() const
+    {
+        HLM::instrument::Counters block;
+        if (is_valid()) {
+#ifdef HLM_INSTRUMENT
+            block = m_data_->counters.snapshot(m_data_->reserved * sizeof(T), m_data_->length * sizeof(T));
+#else
+            block[HLM::instrument::bytes_reserved] = static_cast<std::int64_t>(m_data_->reserved * sizeof(T));
+            block[HLM::instrument::bytes_used]     = static_cast<std::int64_t>(m_data_->length * sizeof(T));
+#endif
+        }
+        return block;
+    }
+
+    // Memory resource of the block, nullptr when it uses the global operator new
+    std::pmr::memory_resource* get_resource() const {
+        return (is_valid()) ? m_data_->resource : nullptr;
+    }
+
 ///////////////////////////////////////////////////////////////////////////////////////
 ///// Fancy Ways to Construct vector data with interoperability with std::vector //////
 ////  Default Preference for Move Semantic !!!!!!! ////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////
 
     // Constructor
-    Vector() : m_data_(new Data()) {}
+    Vector() : m_data_(Data::create(0)) {}
 
     #define HLM_MOVE 1
     #define HLM_COPY 0
 
-    Vector(const std::vector<T>&& externalVector, const bool& move_semantic = HLM_MOVE)
+    // The elements are copied straight into the inline tail of a single block
+    Vector(const std::vector<T>&& externalVector, const int& move_semantic = HLM_MOVE)
+    : m_data_(Data::create(externalVector.data(), externalVector.size()))
     {
-        if(move_semantic == HLM_COPY)
-        {
-           m_data_ = new Data(externalVector);
-        }
-        else
-        {
-            m_data_ = (new Data());
-           *(m_data_->vector) = std::move(externalVector);      
-        }
+        (void)move_semantic;
     }
 
-    Vector(const std::vector<T>& externalVector, const bool& move_semantic = HLM_MOVE)   
+    Vector(const std::vector<T>& externalVector, const int& move_semantic = HLM_MOVE)   
+    : m_data_(Data::create(externalVector.data(), externalVector.size()))
     {
-        if(move_semantic == HLM_COPY)
-        {
-           m_data_ = new Data(externalVector);
-        }
-        else
-        {
-            m_data_ = (new Data());
-           *(m_data_->vector) = std::move(externalVector);      
-        }
+        (void)move_semantic;
     }
 
-    Vector(const Vector<T>& externalVector, const bool& move_semantic = HLM_MOVE) 
+    Vector(const Vector& externalVector, const int& move_semantic = HLM_MOVE) 
     {
-         std::atexit(Data::checkGlobalCount);
          if(move_semantic == HLM_MOVE) {
            this->m_data_ = externalVector.m_data_;
-           ++(this->m_data_->count); 
+           HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+           ThreadPolicy::increment(this->m_data_->count); 
          }
          else 
          {
-             m_data_ = (new Data((*externalVector.m_data_->vector)));
+             HLM_INSTRUMENT_COUNT(externalVector.m_data_, deep_copies);
+             m_data_ = Data::create(externalVector.m_data_->elements, externalVector.m_data_->length, *externalVector.m_data_);
          }      
     }            
 
+    // Evaluate an element-wise expression, see hlm_expr.hpp
+    template <typename E>
+    explicit Vector(const HLM::Expression<E>& expression) : m_data_(Data::create(0)) {
+        HLM::assign(*this, expression);
+    }
+
+    // Take the block and the element buffer from a memory resource (see hlm_memory_resource.hpp)
+    // nullptr selects the global operator new, the resource must outlive the block
+    explicit Vector(std::pmr::memory_resource* resource) : m_data_(Data::create(0, resource)) {}
+
+    Vector(const std::vector<T>& externalVector, std::pmr::memory_resource* resource)
+    : m_data_(Data::create(externalVector.data(), externalVector.size(), resource)) {}
+
+    // Deep copy into another resource
+    Vector(const Vector& externalVector, std::pmr::memory_resource* resource)
+    : m_data_(Data::create(externalVector.m_data_->elements, externalVector.m_data_->length, resource)) {
+        HLM_INSTRUMENT_COUNT(externalVector.m_data_, deep_copies);
+    }
+
     // Destructor
     ~Vector() {
         release_reference();
@@ -262,27 +639,36 @@ public:
 
     // Assignment operator from external vector using move semantics
     const Vector& operator=(const std::vector<T>&& externalVector) {
-        delete_vector();
-        (m_data_->vector) = new std::vector<T>(std::move(externalVector));
+        m_data_->assign(externalVector.data(), externalVector.size());
         return *this;
     }
 
     const Vector& operator=(const std::vector<T>& externalVector) {
-        delete_vector();
-        (m_data_->vector) = new std::vector<T>(std::move(externalVector));
+        m_data_->assign(externalVector.data(), externalVector.size());
         return *this;
     } 
 
-    const Vector& operator=(const Vector<T>& externalVector) {
+    const Vector& operator=(const Vector& externalVector) {
+        if (m_data_ == externalVector.m_data_) {
+            return *this;
+        }
         release_reference();
         this->m_data_ = externalVector.m_data_;
-        ++(this->m_data_->count); 
+        HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+        ThreadPolicy::increment(this->m_data_->count); 
         return *this;
     } 
 
+    // Evaluate an element-wise expression into this block in one fused loop (resized to fit)
+    template <typename E>
+    const Vector& operator=(const HLM::Expression<E>& expression) {
+        HLM::assign(*this, expression);
+        return *this;
+    }
+
     // Equality operator
     bool operator==(const Vector& other) const {
-        return (m_data_ == other.data_);
+        return (m_data_ == other.m_data_);
     }
 
     // Inequality operator
@@ -292,25 +678,24 @@ public:
 
     // Overload + operator for concatenation
     Vector operator+(const Vector& other) const {
-        Vector result;
-
-        if (is_valid()) {
-            // Copy the elements of the current vector
-            result.m_data_->vector = new std::vector<T>(*m_data_->vector);
-
-            // Concatenate the elements of the other vector
-            if (other.is_valid()) {
-                result.m_data_->vector->insert(result.m_data_->vector->end(), other.m_data_->vector->begin(), other.m_data_->vector->end());
-            }
+        if (is_valid() && other.is_valid()) {
+            HLM_INSTRUMENT_COUNT(m_data_, deep_copies);
+            HLM_INSTRUMENT_COUNT(other.m_data_, deep_copies);
+            // One allocation sized for both halves
+            Vector result(Data::create(m_data_->length + other.m_data_->length, *m_data_));
+            result.m_data_->append(m_data_->elements, m_data_->length);
+            result.m_data_->append(other.m_data_->elements, other.m_data_->length);
+            return result;
         }
-        return result;
+        return Vector();
     }
 
     // Conversion operator to std::vector<T>
     // Pass a Copy to external vec if the data is valid 
     operator std::vector<T>() const {
         if (is_valid()) {
-            return *(m_data_->vector);
+            HLM_INSTRUMENT_COUNT(m_data_, deep_copies);
+            return std::vector<T>(m_data_->elements, m_data_->elements + m_data_->length);
         }
         else 
         {
@@ -319,22 +704,19 @@ public:
         }
     }
 
+    // Never checked, whatever the BoundsPolicy
     T& fast_access(const size_t& index)
     {
-        return (*m_data_->vector)[static_cast<size_t>(index)]; 
+        return m_data_->elements[index]; 
     }
 
     // Access element at index (allowing negative indices for reverse access)
+    // Out-of-range indices are handled by the BoundsPolicy
     T& operator[](const int& index) {
-        if (is_valid()) {
-            if (index >= 0 && static_cast<size_t>(index) < m_data_->vector->size()) {
-                return (*m_data_->vector)[static_cast<size_t>(index)];
-            } else if (index < 0 && static_cast<size_t>(-index) <= m_data_->vector->size()) {
-                return (*m_data_->vector)[m_data_->vector->size() - static_cast<size_t>(-index)];
-            } else {
-                std::cerr << "\nWarning : Index " << index << " out of bound. Returning default value \n";
-                return back(); 
-            }
+        if (!BoundsPolicy::validates_handle || is_valid()) {
+            const size_t position = wrap_index(index, m_data_->length);
+            HLM_INSTRUMENT_BOUNDS(m_data_, position);
+            return BoundsPolicy::at(m_data_->elements, m_data_->length, position, DefaultValue());
         }
         else 
         {
@@ -344,14 +726,9 @@ public:
 
     // Access element at index
     T& operator[](const size_t& index) {
-        if (is_valid()) {
-            if ((index) < m_data_->vector->size()) {
-                return (*m_data_->vector)[(index)];
-            }
-            else {
-                std::cerr << "\nWarning : Index " << index << " out of bound. Returning back or default value \n";
-                return back(); 
-            }
+        if (!BoundsPolicy::validates_handle || is_valid()) {
+            HLM_INSTRUMENT_BOUNDS(m_data_, index);
+            return BoundsPolicy::at(m_data_->elements, m_data_->length, index, DefaultValue());
         }
         else 
         {
@@ -361,15 +738,22 @@ public:
 
     // Access element at index (allowing negative indices for reverse access)
     const T& operator[](const int index) const {
-        if (is_valid()) {
-            if (index >= 0 && static_cast<size_t>(index) < m_data_->vector->size()) {
-                return (*m_data_->vector)[static_cast<size_t>(index)];
-            } else if (index < 0 && static_cast<size_t>(-index) <= m_data_->vector->size()) {
-                return (*m_data_->vector)[m_data_->vector->size() - static_cast<size_t>(-index)];
-            } else {
-                std::cerr << "\nWarning : Index " << index << " out of bound. Returning default value \n";
-                return back(); 
-            }
+        if (!BoundsPolicy::validates_handle || is_valid()) {
+            const size_t position = wrap_index(index, m_data_->length);
+            HLM_INSTRUMENT_BOUNDS(m_data_, position);
+            return BoundsPolicy::at(static_cast<const T*>(m_data_->elements), m_data_->length, position, DefaultValue());
+        }
+        else 
+        {
+           return DefaultValue();
+        }
+    }
+
+    // Access element at index
+    const T& operator[](const size_t& index) const {
+        if (!BoundsPolicy::validates_handle || is_valid()) {
+            HLM_INSTRUMENT_BOUNDS(m_data_, index);
+            return BoundsPolicy::at(static_cast<const T*>(m_data_->elements), m_data_->length, index, DefaultValue());
         }
         else 
         {
@@ -382,76 +766,77 @@ public:
 
     // Get data ie... the first element
     const T* data() const {
-        return (is_valid() && size()) ? &(*(m_data_->vector))[0]  : &(DefaultValue());
+        return (is_valid() && size()) ? m_data_->elements : &(DefaultValue());
     }
 
     // Get data ie... the first element
     T* data() {
-        return (is_valid() && size()) ? &(*(m_data_->vector))[0]  : &(DefaultValue());
+        return (is_valid() && size()) ? m_data_->elements : &(DefaultValue());
     }
 
     // Get the last element of the vector
     T& back() {
-        return (is_valid() && size()) ? m_data_->vector->back()  : DefaultValue();
+        return (is_valid() && size()) ? m_data_->elements[m_data_->length - 1] : DefaultValue();
     }
 
     // Get the last element of the vector
     const T& back() const {
-        return (is_valid() && size()) ? m_data_->vector->back()  : DefaultValue();
+        return (is_valid() && size()) ? m_data_->elements[m_data_->length - 1] : DefaultValue();
     }
 
     // Get the front element of the vector
     T& front() {
-        return (is_valid() && size()) ? m_data_->vector->front() : DefaultValue();
+        return (is_valid() && size()) ? m_data_->elements[0] : DefaultValue();
     }
 
     // Get const version of the const element of the vector
     const T& front() const {
-        return (is_valid() && size()) ? m_data_->vector->front() : DefaultValue();
+        return (is_valid() && size()) ? m_data_->elements[0] : DefaultValue();
     }
 
     // Get the size of the vector
     size_t size() const {
-        return (is_valid()) ? m_data_->vector->size() : 0;
+        return (is_valid()) ? m_data_->length : 0;
     }
 
     // Get the capacity of the vector
     size_t capacity() const {
-        return (is_valid()) ? m_data_->vector->capacity() : 0;
+        return (is_valid()) ? m_data_->reserved : 0;
     }
 
     // Get the max_capacity of the vector
     size_t max_capacity() const {
-        return (is_valid()) ? m_data_->vector->max_capacity() : 0;
+        return (is_valid()) ? std::numeric_limits<size_t>::max() / sizeof(T) : 0;
     }    
 
     // Clear the vector
     void clear() {
         if (is_valid()) {
-            m_data_->vector->clear();
+            m_data_->truncate(0);
         }   
     }
 
     // Push an element to the back of the vector
     void push_back(const T& value) {
         if (is_valid()) {
-            m_data_->vector->push_back(value);
+            m_data_->push_back(value);
         }
     }
 
     // emplace back an element to the back of the vector
     void emplace_back(const T& value) {
         if (is_valid()) {
-            m_data_->vector->emplace_back(value);
+            m_data_->push_back(value);
         }
        
     }
 
     // Pop back an element to the back of the vector
     T pop_back(const T& value) {
-        if (is_valid()) {
-            T poped_data = m_data_->vector->back();
-            m_data_->vector->pop_back(value);
+        (void)value;
+        if (is_valid() && size()) {
+            T poped_data = m_data_->elements[m_data_->length - 1];
+            m_data_->truncate(m_data_->length - 1);
             return poped_data;
         }
         else
@@ -464,57 +849,81 @@ public:
     // emplace an element to the front of the vector
     void emplace(const T& value) {
         if (is_valid()) {
-            m_data_->vector->emplace(value);
+            T copy(value);
+            m_data_->push_back(copy);
+            std::rotate(m_data_->elements, m_data_->elements + m_data_->length - 1, m_data_->elements + m_data_->length);
         }
     }
 
     // resize the vector
     void resize(const size_t& value = 0) {
         if (is_valid()) {
-            m_data_->vector->resize(value);
+            m_data_->resize(value);
+        }
+    }
+
+    // resize() with the new elements value-initialised by the parallel workers, each over the block
+    // the parallel loops give it (see HLM::parallel::for_blocks) : on NUMA machines the pages are
+    // first touched, hence placed, where they are used. Serial without a parallel backend
+    void resize_parallel(const size_t& value) {
+        if (is_valid()) {
+            m_data_->resize(value, HLM_PARALLEL);
         }
     }
 
-    // shrink_to_fit the vector
-    void shrink_to_fit(const T& value) {
+    // resize() leaving the new elements uninitialised (indeterminate until written) and their pages
+    // untouched, e.g. for a parallel broadcast to first-touch them
+    void resize_uninitialized(const size_t& value) {
+        static_assert(std::is_trivially_default_constructible<T>::value && std::is_trivially_destructible<T>::value,
+                      "resize_uninitialized : T must be trivially default constructible and destructible");
         if (is_valid()) {
-            m_data_->vector->shrink_to_fit(value);
+            m_data_->resize_uninitialized(value);
         }
     }
 
+    // Release the unused capacity : back into the inline tail, or into an exactly sized buffer
+    void shrink_to_fit() {
+        if (is_valid()) {
+            m_data_->shrink_to_fit();
+        }
+    }
+
+    // The value is ignored, kept for existing callers
+    [[deprecated("use shrink_to_fit()")]] void shrink_to_fit(const T& value) {
+        (void)value;
+        shrink_to_fit();
+    }
+
     // insert an element to the front of the vector
     void insert(const Vector& other) const {
           if (other.is_valid() && this->is_valid()) {
-                this->m_data_->vector->insert(this->m_data_->vector->end(), other.m_data_->vector->begin(), other.m_data_->vector->end());
+                this->m_data_->append(other.m_data_->elements, other.m_data_->length);
             }
     }
 
     // Begin iterator of the vector
-    typename std::vector<T>::iterator begin() {    // Swap external vector with internal
-        if (is_valid()) {
-            return m_data_->vector->begin();
-        }
+    iterator begin() {
+        return (is_valid()) ? IteratorSelect<Data, T>::make(m_data_, 0) : iterator();
     }
 
     // Const Begin iterator of the vector
-    typename std::vector<T>::const_iterator begin() const {
-        if (is_valid()) {
-            return m_data_->vector->begin();
-        }
+    const_iterator begin() const {
+        return (is_valid()) ? IteratorSelect<Data, const T>::make(m_data_, 0) : const_iterator();
     }
 
     // End iterator of the vector
-    typename std::vector<T>::iterator end() {
-        if (is_valid()) {
-            return m_data_->vector->end();
-        }
+    iterator end() {
+        return (is_valid()) ? IteratorSelect<Data, T>::make(m_data_, m_data_->length) : iterator();
     }
 
     // Const End iterator of the vector
-    typename std::vector<T>::const_iterator end() const {
-        if (is_valid()) {
-            return m_data_->vector->end();
-        }
+    const_iterator end() const {
+        return (is_valid()) ? IteratorSelect<Data, const T>::make(m_data_, m_data_->length) : const_iterator();
+    }
+
+    // Zero-copy view of [offset, offset + length) sharing this block, see hlm_vector_view.hpp
+    VectorView<Vector, BoundsPolicy> slice(const size_t& offset, const size_t& length = static_cast<size_t>(-1)) const {
+        return VectorView<Vector, BoundsPolicy>(*this, offset, length);
     }
 
 ////////////////////////////////////////////////////////////////////
@@ -522,21 +931,49 @@ public:
 ///////////////////////////////////////////////////////////////////
 
     // Broadcast a value to all elements in the vector
-    void broadcast(const T& value) {
+    // Serial by default, HLM_PARALLEL splits large vectors over the parallel workers, block by block
+    // like resize_parallel
+    void broadcast(const T& value, const bool& parallel = HLM_SERIAL) {
         if (is_valid()) {
-            m_data_->vector->assign(size(), value);
+            if (parallel) {
+                // value may be one of the elements
+                const T copy(value);
+                HLM::parallel::fill(m_data_->elements, m_data_->length, copy);
+            }
+            else {
+                std::fill_n(m_data_->elements, m_data_->length, value);
+            }
         }
     }
 
      // Broadcast a functor to all elements in the vector
     void broadcast(BroadcastFunctor<T>& functor) {
         if (is_valid()) {
+            T* elements = m_data_->elements;
+            const size_t n = m_data_->length;
             #ifdef HLM_OMP_PARALLEL
             #pragma omp parallel for schedule(dynamic , 8)
             #endif
-            for (size_t i = 0; i < size(); ++i) 
+            for (size_t i = 0; i < n; ++i) 
+            { 
+                functor(elements[i]);
+            }
+        }
+    }
+
+    // Broadcast any callable void(T&) (lambda, function object) : no virtual dispatch,
+    // the call is inlined into a tight loop over the raw buffer
+    template <typename Function, typename = EnableIfBroadcastCallable<Function>>
+    void broadcast(Function&& function) {
+        if (is_valid()) {
+            T* elements = m_data_->elements;
+            const size_t n = m_data_->length;
+            #ifdef HLM_OMP_PARALLEL
+            #pragma omp parallel for schedule(static)
+            #endif
+            for (size_t i = 0; i < n; ++i) 
             { 
-                functor((*(m_data_->vector))[i]);
+                function(elements[i]);
             }
         }
     }
@@ -544,52 +981,54 @@ public:
     // Replace elements in the vector equal to oldVal with a new value
     void replace_with(const T& oldVal, const T& newVal) {
         if (is_valid()) {
-            std::replace(m_data_->vector->begin(), m_data_->vector->end(), oldVal, newVal);
+            if constexpr (HLM::simd::is_accelerated<T>::value) {
+                HLM::simd::replace(m_data_->elements, m_data_->length, oldVal, newVal);
+            }
+            else {
+                std::replace(m_data_->elements, m_data_->elements + m_data_->length, oldVal, newVal);
+            }
         }
     }
 
     // Find the iterator to the first occurrence of a value
-    typename std::vector<T>::iterator find_iter(const T& value) {
+    iterator find_iter(const T& value) {
         if (is_valid()) {
-            return (std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
+            return IteratorSelect<Data, T>::make(m_data_, find_index(value));
         }
         else
         {
-            return m_data_->vector->end();
+            return end();
         }
     }
 
     // Find the iterator to the first occurrence of a value
-    typename std::vector<T>::const_iterator find_iter(const T& value) const {
+    const_iterator find_iter(const T& value) const {
         if (is_valid()) {
-            return (std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
+            return IteratorSelect<Data, const T>::make(m_data_, find_index(value));
         }
         else
         {
-            return m_data_->vector->end();
+            return end();
         }
     }
 
     // Find the value by ref to the first occurrence of a value
+    // Returns DefaultValue() when the value is not present
     T& find(const T& value) {
         if (is_valid()) {
-            return *(std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
-        }
-        else
-        {
-            return *(m_data_->vector->end());
+            const size_t index = find_index(value);
+            return (index != m_data_->length) ? m_data_->elements[index] : DefaultValue();
         }
+        return DefaultValue();
     }
 
     // Find the value by const ref to the first occurrence of a value
     const T& find(const T& value) const {
         if (is_valid()) {
-            return *(std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
+            const size_t index = find_index(value);
+            return (index != m_data_->length) ? m_data_->elements[index] : DefaultValue();
         }
-        else
-        {
-            return *(m_data_->vector->end());
-        }        
+        return DefaultValue();
     }
 
     // Reduce the vector using a functor
@@ -610,41 +1049,144 @@ public:
         }
     }
 
-    // Filter the vector to remove duplicates
-    void filter() {
+    // Reduce with any callable T(const T& acc, const T& element), inlined like broadcast
+    template <typename Function, typename = EnableIfReduceCallable<Function>>
+    T reduce(Function&& function) const {
+        if (is_valid() && m_data_->length != 0) {
+            if constexpr (IsPlus<Function>::value && HLM::simd::is_accelerated<T>::value) {
+                return sum();
+            }
+            const T* elements = m_data_->elements;
+            const size_t n = m_data_->length;
+            T accum = elements[0];
+
+            for (size_t i = 1; i < n; ++i) 
+            {
+                accum = function(accum, elements[i]);
+            }
+            return accum;
+        }
+        else
+        {
+          return DefaultValue();
+        }
+    }
+
+    // Arithmetic shortcuts, SIMD kernels for int32_t, int64_t, float and double (see hlm_simd.hpp)
+    // Sum of the elements, T() when empty
+    T sum() const {
+        if (!is_valid() || m_data_->length == 0) {
+            return T();
+        }
+        if constexpr (HLM::simd::is_accelerated<T>::value) {
+            return HLM::simd::sum(m_data_->elements, m_data_->length);
+        }
+        else {
+            const T* elements = m_data_->elements;
+            T accum = elements[0];
+            for (size_t i = 1; i < m_data_->length; ++i) {
+                accum = accum + elements[i];
+            }
+            return accum;
+        }
+    }
+
+    // Smallest element, DefaultValue() when empty
+    T min() const {
+        if (!is_valid() || m_data_->length == 0) {
+            return DefaultValue();
+        }
+        if constexpr (HLM::simd::is_accelerated<T>::value) {
+            return HLM::simd::min(m_data_->elements, m_data_->length);
+        }
+        else {
+            return *std::min_element(m_data_->elements, m_data_->elements + m_data_->length);
+        }
+    }
+
+    // Largest element, DefaultValue() when empty
+    T max() const {
+        if (!is_valid() || m_data_->length == 0) {
+            return DefaultValue();
+        }
+        if constexpr (HLM::simd::is_accelerated<T>::value) {
+            return HLM::simd::max(m_data_->elements, m_data_->length);
+        }
+        else {
+            return *std::max_element(m_data_->elements, m_data_->elements + m_data_->length);
+        }
+    }
+
+    // Sum of the element-wise products, throws when the sizes differ
+    T dot(const Vector& other) const {
+        if (!is_valid() || !other.is_valid() || m_data_->length != other.m_data_->length) {
+            throw std::runtime_error("dot : vectors of different sizes");
+        }
+        const T* a = m_data_->elements;
+        const T* b = other.m_data_->elements;
+        if constexpr (HLM::simd::is_accelerated<T>::value) {
+            return HLM::simd::dot(a, b, m_data_->length);
+        }
+        else {
+            T accum = T();
+            for (size_t i = 0; i < m_data_->length; ++i) {
+                accum = accum + a[i] * b[i];
+            }
+            return accum;
+        }
+    }
+
+    // Sort in ascending order : radix sort for integer, float and double elements, merge sort
+    // otherwise (see hlm_sort.hpp). HLM_PARALLEL splits large vectors over the parallel workers
+    void sort(const bool& parallel = HLM_PARALLEL) {
+        sort(std::less<T>(), parallel);
+    }
+
+    // Sort with a strict weak ordering bool(const T&, const T&), std::less still takes the radix path
+    template <typename Compare, typename = EnableIfCompare<Compare>>
+    void sort(Compare cmp, const bool& parallel = HLM_PARALLEL) {
         if (is_valid()) {
-            std::sort(m_data_->vector->begin(), m_data_->vector->end());
-            m_data_->vector->erase(std::unique(m_data_->vector->begin(), m_data_->vector->end()), m_data_->vector->end());
+            HLM::sorting::sort(m_data_->elements, m_data_->length, cmp, parallel);
+        }
+    }
+
+    // Filter the vector to remove duplicates (sorts it), same engine as sort()
+    void filter(const bool& parallel = HLM_PARALLEL) {
+        if (is_valid()) {
+            HLM::sorting::sort(m_data_->elements, m_data_->length, std::less<T>(), parallel);
+            m_data_->truncate(HLM::sorting::unique(m_data_->elements, m_data_->length, parallel));
+        }
+    }
+
+    // Remove duplicates keeping the first occurrence of each value, in order (hash set, T hashable)
+    void filter_stable() {
+        if (is_valid()) {
+            m_data_->truncate(HLM::hashing::unique_stable(m_data_->elements, m_data_->length));
         }
     }
 
     // Swap external vector with internal
-    void swap(const Vector& externalVector)
+    void swap(Vector& externalVector)
     {
-        const Data* temp = this->m_data_;
+        Data* temp = this->m_data_;
         this->m_data_ = externalVector.m_data_;
         externalVector.m_data_ =  temp;
     }
 
-    void swap(const std::vector<T>& externalVector)
+    void swap(std::vector<T>& externalVector)
     {
-        std::vector<T> temp    = std::move(*(this->m_data_->vector));
-        this->m_data_->vector  = std::move(externalVector.m_data_->vector);
-        externalVector.m_data_ = std::move(temp);
-    }
-
-    void swap(const std::vector<T>&& externalVector)
-    {
-        std::vector<T> temp    = std::move(*(this->m_data_->vector));
-        this->m_data_->vector  = std::move(externalVector.m_data_->vector);
-        externalVector.m_data_ = std::move(temp);
+        if (is_valid()) {
+            std::vector<T> temp(m_data_->elements, m_data_->elements + m_data_->length);
+            m_data_->assign(externalVector.data(), externalVector.size());
+            externalVector = std::move(temp);
+        }
     }
 
     // Display the vector content
     void display() const {
         if (is_valid()) {
             std::cout << "Vector content: ";
-            const Vector<T>& temp = *this;
+            const Vector& temp = *this;
             for (size_t i = 0; i < size(); ++i) 
             {
                 std::cout << (temp[i]) << " ";  
@@ -655,9 +1197,25 @@ public:
         }
     }
 
+    // Versioned binary image, T must be trivially copyable (see hlm_serialize.hpp)
+    void save(std::ostream& out) const {
+        if (is_valid()) {
+            HLM::save(out, *this);
+        }
+    }
+
+    static Vector load(std::istream& in, const bool& verify = HLM_VERIFY_CHECKSUM) {
+        return HLM::load<Vector>(in, verify);
+    }
+
 /////////////////////////////////////////////////////////////////////////////
 }; // class Vector End
 
+/// @brief SmallVector
+// Vector with room for N elements in its control block
+template <typename T, size_t N, typename ThreadPolicy = SingleThreaded>
+using SmallVector = Vector<T, ThreadPolicy, N>;
+
 } // namespace HLM
  #endif
 /*
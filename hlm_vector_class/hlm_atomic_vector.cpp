@@ -0,0 +1,167 @@
+#pragma once
+#include "hlm_atomic_vector.h"
+
+#ifndef _HLM_ATOMIC_VECTOR_CPP_
+#define _HLM_ATOMIC_VECTOR_CPP_
+
+namespace HLM {
+namespace detail {
+
+    [[noreturn]] HLM_COLD inline void throw_unpackable_pointer()
+    {
+        throw std::runtime_error("AtomicSharedVector : block address does not fit in 48 bits");
+    }
+
+} // namespace detail
+} // namespace HLM
+
+////////////////////////////////////////////////////////////////////
+////////// Packed slot  ////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline std::uint64_t HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::pack(Data* data)
+{
+    const std::uint64_t address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(data));
+    if (HLM_UNLIKELY((address & ~pointer_mask) != 0))
+    {
+        HLM::detail::throw_unpackable_pointer();
+    }
+    return address;
+}
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::Data* HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::pointer_of(const std::uint64_t& word)
+{
+    return reinterpret_cast<Data*>(static_cast<std::uintptr_t>(word & pointer_mask));
+}
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::local_of(const std::uint64_t& word)
+{
+    return static_cast<size_t>(word >> 48);
+}
+
+////////////////////////////////////////////////////////////////////
+////////// Publication and reclamation  ////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+// The caller holds a reference on the block, a relaxed increment is enough
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline std::uint64_t HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::publish(const vector_type& vector)
+{
+    vector.is_valid();
+    const std::uint64_t word = pack(vector.m_data_);
+    vector.m_data_->count.fetch_add(bias, std::memory_order_relaxed);
+    return word;
+}
+
+// The local snapshots become real references and the bias is dropped, in a single subtraction
+// Snapshots released in the meantime only decremented the biased count, which stays above zero
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::retire(const std::uint64_t& word)
+{
+    Data* data = pointer_of(word);
+    if (data == nullptr)
+    {
+        return;
+    }
+    const size_t drop = bias - local_of(word);
+    if (data->count.fetch_sub(drop, HLM_DECREMENT_ORDER) == drop)
+    {
+        HLM_ACQUIRE_FENCE();
+        Data::destroy(data);
+    }
+}
+
+// Add the local count to the block refcount first, then take it off the slot
+// References are interchangeable, so if the block was retired and published again meanwhile
+// the subtraction is still correct as long as the new local count covers it, otherwise undo
+// The caller holds a snapshot of the block, the refcount cannot reach zero here
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+void HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::fold(Data* data) const
+{
+    std::uint64_t word = m_slot_.load(std::memory_order_relaxed);
+    const size_t local = local_of(word);
+    if (pointer_of(word) != data || local < fold_threshold)
+    {
+        return;
+    }
+    data->count.fetch_add(local, std::memory_order_relaxed);
+    const std::uint64_t folded = static_cast<std::uint64_t>(local) << 48;
+    while (pointer_of(word) == data && local_of(word) >= local)
+    {
+        if (m_slot_.compare_exchange_weak(word, word - folded, std::memory_order_relaxed, std::memory_order_relaxed))
+        {
+            return;
+        }
+    }
+    data->count.fetch_sub(local, std::memory_order_relaxed);
+}
+
+////////////////////////////////////////////////////////////////////
+////////// Public functions  ///////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::AtomicSharedVector() : m_slot_(publish(vector_type())) {}
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::AtomicSharedVector(const vector_type& initial) : m_slot_(publish(initial)) {}
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::~AtomicSharedVector()
+{
+    retire(m_slot_.load(std::memory_order_acquire));
+}
+
+// Wait-free : one fetch_add, plus a fold every fold_threshold loads of the same publication
+// The acquire pairs with the release of store() : the snapshot sees the vector as published
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::vector_type HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::load() const
+{
+    const std::uint64_t word = m_slot_.fetch_add(local_one, std::memory_order_acquire);
+    Data* data = pointer_of(word);
+    if (HLM_UNLIKELY(local_of(word) + 1 >= fold_threshold))
+    {
+        fold(data);
+    }
+    return vector_type(data);
+}
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::store(const vector_type& vector)
+{
+    const std::uint64_t word = publish(vector);
+    retire(m_slot_.exchange(word, std::memory_order_acq_rel));
+}
+
+// Same as retire() but one reference is kept for the returned handle
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::vector_type HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::exchange(const vector_type& vector)
+{
+    const std::uint64_t word = m_slot_.exchange(publish(vector), std::memory_order_acq_rel);
+    Data* data = pointer_of(word);
+    data->count.fetch_sub(bias - local_of(word) - 1, std::memory_order_relaxed);
+    return vector_type(data);
+}
+
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::AtomicSharedVector<T, InlineCapacity, BoundsPolicy>::compare_exchange(vector_type& expected, const vector_type& desired)
+{
+    const std::uint64_t next = publish(desired);
+    std::uint64_t word = m_slot_.load(std::memory_order_relaxed);
+    while (pointer_of(word) == expected.m_data_)
+    {
+        if (m_slot_.compare_exchange_weak(word, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+        {
+            retire(word);
+            return true;
+        }
+    }
+    // desired still holds its own reference, the bias comes off without reaching zero
+    desired.m_data_->count.fetch_sub(bias, std::memory_order_relaxed);
+    expected = load();
+    return false;
+}
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+#ifndef _HLM_ATOMIC_VECTOR_HPP_
+#define _HLM_ATOMIC_VECTOR_HPP_
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include "hlm_vector.h"
+
+namespace HELIUM_API {
+
+/// @brief class HLM::AtomicSharedVector
+/// A slot publishing a SharedVector to many threads : readers take snapshots with load(),
+/// writers replace the published vector with store() / exchange() / compare_exchange()
+/// A SharedVector handle itself is not safe to assign while another thread copies it,
+/// this is the handle to share instead
+///
+/// Reclamation uses a split refcount : the slot packs the block pointer with a local count
+/// of the snapshots taken since it was published. load() is a single fetch_add on that word
+/// (wait-free), the snapshot owns a reference that is only folded into the block refcount
+/// when the block is unpublished, or every fold_threshold loads
+/// While published the block refcount carries a publication bias, large enough that snapshots
+/// released before being folded never take it to zero. ref_count() of a snapshot includes it
+/// A retired block is destroyed by whoever drops its last reference, writer or reader
+///
+/// Snapshots share the published block : treat a published vector as immutable,
+/// build the next version separately (HLM_COPY or from scratch) and store() it
+/// Pointers must fit in 48 bits (every mainstream 64-bit ABI), checked at publication
+template <typename T, size_t InlineCapacity = 0, typename BoundsPolicy = HLM::BoundsWarn>
+class AtomicSharedVector {
+public:
+    typedef SharedVector<T, MultiThreaded, InlineCapacity, BoundsPolicy> vector_type;
+
+private:
+    typedef typename vector_type::Data Data;
+
+    // [ local count : 16 | block pointer : 48 ]
+    static const std::uint64_t pointer_mask   = (static_cast<std::uint64_t>(1) << 48) - 1;
+    static const std::uint64_t local_one      = static_cast<std::uint64_t>(1) << 48;
+    static const size_t        fold_threshold = static_cast<size_t>(1) << 14;
+    static const size_t        bias           = static_cast<size_t>(1) << 16;
+
+    mutable std::atomic<std::uint64_t> m_slot_;
+
+    inline static std::uint64_t pack(Data* data);
+    inline static Data* pointer_of(const std::uint64_t& word);
+    inline static size_t local_of(const std::uint64_t& word);
+
+    // Take a publication reference on the block of vector (bias), returns the packed word
+    inline static std::uint64_t publish(const vector_type& vector);
+    // Fold the pending snapshots of an unpublished word and drop its publication reference
+    inline static void retire(const std::uint64_t& word);
+    // Move the local count of data into its refcount before the 16 bits overflow
+    HLM_NOINLINE void fold(Data* data) const;
+
+public:
+
+    inline AtomicSharedVector();
+    inline explicit AtomicSharedVector(const vector_type& initial);
+    inline ~AtomicSharedVector();
+
+    AtomicSharedVector(const AtomicSharedVector&) = delete;
+    AtomicSharedVector& operator=(const AtomicSharedVector&) = delete;
+
+    // Snapshot of the published vector, stays valid (and unchanged by store) while held
+    inline vector_type load() const;
+    // Publish vector, the previous block is reclaimed once its last snapshot is dropped
+    inline void store(const vector_type& vector);
+    // Publish vector and return the previous one
+    inline vector_type exchange(const vector_type& vector);
+    // Publish desired only if expected is still the published block (same data_id),
+    // otherwise expected is refreshed with the current snapshot and false is returned
+    inline bool compare_exchange(vector_type& expected, const vector_type& desired);
+};
+
+}  // namespace HELIUM_API
+
+#ifdef USE_HEADER_ONLY_IMPLEMENTATION
+#include "hlm_atomic_vector.cpp"
+#endif
+
+#endif
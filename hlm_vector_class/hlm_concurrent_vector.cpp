@@ -0,0 +1,558 @@
+#pragma once
+#include "hlm_concurrent_vector.h"
+
+#ifndef _HLM_CONCURRENT_VECTOR_CPP_
+#define _HLM_CONCURRENT_VECTOR_CPP_
+
+////////////////////////////////////////////////////////////////////
+////////// Segment layout  /////////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+// Segment k starts at first_segment_size * (2^k - 1) and holds first_segment_size * 2^k elements
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::segment_of(const size_t& index)
+{
+    const unsigned long long bucket = static_cast<unsigned long long>(index / first_segment_size + 1);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(63 - __builtin_clzll(bucket));
+#else
+    size_t k = 0;
+    while (bucket >> (k + 1))
+    {
+        ++k;
+    }
+    return k;
+#endif
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::segment_base(const size_t& k)
+{
+    return first_segment_size * ((static_cast<size_t>(1) << k) - 1);
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::segment_size(const size_t& k)
+{
+    return first_segment_size << k;
+}
+
+////////////////////////////////////////////////////////////////////
+////////// Data control block  /////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+template <typename T>
+inline HELIUM_API::ConcurrentSharedVector<T>::Data::Data() : claimed(0), count(1)
+{
+    for (size_t k = 0; k < max_segments; ++k)
+    {
+        segments[k].store(nullptr, std::memory_order_relaxed);
+    }
+    HLM::LeakTracker<Data>::track(*this);
+    HLM_INSTRUMENT_COUNT(this, allocations);
+}
+
+template <typename T>
+inline HELIUM_API::ConcurrentSharedVector<T>::Data::~Data()
+{
+    destroy_range(0, claimed.load(std::memory_order_relaxed));
+    HLM_INSTRUMENT_RESIZE(bytes_used, claimed.load(std::memory_order_relaxed), 0);
+    for (size_t k = 0; k < max_segments; ++k)
+    {
+        deallocate_segment(segments[k].load(std::memory_order_relaxed), k);
+    }
+    HLM::LeakTracker<Data>::untrack(*this);
+}
+
+template <typename T>
+inline T* HELIUM_API::ConcurrentSharedVector<T>::Data::allocate_segment(const size_t& k)
+{
+    const size_t alignment = (alignof(T) > 64) ? alignof(T) : 64;
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, 0, segment_size(k));
+    return static_cast<T*>(::operator new(segment_size(k) * sizeof(T), std::align_val_t(alignment)));
+}
+
+template <typename T>
+inline void HELIUM_API::ConcurrentSharedVector<T>::Data::deallocate_segment(T* segment, const size_t& k)
+{
+    if (segment != nullptr)
+    {
+        const size_t alignment = (alignof(T) > 64) ? alignof(T) : 64;
+        HLM_INSTRUMENT_RESIZE(bytes_reserved, segment_size(k), 0);
+        ::operator delete(static_cast<void*>(segment), segment_size(k) * sizeof(T), std::align_val_t(alignment));
+    }
+}
+
+// Lock-free : every thread needing segment k may allocate one, the first CAS wins
+// and the losers free theirs. Segments are published with release, read with acquire
+template <typename T>
+inline T* HELIUM_API::ConcurrentSharedVector<T>::Data::ensure_segment(const size_t& k)
+{
+    T* segment = segments[k].load(std::memory_order_acquire);
+    if (HLM_LIKELY(segment != nullptr))
+    {
+        return segment;
+    }
+    T* fresh = allocate_segment(k);
+    HLM_INSTRUMENT_COUNT(this, allocations);
+    if (segments[k].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+        return fresh;
+    }
+    deallocate_segment(fresh, k);
+    return segment;
+}
+
+// The segments of the n slots are in place before the claim is published, so a failed allocation
+// claims nothing : every claimed slot has a segment for the destructor and clear() to walk
+// The claim is a compare-and-swap, retried (with the segments of the new range) when another
+// thread appended in between
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::Data::claim(const size_t& n)
+{
+    size_t first = claimed.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        if (n != 0)
+        {
+            const size_t last_segment = segment_of(first + n - 1);
+            for (size_t k = segment_of(first); k <= last_segment; ++k)
+            {
+                ensure_segment(k);
+            }
+        }
+        if (claimed.compare_exchange_weak(first, first + n, std::memory_order_relaxed, std::memory_order_relaxed))
+        {
+            return first;
+        }
+    }
+}
+
+template <typename T>
+inline T& HELIUM_API::ConcurrentSharedVector<T>::Data::slot(const size_t& index) const
+{
+    const size_t k = segment_of(index);
+    return segments[k].load(std::memory_order_acquire)[index - segment_base(k)];
+}
+
+template <typename T>
+inline void HELIUM_API::ConcurrentSharedVector<T>::Data::destroy_range(const size_t& first, const size_t& last)
+{
+    if constexpr (!std::is_trivially_destructible<T>::value)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            slot(i).~T();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+////////// Private functions  //////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+// Release the data
+template <typename T>
+inline void HELIUM_API::ConcurrentSharedVector<T>::release_reference()
+{
+    if (m_data_ != nullptr)
+    {
+        HLM_INSTRUMENT_COUNT(m_data_, refcount_decrements);
+        if (MultiThreaded::decrement(m_data_->count))
+        {
+            delete m_data_;
+        }
+    }
+    m_data_ = nullptr;
+}
+
+// A claimed slot is always counted by size(), so it must hold an object even when the copy throws :
+// it is value-initialized and the exception is rethrown
+template <typename T>
+inline void HELIUM_API::ConcurrentSharedVector<T>::construct_at(T* place, const T& value)
+{
+    try
+    {
+        new (place) T(value);
+    }
+    catch (...)
+    {
+        new (place) T();
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////
+////////// Segment iterator  ///////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+template <typename T>
+template <typename Value>
+inline HELIUM_API::ConcurrentSharedVector<T>::SegmentIterator<Value>::SegmentIterator(Data* data, const size_t& index)
+    : data_(data), index_(index), segment_end_(0), element_(nullptr)
+{
+    if (index_ < data_->claimed.load(std::memory_order_acquire))
+    {
+        const size_t k = segment_of(index_);
+        element_     = data_->segments[k].load(std::memory_order_acquire) + (index_ - segment_base(k));
+        segment_end_ = segment_base(k + 1);
+    }
+}
+
+// Pointer increment inside a segment, table lookup when crossing into the next one
+template <typename T>
+template <typename Value>
+inline typename HELIUM_API::ConcurrentSharedVector<T>::template SegmentIterator<Value>& HELIUM_API::ConcurrentSharedVector<T>::SegmentIterator<Value>::operator++()
+{
+    ++index_;
+    ++element_;
+    if (HLM_UNLIKELY(index_ == segment_end_))
+    {
+        const size_t k = segment_of(index_);
+        element_     = data_->segments[k].load(std::memory_order_acquire);
+        segment_end_ = segment_base(k + 1);
+    }
+    return *this;
+}
+
+////////////////////////////////////////////////////////////////////
+////////// Public functions  ///////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+// check validity
+template <typename T>
+inline bool HELIUM_API::ConcurrentSharedVector<T>::is_valid() const
+{
+    if (HLM_LIKELY(m_data_ != nullptr && MultiThreaded::load(m_data_->count) != 0))
+    {
+        return true;
+    }
+    else
+    {
+        HLM::detail::throw_invalid_handle();
+    }
+}
+
+template <typename T>
+inline T& HELIUM_API::ConcurrentSharedVector<T>::DefaultValue()
+{
+    static T default_value;
+    return default_value;
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::ref_count() const
+{
+    return MultiThreaded::load(m_data_->count);
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::data_id() const
+{
+    return m_data_->UUID;
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::live_instances()
+{
+    return HLM::LeakTracker<Data>::live_count();
+}
+
+template <typename T>
+inline HLM::instrument::Counters HELIUM_API::ConcurrentSharedVector<T>::counters() const
+{
+    HLM::instrument::Counters block;
+    if (is_valid())
+    {
+#ifdef HLM_INSTRUMENT
+        block = m_data_->counters.snapshot(capacity() * sizeof(T), size() * sizeof(T));
+#else
+        block[HLM::instrument::bytes_reserved] = static_cast<std::int64_t>(capacity() * sizeof(T));
+        block[HLM::instrument::bytes_used]     = static_cast<std::int64_t>(size() * sizeof(T));
+#endif
+    }
+    return block;
+}
+
+template <typename T>
+inline HELIUM_API::ConcurrentSharedVector<T>::ConcurrentSharedVector() : m_data_(new Data()) {}
+
+template <typename T>
+inline HELIUM_API::ConcurrentSharedVector<T>::ConcurrentSharedVector(const std::vector<T>& externalVector) : m_data_(new Data())
+{
+    if (!externalVector.empty())
+    {
+        reserve(externalVector.size());
+        for (size_t i = 0; i < externalVector.size(); ++i)
+        {
+            push_back(externalVector[i]);
+        }
+    }
+}
+
+template <typename T>
+inline HELIUM_API::ConcurrentSharedVector<T>::ConcurrentSharedVector(const ConcurrentSharedVector& externalVector, const int& move_semantic)
+{
+    if (move_semantic == HLM_MOVE)
+    {
+        this->m_data_ = externalVector.m_data_;
+        HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+        MultiThreaded::increment(this->m_data_->count);
+    }
+    else
+    {
+        HLM_INSTRUMENT_COUNT(externalVector.m_data_, deep_copies);
+        m_data_ = new Data();
+        const size_t n = externalVector.size();
+        reserve(n);
+        for (const_iterator it = externalVector.begin(); it != externalVector.end(); ++it)
+        {
+            push_back(*it);
+        }
+    }
+}
+
+template <typename T>
+inline HELIUM_API::ConcurrentSharedVector<T>::~ConcurrentSharedVector()
+{
+    release_reference();
+}
+
+template <typename T>
+inline const HELIUM_API::ConcurrentSharedVector<T>& HELIUM_API::ConcurrentSharedVector<T>::operator=(const ConcurrentSharedVector& externalVector)
+{
+    if (m_data_ == externalVector.m_data_)
+    {
+        return *this;
+    }
+    release_reference();
+    this->m_data_ = externalVector.m_data_;
+    HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+    MultiThreaded::increment(this->m_data_->count);
+    return *this;
+}
+
+template <typename T>
+inline bool HELIUM_API::ConcurrentSharedVector<T>::operator==(const ConcurrentSharedVector& other) const
+{
+    return (m_data_ == other.m_data_);
+}
+
+template <typename T>
+inline bool HELIUM_API::ConcurrentSharedVector<T>::operator!=(const ConcurrentSharedVector& other) const
+{
+    return !(m_data_ == other.m_data_);
+}
+
+template <typename T>
+inline HELIUM_API::ConcurrentSharedVector<T>::operator std::vector<T>() const
+{
+    std::vector<T> out;
+    if (is_valid())
+    {
+        HLM_INSTRUMENT_COUNT(m_data_, deep_copies);
+        const size_t n = size();
+        out.reserve(n);
+        for (size_t k = 0; segment_base(k) < n; ++k)
+        {
+            const T* segment = m_data_->segments[k].load(std::memory_order_acquire);
+            const size_t last = (segment_base(k + 1) < n) ? segment_base(k + 1) : n;
+            out.insert(out.end(), segment, segment + (last - segment_base(k)));
+        }
+    }
+    return out;
+}
+
+template <typename T>
+template <typename ThreadPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy> HELIUM_API::ConcurrentSharedVector<T>::to_shared() const
+{
+    return SharedVector<T, ThreadPolicy>(static_cast<std::vector<T>>(*this));
+}
+
+// One claim takes the slot, its segment is allocated on first touch
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::push_back(const T& value)
+{
+    is_valid();
+    const size_t index = m_data_->claim(1);
+    HLM_INSTRUMENT_RESIZE(bytes_used, 0, 1);
+    construct_at(&m_data_->slot(index), value);
+    return index;
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::emplace_back(const T& value)
+{
+    return push_back(value);
+}
+
+// The n slots are claimed at once so they are contiguous in index space, they may straddle segments
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::grow_by(const size_t& n, const T& value)
+{
+    is_valid();
+    const size_t first = m_data_->claim(n);
+    HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+    size_t i = first;
+    try
+    {
+        for (; i < first + n; ++i)
+        {
+            new (&m_data_->slot(i)) T(value);
+        }
+    }
+    catch (...)
+    {
+        for (; i < first + n; ++i)
+        {
+            new (&m_data_->slot(i)) T();
+        }
+        throw;
+    }
+    return first;
+}
+
+template <typename T>
+inline void HELIUM_API::ConcurrentSharedVector<T>::reserve(const size_t& n)
+{
+    if (is_valid() && n > 0)
+    {
+        const size_t last_segment = segment_of(n - 1);
+        for (size_t k = 0; k <= last_segment; ++k)
+        {
+            m_data_->ensure_segment(k);
+        }
+    }
+}
+
+template <typename T>
+inline T& HELIUM_API::ConcurrentSharedVector<T>::operator[](const size_t& index)
+{
+    assert(index < size());
+    return m_data_->slot(index);
+}
+
+template <typename T>
+inline const T& HELIUM_API::ConcurrentSharedVector<T>::operator[](const size_t& index) const
+{
+    assert(index < size());
+    return m_data_->slot(index);
+}
+
+template <typename T>
+inline T& HELIUM_API::ConcurrentSharedVector<T>::at(const size_t& index)
+{
+    if (HLM_UNLIKELY(index >= size()))
+    {
+        HLM::detail::throw_out_of_bounds(index, size());
+    }
+    return m_data_->slot(index);
+}
+
+template <typename T>
+inline const T& HELIUM_API::ConcurrentSharedVector<T>::at(const size_t& index) const
+{
+    if (HLM_UNLIKELY(index >= size()))
+    {
+        HLM::detail::throw_out_of_bounds(index, size());
+    }
+    return m_data_->slot(index);
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::size() const
+{
+    return (is_valid()) ? m_data_->claimed.load(std::memory_order_acquire) : 0;
+}
+
+template <typename T>
+inline size_t HELIUM_API::ConcurrentSharedVector<T>::capacity() const
+{
+    size_t total = 0;
+    if (is_valid())
+    {
+        for (size_t k = 0; k < max_segments; ++k)
+        {
+            if (m_data_->segments[k].load(std::memory_order_acquire) == nullptr)
+            {
+                break;
+            }
+            total = segment_base(k + 1);
+        }
+    }
+    return total;
+}
+
+template <typename T>
+inline bool HELIUM_API::ConcurrentSharedVector<T>::empty() const
+{
+    return (size() == 0);
+}
+
+template <typename T>
+inline typename HELIUM_API::ConcurrentSharedVector<T>::iterator HELIUM_API::ConcurrentSharedVector<T>::begin()
+{
+    return iterator(m_data_, 0);
+}
+
+template <typename T>
+inline typename HELIUM_API::ConcurrentSharedVector<T>::const_iterator HELIUM_API::ConcurrentSharedVector<T>::begin() const
+{
+    return const_iterator(m_data_, 0);
+}
+
+template <typename T>
+inline typename HELIUM_API::ConcurrentSharedVector<T>::iterator HELIUM_API::ConcurrentSharedVector<T>::end()
+{
+    return iterator(m_data_, size());
+}
+
+template <typename T>
+inline typename HELIUM_API::ConcurrentSharedVector<T>::const_iterator HELIUM_API::ConcurrentSharedVector<T>::end() const
+{
+    return const_iterator(m_data_, size());
+}
+
+template <typename T>
+inline void HELIUM_API::ConcurrentSharedVector<T>::clear()
+{
+    if (is_valid())
+    {
+        const size_t claimed = m_data_->claimed.load(std::memory_order_acquire);
+        m_data_->destroy_range(0, claimed);
+        HLM_INSTRUMENT_RESIZE(bytes_used, claimed, 0);
+        m_data_->claimed.store(0, std::memory_order_release);
+    }
+}
+
+template <typename T>
+template <typename Function>
+inline void HELIUM_API::ConcurrentSharedVector<T>::broadcast(Function&& function)
+{
+    const size_t n = size();
+    for (size_t k = 0; segment_base(k) < n; ++k)
+    {
+        T* segment = m_data_->segments[k].load(std::memory_order_acquire);
+        const size_t length = ((segment_base(k + 1) < n) ? segment_base(k + 1) : n) - segment_base(k);
+        for (size_t i = 0; i < length; ++i)
+        {
+            function(segment[i]);
+        }
+    }
+}
+
+template <typename T>
+inline void HELIUM_API::ConcurrentSharedVector<T>::display() const
+{
+    if (is_valid())
+    {
+        std::cout << "ConcurrentSharedVector content: ";
+        for (const_iterator it = begin(); it != end(); ++it)
+        {
+            std::cout << (*it) << " ";
+        }
+        std::cout << "\n";
+    }
+}
+#endif
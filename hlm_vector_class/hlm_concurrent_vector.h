@@ -0,0 +1,185 @@
+#pragma once
+#ifndef _HLM_CONCURRENT_VECTOR_HPP_
+#define _HLM_CONCURRENT_VECTOR_HPP_
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+#include <cassert>
+#include "hlm_vector.h"
+
+namespace HELIUM_API {
+
+/// @brief class HLM::ConcurrentSharedVector
+/// A SharedVector-like handle whose push_back / emplace_back / grow_by may be called from any
+/// number of threads at once without a lock
+/// Elements live in geometrically growing segments (64, 128, 256 ... elements) that are never
+/// moved or freed before the block dies, so a reference to an element stays valid while other
+/// threads keep appending
+/// An append makes sure the segments of its slots exist, then claims the slots with one
+/// compare-and-swap on the claim counter (retried if another thread appended in between) :
+/// the thread that first reaches an unallocated segment allocates it and publishes it with a
+/// compare-and-swap, and a failed allocation leaves the vector as it was
+/// size() counts claimed slots : an element is readable by another thread once that thread has
+/// synchronised with the one that appended it (join, barrier, end of an omp parallel region)
+/// clear(), broadcast() and the copies are not safe against concurrent appends
+/// The refcount is always atomic (handles may be shared across threads)
+template <typename T>
+class ConcurrentSharedVector {
+public:
+    static const size_t first_segment_size = 64;
+    static const size_t max_segments       = 48;
+
+private:
+    /// @brief struct Data
+    // Control block : refcount, claim counter and the segment table
+    // Caution : Not meant for external use
+    struct Data : public HLM::LeakTracker<Data>::Node {
+        alignas(64) std::atomic<size_t> claimed;    // slots handed out, own cache line
+        alignas(64) std::atomic<size_t> count;
+        std::atomic<T*> segments[max_segments];
+#ifdef HLM_INSTRUMENT
+        HLM::instrument::BlockCounters counters;
+#endif
+
+        inline Data();
+        inline ~Data();
+
+        // Allocate segment k unless another thread did, returns it either way
+        inline T* ensure_segment(const size_t& k);
+        // Claim n contiguous slots once their segments exist, returns the first index
+        inline size_t claim(const size_t& n);
+        inline T& slot(const size_t& index) const;
+        // Destroy [first, last) (all constructed), segments are kept
+        inline void destroy_range(const size_t& first, const size_t& last);
+
+        inline static T* allocate_segment(const size_t& k);
+        inline static void deallocate_segment(T* segment, const size_t& k);
+    };
+
+    Data* m_data_;
+
+    inline void release_reference();
+    // Construct value in an already claimed slot
+    inline void construct_at(T* place, const T& value);
+
+public:
+    typedef T value_type;
+
+    // Segment k holds the indices [segment_base(k), segment_base(k + 1))
+    inline static size_t segment_of(const size_t& index);
+    inline static size_t segment_base(const size_t& k);
+    inline static size_t segment_size(const size_t& k);
+
+    /// @brief class SegmentIterator
+    // Forward iterator walking the segments in order, Value is T or const T
+    template <typename Value>
+    class SegmentIterator {
+    public:
+        typedef std::forward_iterator_tag         iterator_category;
+        typedef typename std::remove_const<Value>::type value_type;
+        typedef std::ptrdiff_t                    difference_type;
+        typedef Value*                            pointer;
+        typedef Value&                            reference;
+
+        SegmentIterator() : data_(nullptr), index_(0), segment_end_(0), element_(nullptr) {}
+        inline SegmentIterator(Data* data, const size_t& index);
+
+        reference operator*() const { return *element_; }
+        pointer operator->() const { return element_; }
+        inline SegmentIterator& operator++();
+        SegmentIterator operator++(int) { SegmentIterator old(*this); ++(*this); return old; }
+        bool operator==(const SegmentIterator& other) const { return index_ == other.index_; }
+        bool operator!=(const SegmentIterator& other) const { return index_ != other.index_; }
+
+    private:
+        Data*  data_;
+        size_t index_;
+        size_t segment_end_;
+        Value* element_;
+    };
+
+    typedef SegmentIterator<T>       iterator;
+    typedef SegmentIterator<const T> const_iterator;
+
+////////////////////////////////////////////////////////////////////////////////////////
+////////  Smart & Safety check functions //////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////
+
+    inline bool is_valid() const;
+    inline static T& DefaultValue();
+    inline size_t ref_count() const;
+    inline size_t data_id() const;
+    inline static size_t live_instances();
+    // Counters of the block (see hlm_instrument.hpp), only the byte counters unless HLM_INSTRUMENT
+    inline HLM::instrument::Counters counters() const;
+
+///////////////////////////////////////////////////////////////////////////////////////
+///// Construction, same handle semantics as SharedVector (HLM_MOVE shares the block)
+///////////////////////////////////////////////////////////////////////////////////////
+
+    inline ConcurrentSharedVector();
+    inline explicit ConcurrentSharedVector(const std::vector<T>& externalVector);
+    inline ConcurrentSharedVector(const ConcurrentSharedVector& externalVector, const int& move_semantic = HLM_MOVE);
+    inline ~ConcurrentSharedVector();
+
+    inline const ConcurrentSharedVector& operator=(const ConcurrentSharedVector& externalVector);
+    inline bool operator==(const ConcurrentSharedVector& other) const;
+    inline bool operator!=(const ConcurrentSharedVector& other) const;
+
+    // Contiguous copies, not safe against concurrent appends
+    inline operator std::vector<T>() const;
+    template <typename ThreadPolicy = MultiThreaded>
+    inline SharedVector<T, ThreadPolicy> to_shared() const;
+
+///////////////////////////////////////////////////////////////////////////////////////
+///// Concurrent functions
+///////////////////////////////////////////////////////////////////////////////////////
+
+    // Append value, returns its index
+    inline size_t push_back(const T& value);
+    inline size_t emplace_back(const T& value);
+    // Append n copies of value, returns the index of the first one
+    inline size_t grow_by(const size_t& n, const T& value = T());
+    // Allocate the segments for n elements up front, appends below n never allocate
+    inline void reserve(const size_t& n);
+
+    // Access element at index, never moves once appended
+    // operator[] is only checked in debug builds, at() throws std::out_of_range
+    inline T& operator[](const size_t& index);
+    inline const T& operator[](const size_t& index) const;
+    inline T& at(const size_t& index);
+    inline const T& at(const size_t& index) const;
+
+    inline size_t size() const;
+    inline size_t capacity() const;
+    inline bool empty() const;
+
+    inline iterator begin();
+    inline const_iterator begin() const;
+    inline iterator end();
+    inline const_iterator end() const;
+
+///////////////////////////////////////////////////////////////////////////////////////
+///// Not safe against concurrent appends
+///////////////////////////////////////////////////////////////////////////////////////
+
+    // Destroy the elements, the segments are kept for reuse
+    inline void clear();
+    // Call function(T&) on every element, one segment at a time
+    template <typename Function>
+    inline void broadcast(Function&& function);
+    inline void display() const;
+};
+
+}  // namespace HELIUM_API
+
+#ifdef USE_HEADER_ONLY_IMPLEMENTATION
+#include "hlm_concurrent_vector.cpp"
+#endif
+
+#endif
@@ -4,251 +4,823 @@
 #ifndef _HLM_SMART_VECTOR_CPP_
 #define _HLM_SMART_VECTOR_CPP_
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::Data::Data() : vector(new std::vector<T>()), count(1)
+////////////////////////////////////////////////////////////////////
+////////// Data control block  /////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::Data(const size_t& capacity, std::pmr::memory_resource* resource, const size_t& alignment)
+    : elements(nullptr), length(0), reserved(capacity), inline_reserved(capacity), alignment(alignment), generation(0), copy_on_write(false),
+      read_only(false), mapping(nullptr), mapped_bytes(0), resource(resource), index(nullptr), count(1), pins(0)
 {
-    std::atexit(Data::checkGlobalCount);
-    UUID = (++GlobalCount());
-#ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-    std::cout << "Created New SharedVector with ID = " << GlobalCount() << "\n";
-#endif
+    elements = inline_storage();
+    HLM::LeakTracker<Data>::track(*this);
+    HLM_MEMORY_REGISTER(Data);
+    HLM_INSTRUMENT_COUNT(this, allocations);
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, 0, capacity);
+    HLM_MEMORY_ACCOUNT(0, capacity);
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::Data::Data(const std::vector<T>& externalVector) : vector(new std::vector<T>((externalVector))), count(1)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::~Data()
 {
-    std::atexit(Data::checkGlobalCount);
-    UUID = (++GlobalCount());
-#ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-    std::cout << "Created New SharedVector with ID = " << GlobalCount() << "\n";
-#endif
+    HLM::LeakTracker<Data>::untrack(*this);
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, 0);
+    HLM_MEMORY_ACCOUNT(reserved, 0);
+    HLM_INSTRUMENT_RESIZE(bytes_used, length, 0);
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::Data::Data(const std::vector<T>&& externalVector) : vector(new std::vector<T>((externalVector))), count(1)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::allocate(const size_t& capacity, std::pmr::memory_resource* resource, const size_t& alignment)
 {
-    std::atexit(Data::checkGlobalCount);
-    UUID = (++GlobalCount());
-#ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-    std::cout << "Created New SharedVector with ID = " << GlobalCount() << "\n";
-#endif
+    const size_t slots = (capacity > InlineCapacity) ? capacity : InlineCapacity;
+    void* raw = allocate_bytes(resource, tail_offset(alignment) + slots * sizeof(T), block_alignment(alignment));
+    return new (raw) Data(slots, resource, alignment);
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::Data::~Data()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::create(const size_t& capacity, std::pmr::memory_resource* resource)
 {
-    --GlobalCount();
-#ifdef HELIUM_API_DEBUG_PROFILE_ENABLE
-    std::cout << "Deleted SharedVector with ID =  " << UUID << "\n";
-#endif
-    delete vector;
+    Data* data = allocate(capacity, resource, HLM::detail::element_alignment(resource, alignof(T)));
+    HLM_MEMORY_CHECK(data);
+    return data;
 }
 
-// Caution : Not meant for external use
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::delete_vector() {
-    try {
-        if (m_data_ != nullptr) {
-            {
-                if (m_data_->vector != nullptr)
-                    delete m_data_->vector;
-            }
-        else
-           {
-             throw std::runtime_error("Deleting an invalid std::vector Pointer");  
-           }    
-           m_data_->vector = nullptr;
-        }
-    } catch (...) {
-        
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::create(const size_t& capacity, const Data& like)
+{
+    Data* data = allocate(capacity, like.resource, like.alignment);
+    HLM_MEMORY_CHECK(data);
+    return data;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::create(const T* first, const size_t& n, std::pmr::memory_resource* resource)
+{
+    return copy_in(allocate(n, resource, HLM::detail::element_alignment(resource, alignof(T))), first, n);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::create(const T* first, const size_t& n, const Data& like)
+{
+    return copy_in(allocate(n, like.resource, like.alignment), first, n);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::copy_in(Data* data, const T* first, const size_t& n)
+{
+    try
+    {
+        std::uninitialized_copy_n(first, n, data->elements);
     }
+    catch (...)
+    {
+        destroy(data);
+        throw;
+    }
+    data->length = n;
+    HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+    HLM_MEMORY_CHECK(data);
+    return data;
 }
 
-// Caution : Not meant for external use
-// Only meant for reassigning new vector
-// Delete the data and move new copy
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::force_delete_data() {
-    if (m_data_ != nullptr) {
-        {
-            delete m_data_;
-        }
-        m_data_ = nullptr;
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::destroy(Data* data)
+{
+    data->drop_index();
+    std::destroy_n(data->elements, data->length);
+    if (!data->is_inline())
+    {
+        data->deallocate_elements(data->elements, data->reserved);
+    }
+    std::pmr::memory_resource* resource = data->resource;
+    const size_t alignment = data->alignment;
+    const size_t bytes = tail_offset(alignment) + data->inline_reserved * sizeof(T);
+    data->~Data();
+    deallocate_bytes(resource, data, bytes, block_alignment(alignment));
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::pin()
+{
+    HLM_INSTRUMENT_COUNT(this, refcount_increments);
+    ThreadPolicy::increment(count);
+    ThreadPolicy::increment(pins);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::unpin()
+{
+    HLM_INSTRUMENT_COUNT(this, refcount_decrements);
+    ThreadPolicy::decrement(pins);
+    return ThreadPolicy::decrement(count);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::drop_index()
+{
+    delete index;
+    index = nullptr;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::describe(HLM::memory::BlockInfo& info) const
+{
+    info.container    = "SharedVector";
+    info.element_type = typeid(T).name();
+    info.element_size = sizeof(T);
+    info.size         = length;
+    info.capacity     = reserved;
+    info.handles      = ThreadPolicy::load(count);
+    info.mapped       = (mapping != nullptr);
+}
+
+// Shared, pinned and mapped blocks are left alone : their holders may be reading the elements
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::try_shrink()
+{
+    if (ThreadPolicy::load(count) != 1 || ThreadPolicy::load(pins) != 0 || mapping != nullptr ||
+        is_inline() || length == reserved)
+    {
+        return 0;
+    }
+    const size_t before = reserved;
+    shrink_to_fit();
+    return (before - reserved) * sizeof(T);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::inline_storage()
+{
+    return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + tail_offset(alignment));
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::is_inline() const
+{
+    return elements == const_cast<Data*>(this)->inline_storage();
+}
+
+// The block's memory resource if it has one, else plain operator new unless T is over-aligned
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::allocate_bytes(std::pmr::memory_resource* resource, const size_t& bytes, const size_t& alignment)
+{
+    if (resource != nullptr)
+    {
+        return resource->allocate(bytes, alignment);
+    }
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        return ::operator new(bytes, std::align_val_t(alignment));
+    }
+    return ::operator new(bytes);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::deallocate_bytes(std::pmr::memory_resource* resource, void* memory, const size_t& bytes, const size_t& alignment)
+{
+    if (resource != nullptr)
+    {
+        resource->deallocate(memory, bytes, alignment);
+        return;
+    }
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        ::operator delete(memory, std::align_val_t(alignment));
+        return;
+    }
+    ::operator delete(memory);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::allocate_elements(const size_t& n)
+{
+    HLM_INSTRUMENT_COUNT(this, allocations);
+    return static_cast<T*>(allocate_bytes(resource, n * sizeof(T), alignment));
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::deallocate_elements(T* buffer, const size_t& n)
+{
+    // The file mapping is only ever released as the current element buffer
+    if (HLM_UNLIKELY(mapping != nullptr) && buffer == elements)
+    {
+        HLM::unmap_region(mapping, mapped_bytes);
+        mapping      = nullptr;
+        mapped_bytes = 0;
+        read_only = false;
+        return;
+    }
+    deallocate_bytes(resource, buffer, n * sizeof(T), alignment);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::grown_capacity(const size_t& min_capacity) const
+{
+    size_t doubled = reserved * 2;
+    return (doubled > min_capacity) ? doubled : min_capacity;
+}
+
+// Spill (or re-spill) the elements into a heap buffer of new_capacity
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::reserve(const size_t& new_capacity)
+{
+    if (new_capacity <= reserved)
+    {
+        return;
+    }
+    T* buffer = allocate_elements(new_capacity);
+    try
+    {
+        std::uninitialized_move_n(elements, length, buffer);
+    }
+    catch (...)
+    {
+        deallocate_elements(buffer, new_capacity);
+        throw;
+    }
+    std::destroy_n(elements, length);
+    if (!is_inline())
+    {
+        deallocate_elements(elements, reserved);
+    }
+    HLM_INSTRUMENT_COUNT(this, reallocations);
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, new_capacity);
+    HLM_MEMORY_ACCOUNT(reserved, new_capacity);
+    elements = buffer;
+    reserved = new_capacity;
+    ++generation;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::push_back(const T& value)
+{
+    if (length < reserved)
+    {
+        new (elements + length) T(value);
+        HLM_INSTRUMENT_RESIZE(bytes_used, 0, 1);
+        ++length;
+        return;
+    }
+    // value may alias an element, so construct it in the new buffer before moving the rest
+    const size_t new_capacity = grown_capacity(length + 1);
+    T* buffer = allocate_elements(new_capacity);
+    try
+    {
+        new (buffer + length) T(value);
+    }
+    catch (...)
+    {
+        deallocate_elements(buffer, new_capacity);
+        throw;
+    }
+    std::uninitialized_move_n(elements, length, buffer);
+    std::destroy_n(elements, length);
+    if (!is_inline())
+    {
+        deallocate_elements(elements, reserved);
+    }
+    HLM_INSTRUMENT_COUNT(this, reallocations);
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, new_capacity);
+    HLM_MEMORY_ACCOUNT(reserved, new_capacity);
+    elements = buffer;
+    reserved = new_capacity;
+    ++generation;
+    HLM_INSTRUMENT_RESIZE(bytes_used, 0, 1);
+    ++length;
+    HLM_MEMORY_CHECK(this);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::insert_front(const T& value)
+{
+    T copy(value);
+    push_back(copy);
+    std::rotate(elements, elements + length - 1, elements + length);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::append(const T* first, const size_t& n)
+{
+    if (length + n <= reserved)
+    {
+        std::uninitialized_copy_n(first, n, elements + length);
+        HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+        length += n;
+        return;
+    }
+    // first may point into our own storage, so copy before releasing the old buffer
+    const size_t new_capacity = grown_capacity(length + n);
+    T* buffer = allocate_elements(new_capacity);
+    try
+    {
+        std::uninitialized_copy_n(first, n, buffer + length);
+    }
+    catch (...)
+    {
+        deallocate_elements(buffer, new_capacity);
+        throw;
+    }
+    std::uninitialized_move_n(elements, length, buffer);
+    std::destroy_n(elements, length);
+    if (!is_inline())
+    {
+        deallocate_elements(elements, reserved);
+    }
+    HLM_INSTRUMENT_COUNT(this, reallocations);
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, new_capacity);
+    HLM_MEMORY_ACCOUNT(reserved, new_capacity);
+    elements = buffer;
+    reserved = new_capacity;
+    ++generation;
+    HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+    length += n;
+    HLM_MEMORY_CHECK(this);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::assign(const T* first, const size_t& n)
+{
+    truncate(0);
+    if (n > reserved)
+    {
+        reserve(n);
+    }
+    std::uninitialized_copy_n(first, n, elements);
+    HLM_INSTRUMENT_RESIZE(bytes_used, 0, n);
+    length = n;
+    // Replaces the whole content, so it invalidates iterators even without a reallocation
+    ++generation;
+    HLM_MEMORY_CHECK(this);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::resize(const size_t& new_length, const bool& parallel)
+{
+    if (new_length <= length)
+    {
+        truncate(new_length);
+        return;
+    }
+    if (new_length > reserved)
+    {
+        reserve(grown_capacity(new_length));
+    }
+    if (parallel)
+    {
+        HLM::parallel::uninitialized_value_construct(elements + length, new_length - length);
     }
+    else
+    {
+        std::uninitialized_value_construct_n(elements + length, new_length - length);
+    }
+    HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+    length = new_length;
+    HLM_MEMORY_CHECK(this);
 }
 
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::resize_uninitialized(const size_t& new_length)
+{
+    if (new_length <= length)
+    {
+        truncate(new_length);
+        return;
+    }
+    if (new_length > reserved)
+    {
+        reserve(grown_capacity(new_length));
+    }
+    HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+    length = new_length;
+    HLM_MEMORY_CHECK(this);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::truncate(const size_t& new_length)
+{
+    if (new_length < length)
+    {
+        std::destroy_n(elements + new_length, length - new_length);
+        HLM_INSTRUMENT_RESIZE(bytes_used, length, new_length);
+        length = new_length;
+    }
+}
+
+// Move spilled elements back into the inline tail or into an exactly sized buffer
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::Data::shrink_to_fit()
+{
+    if (is_inline() || length == reserved)
+    {
+        return;
+    }
+    const bool fits_inline = (length <= inline_reserved);
+    T* buffer = fits_inline ? inline_storage() : allocate_elements(length);
+    std::uninitialized_move_n(elements, length, buffer);
+    std::destroy_n(elements, length);
+    deallocate_elements(elements, reserved);
+    const size_t new_capacity = fits_inline ? inline_reserved : length;
+    HLM_INSTRUMENT_COUNT(this, reallocations);
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, reserved, new_capacity);
+    HLM_MEMORY_ACCOUNT(reserved, new_capacity);
+    elements = buffer;
+    reserved = new_capacity;
+    ++generation;
+}
+
+////////////////////////////////////////////////////////////////////
+////////// SharedVector  ///////////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(Data* data) : m_data_(data) {}
+
 // Release the data
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::release_reference() {
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::release_reference() {
     if (m_data_ != nullptr) {
-        --m_data_->count;
-        if (m_data_->count == 0) {
-            delete m_data_;
+        HLM_INSTRUMENT_COUNT(m_data_, refcount_decrements);
+        if (ThreadPolicy::decrement(m_data_->count)) {
+            Data::destroy(m_data_);
         }
     }
     // release the data
     m_data_ = nullptr;
 }
 
-// Crititcal functionality !!! Do not modify 
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::find_index(const T& value) const
+{
+    if constexpr (HLM::hashing::is_hashable<T>::value)
+    {
+        if (m_data_->index != nullptr)
+        {
+            const size_t index = m_data_->index->find(m_data_->elements, value);
+            return (index != HLM::hashing::IndexTable<T>::npos) ? index : m_data_->length;
+        }
+    }
+    if constexpr (HLM::simd::is_accelerated<T>::value)
+    {
+        return HLM::simd::find(m_data_->elements, m_data_->length, value);
+    }
+    else
+    {
+        return static_cast<size_t>(std::find(m_data_->elements, m_data_->elements + m_data_->length, value) - m_data_->elements);
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::detach()
+{
+    if (must_fork())
+    {
+        fork();
+    }
+    if (HLM_UNLIKELY(m_data_->index != nullptr))
+    {
+        m_data_->drop_index();
+    }
+}
+
+// A forked block starts without an index, there is nothing left to update then
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::detach_keep_index()
+{
+    if (must_fork())
+    {
+        fork();
+    }
+}
+
+// The new positions are larger than any recorded one, a value already present keeps its first position
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::index_appended(const size_t& from)
+{
+    if constexpr (HLM::hashing::is_hashable<T>::value)
+    {
+        if (HLM_UNLIKELY(m_data_->index != nullptr))
+        {
+            for (size_t i = from; i < m_data_->length; ++i)
+            {
+                m_data_->index->insert(m_data_->elements, i);
+            }
+        }
+    }
+}
+
+// References pinned by checked iterators are not sharers
+// A read-only mapping always forks, even from its last handle
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::must_fork() const
+{
+    return HLM_UNLIKELY(m_data_->copy_on_write) &&
+           (m_data_->read_only || ThreadPolicy::load(m_data_->count) - ThreadPolicy::load(m_data_->pins) > 1);
+}
+
+// Kept out of line so detach() stays a single flag test in the hot paths
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::fork()
+{
+    HLM_INSTRUMENT_COUNT(m_data_, deep_copies);
+    Data* copy = Data::create(m_data_->elements, m_data_->length, *m_data_);
+    release_reference();
+    m_data_ = copy;
+}
+
+// Crititcal functionality !!! Do not modify
 // check validity
-template <typename T>
-inline bool HELIUM_API::SharedVector<T>::is_valid() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::is_valid() const
 {
-    if (m_data_ != nullptr && m_data_->vector != nullptr && (m_data_->count) != 0)
+    if (HLM_LIKELY(m_data_ != nullptr && ThreadPolicy::load(m_data_->count) != 0))
     {
         return true;
     }
     else
     {
-        throw std::runtime_error("Accessing null or released vector");
-        return false;
+        HLM::detail::throw_invalid_handle();
     }
 }
 
-template <typename T>
-inline T& HELIUM_API::SharedVector<T>::DefaultValue()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::DefaultValue()
 {
     static T default_value;
     return default_value;
 }
 
-template <typename T>
-inline size_t HELIUM_API::SharedVector<T>::ref_count()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::ref_count()
 {
-    return m_data_->count;
+    return ThreadPolicy::load(m_data_->count);
 }
 
-template <typename T>
-inline const size_t HELIUM_API::SharedVector<T>::ref_count() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::ref_count() const
 {
-    return m_data_->count;
+    return ThreadPolicy::load(m_data_->count);
 }
 
-template <typename T>
-inline size_t HELIUM_API::SharedVector<T>::data_id()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::data_id()
 {
     return m_data_->UUID;
 }
 
-template <typename T>
-inline const size_t HELIUM_API::SharedVector<T>::data_id() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::data_id() const
 {
     return m_data_->UUID;
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::SharedVector() : m_data_(new Data()) {}
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::live_instances()
+{
+    return HLM::LeakTracker<Data>::live_count();
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline std::pmr::memory_resource* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::get_resource() const
+{
+    return (is_valid()) ? m_data_->resource : nullptr;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::is_mapped() const
+{
+    return (is_valid()) ? (m_data_->mapping != nullptr) : false;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HLM::instrument::Counters HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::counters() const
+{
+    HLM::instrument::Counters block;
+    if (is_valid())
+    {
+#ifdef HLM_INSTRUMENT
+        block = m_data_->counters.snapshot(m_data_->reserved * sizeof(T), m_data_->length * sizeof(T));
+#else
+        block[HLM::instrument::bytes_reserved] = static_cast<std::int64_t>(m_data_->reserved * sizeof(T));
+        block[HLM::instrument::bytes_used]     = static_cast<std::int64_t>(m_data_->length * sizeof(T));
+#endif
+    }
+    return block;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector() : m_data_(Data::create(0)) {}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(const std::vector<T>&& externalVector, const int& move_semantic)
+{
+    (void)move_semantic;
+    m_data_ = Data::create(externalVector.data(), externalVector.size());
+}
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::SharedVector(const std::vector<T>&& externalVector, const bool& move_semantic)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(const std::vector<T>& externalVector, const int& move_semantic)
 {
-    if (move_semantic == HLM_COPY)
+    (void)move_semantic;
+    m_data_ = Data::create(externalVector.data(), externalVector.size());
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(const HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>& externalVector, const int& move_semantic)
+{
+    if (move_semantic == HLM_MOVE || move_semantic == HLM_COW)
     {
-        m_data_ = new Data(externalVector);
+        this->m_data_ = externalVector.m_data_;
+        HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+        ThreadPolicy::increment(this->m_data_->count);
+        if (move_semantic == HLM_COW)
+        {
+            this->m_data_->copy_on_write = true;
+        }
     }
     else
     {
-        m_data_ = (new Data());
-        *(m_data_->vector) = std::move(externalVector);
+        HLM_INSTRUMENT_COUNT(externalVector.m_data_, deep_copies);
+        m_data_ = Data::create(externalVector.m_data_->elements, externalVector.m_data_->length, *externalVector.m_data_);
     }
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::SharedVector(const std::vector<T>& externalVector, const bool& move_semantic)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+template <typename E>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(const HLM::Expression<E>& expression) : m_data_(Data::create(0))
 {
-    if (move_semantic == HLM_COPY)
+    HLM::assign(*this, expression);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(std::pmr::memory_resource* resource) : m_data_(Data::create(0, resource)) {}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(const std::vector<T>& externalVector, std::pmr::memory_resource* resource)
+    : m_data_(Data::create(externalVector.data(), externalVector.size(), resource)) {}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::SharedVector(const SharedVector& externalVector, std::pmr::memory_resource* resource)
+    : m_data_(Data::create(externalVector.m_data_->elements, externalVector.m_data_->length, resource))
+{
+    HLM_INSTRUMENT_COUNT(externalVector.m_data_, deep_copies);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy> HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::adopt_mapping(const HLM::MappedRegion& region, const size_t& offset, const size_t& count, const int& mode)
+{
+    Data* data;
+    try
     {
-        m_data_ = new Data(externalVector);
+        data = Data::create(0);
     }
-    else
+    catch (...)
     {
-        m_data_ = (new Data());
-        *(m_data_->vector) = std::move(externalVector);
+        HLM::unmap_region(region.address, region.bytes);
+        throw;
     }
+    if (count == 0)
+    {
+        HLM::unmap_region(region.address, region.bytes);
+        return SharedVector(data);
+    }
+    HLM_INSTRUMENT_RESIZE(bytes_reserved, data->reserved, count);
+    HLM_MEMORY_ACCOUNT(data->reserved, count);
+    HLM_INSTRUMENT_RESIZE(bytes_used, 0, count);
+    data->elements      = reinterpret_cast<T*>(static_cast<char*>(region.address) + offset);
+    data->length        = count;
+    data->reserved      = count;
+    data->mapping       = region.address;
+    data->mapped_bytes  = region.bytes;
+    data->read_only     = (mode != HLM_MAP_PRIVATE);
+    data->copy_on_write = data->read_only;
+    return SharedVector(data);
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::SharedVector(const HELIUM_API::SharedVector<T>& externalVector, const bool& move_semantic)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy> HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::map_file(const std::string& path, const int& mode)
 {
-    std::atexit(Data::checkGlobalCount);
-    if (move_semantic == HLM_MOVE)
+    static_assert(std::is_trivially_copyable<T>::value, "SharedVector::map_file : T must be trivially copyable");
+    const HLM::MappedRegion region = HLM::map_region(path, mode == HLM_MAP_PRIVATE);
+    if (region.bytes % sizeof(T) != 0)
     {
-        this->m_data_ = externalVector.m_data_;
-        ++(this->m_data_->count);
+        HLM::unmap_region(region.address, region.bytes);
+        throw std::runtime_error("HLM::map_file : size of " + path + " is not a multiple of sizeof(T)");
     }
-    else
+    return adopt_mapping(region, 0, region.bytes / sizeof(T), mode);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy> HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::map_saved(const std::string& path, const int& mode, const bool& verify)
+{
+    const HLM::MappedRegion region = HLM::map_region(path, mode == HLM_MAP_PRIVATE);
+    HLM::SavedPayload payload;
+    try
     {
-        m_data_ = (new Data((*externalVector.m_data_->vector)));
+        payload = HLM::parse_saved<T>(region.address, region.bytes, verify);
     }
+    catch (...)
+    {
+        HLM::unmap_region(region.address, region.bytes);
+        throw;
+    }
+    return adopt_mapping(region, payload.offset, payload.count, mode);
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::~SharedVector()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::~SharedVector()
 {
     release_reference();
 }
 
-template <typename T>
-inline const HELIUM_API::SharedVector<T>& HELIUM_API::SharedVector<T>::operator=(const std::vector<T>&& externalVector)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator=(const std::vector<T>&& externalVector)
 {
-    delete_vector();
-    (m_data_->vector) = new std::vector<T>(std::move(externalVector));
+    if (must_fork())
+    {
+        Data* fresh = Data::create(externalVector.data(), externalVector.size(), *m_data_);
+        release_reference();
+        m_data_ = fresh;
+        return *this;
+    }
+    m_data_->drop_index();
+    m_data_->assign(externalVector.data(), externalVector.size());
     return *this;
 }
 
-template <typename T>
-inline const HELIUM_API::SharedVector<T>& HELIUM_API::SharedVector<T>::operator=(const std::vector<T>& externalVector)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator=(const std::vector<T>& externalVector)
 {
-    delete_vector();
-    (m_data_->vector) = new std::vector<T>(std::move(externalVector));
+    if (must_fork())
+    {
+        Data* fresh = Data::create(externalVector.data(), externalVector.size(), *m_data_);
+        release_reference();
+        m_data_ = fresh;
+        return *this;
+    }
+    m_data_->drop_index();
+    m_data_->assign(externalVector.data(), externalVector.size());
     return *this;
 }
 
-template <typename T>
-inline const HELIUM_API::SharedVector<T>& HELIUM_API::SharedVector<T>::operator=(const HELIUM_API::SharedVector<T>& externalVector)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator=(const HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>& externalVector)
 {
+    if (m_data_ == externalVector.m_data_)
+    {
+        return *this;
+    }
     release_reference();
     this->m_data_ = externalVector.m_data_;
-    ++(this->m_data_->count);
+    HLM_INSTRUMENT_COUNT(m_data_, refcount_increments);
+    ThreadPolicy::increment(this->m_data_->count);
     return *this;
 }
 
-template <typename T>
-inline bool HELIUM_API::SharedVector<T>::operator==(const SharedVector& other) const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+template <typename E>
+inline const HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator=(const HLM::Expression<E>& expression)
+{
+    HLM::assign(*this, expression);
+    return *this;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator==(const SharedVector& other) const
 {
     return (m_data_ == other.m_data_);
 }
 
-template <typename T>
-inline bool HELIUM_API::SharedVector<T>::operator!=(const SharedVector& other) const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator!=(const SharedVector& other) const
 {
     return !(m_data_ == other.m_data_);
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T> HELIUM_API::SharedVector<T>::operator+(const SharedVector& other) const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy> HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator+(const SharedVector& other) const
 {
-    SharedVector result;
-
-    if (is_valid())
+    if (is_valid() && other.is_valid())
     {
-        result.m_data_->vector = new std::vector<T>(*m_data_->vector);
-
-        if (other.is_valid())
-        {
-            result.m_data_->vector->insert(result.m_data_->vector->end(), other.m_data_->vector->begin(), other.m_data_->vector->end());
-        }
+        HLM_INSTRUMENT_COUNT(m_data_, deep_copies);
+        HLM_INSTRUMENT_COUNT(other.m_data_, deep_copies);
+        // One allocation sized for both halves
+        Data* result = Data::create(m_data_->length + other.m_data_->length, *m_data_);
+        SharedVector concatenated(result);
+        result->append(m_data_->elements, m_data_->length);
+        result->append(other.m_data_->elements, other.m_data_->length);
+        return concatenated;
     }
-    return result;
+    return SharedVector();
 }
 
-template <typename T>
-inline HELIUM_API::SharedVector<T>::operator std::vector<T>() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator std::vector<T>() const
 {
     if (is_valid())
     {
-        return *(m_data_->vector);
+        HLM_INSTRUMENT_COUNT(m_data_, deep_copies);
+        return std::vector<T>(m_data_->elements, m_data_->elements + m_data_->length);
     }
     else
     {
@@ -257,30 +829,22 @@ inline HELIUM_API::SharedVector<T>::operator std::vector<T>() const
     }
 }
 
-template <typename T>
-inline T& HELIUM_API::SharedVector<T>::fast_access(const size_t& index)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::fast_access(const size_t& index)
 {
-    return (*m_data_->vector)[static_cast<size_t>(index)];
+    detach();
+    return m_data_->elements[index];
 }
 
-template <typename T>
-inline T& HELIUM_API::SharedVector<T>::operator[](const int& index)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator[](const int& index)
 {
-    if (is_valid())
+    if (!BoundsPolicy::validates_handle || is_valid())
     {
-        if (index >= 0 && static_cast<size_t>(index) < m_data_->vector->size())
-        {
-            return (*m_data_->vector)[static_cast<size_t>(index)];
-        }
-        else if (index < 0 && static_cast<size_t>(-index) <= m_data_->vector->size())
-        {
-            return (*m_data_->vector)[m_data_->vector->size() - static_cast<size_t>(-index)];
-        }
-        else
-        {
-            std::cerr << "\nWarning : Index " << index << " out of bound. Returning default value \n";
-            return back();
-        }
+        detach();
+        const size_t position = HLM::wrap_index(index, m_data_->length);
+        HLM_INSTRUMENT_BOUNDS(m_data_, position);
+        return BoundsPolicy::at(m_data_->elements, m_data_->length, position, DefaultValue());
     }
     else
     {
@@ -288,20 +852,14 @@ inline T& HELIUM_API::SharedVector<T>::operator[](const int& index)
     }
 }
 
-template <typename T>
-inline T& HELIUM_API::SharedVector<T>::operator[](const size_t& index)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator[](const size_t& index)
 {
-    if (is_valid())
+    if (!BoundsPolicy::validates_handle || is_valid())
     {
-        if ((index) < m_data_->vector->size())
-        {
-            return (*m_data_->vector)[(index)];
-        }
-        else
-        {
-            std::cerr << "\nWarning : Index " << index << " out of bound. Returning back or default value \n";
-            return back();
-        }
+        detach();
+        HLM_INSTRUMENT_BOUNDS(m_data_, index);
+        return BoundsPolicy::at(m_data_->elements, m_data_->length, index, DefaultValue());
     }
     else
     {
@@ -309,24 +867,14 @@ inline T& HELIUM_API::SharedVector<T>::operator[](const size_t& index)
     }
 }
 
-template <typename T>
-inline const T& HELIUM_API::SharedVector<T>::operator[](const int index) const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator[](const int index) const
 {
-    if (is_valid())
+    if (!BoundsPolicy::validates_handle || is_valid())
     {
-        if (index >= 0 && static_cast<size_t>(index) < m_data_->vector->size())
-        {
-            return (*m_data_->vector)[static_cast<size_t>(index)];
-        }
-        else if (index < 0 && static_cast<size_t>(-index) <= m_data_->vector->size())
-        {
-            return (*m_data_->vector)[m_data_->vector->size() - static_cast<size_t>(-index)];
-        }
-        else
-        {
-            std::cerr << "\nWarning : Index " << index << " out of bound. Returning default value \n";
-            return back();
-        }
+        const size_t position = HLM::wrap_index(index, m_data_->length);
+        HLM_INSTRUMENT_BOUNDS(m_data_, position);
+        return BoundsPolicy::at(static_cast<const T*>(m_data_->elements), m_data_->length, position, DefaultValue());
     }
     else
     {
@@ -334,94 +882,140 @@ inline const T& HELIUM_API::SharedVector<T>::operator[](const int index) const
     }
 }
 
-template <typename T>
-inline const T* HELIUM_API::SharedVector<T>::data() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::operator[](const size_t& index) const
 {
-    return (is_valid() && size()) ? &(*(m_data_->vector))[0] : &(DefaultValue());
+    if (!BoundsPolicy::validates_handle || is_valid())
+    {
+        HLM_INSTRUMENT_BOUNDS(m_data_, index);
+        return BoundsPolicy::at(static_cast<const T*>(m_data_->elements), m_data_->length, index, DefaultValue());
+    }
+    else
+    {
+        return DefaultValue();
+    }
 }
 
-template <typename T>
-inline T* HELIUM_API::SharedVector<T>::data()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const T* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::data() const
 {
-    return (is_valid() && size()) ? &(*(m_data_->vector))[0] : &(DefaultValue());
+    return (is_valid() && size()) ? m_data_->elements : &(DefaultValue());
 }
 
-template <typename T>
-inline T& HELIUM_API::SharedVector<T>::back()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T* HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::data()
 {
-    return (is_valid() && size()) ? m_data_->vector->back() : DefaultValue();
+    if (is_valid())
+    {
+        detach();
+    }
+    return (is_valid() && size()) ? m_data_->elements : &(DefaultValue());
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::back()
+{
+    if (is_valid())
+    {
+        detach();
+    }
+    return (is_valid() && size()) ? m_data_->elements[m_data_->length - 1] : DefaultValue();
 }
 
-template <typename T>
-inline const T& HELIUM_API::SharedVector<T>::back() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::back() const
 {
-    return (is_valid() && size()) ? m_data_->vector->back() : DefaultValue();
+    return (is_valid() && size()) ? m_data_->elements[m_data_->length - 1] : DefaultValue();
 }
 
-template <typename T>
-inline T& HELIUM_API::SharedVector<T>::front()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::front()
 {
-    return (is_valid() && size()) ? m_data_->vector->front() : DefaultValue();
+    if (is_valid())
+    {
+        detach();
+    }
+    return (is_valid() && size()) ? m_data_->elements[0] : DefaultValue();
 }
 
-template <typename T>
-inline const T& HELIUM_API::SharedVector<T>::front() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::front() const
 {
-    return (is_valid() && size()) ? m_data_->vector->front() : DefaultValue();
+    return (is_valid() && size()) ? m_data_->elements[0] : DefaultValue();
 }
 
-template <typename T>
-inline size_t HELIUM_API::SharedVector<T>::size() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::size() const
 {
-    return (is_valid()) ? m_data_->vector->size() : 0;
+    return (is_valid()) ? m_data_->length : 0;
 }
 
-template <typename T>
-inline size_t HELIUM_API::SharedVector<T>::capacity() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::capacity() const
 {
-    return (is_valid()) ? m_data_->vector->capacity() : 0;
+    return (is_valid()) ? m_data_->reserved : 0;
 }
 
-template <typename T>
-inline size_t HELIUM_API::SharedVector<T>::max_capacity() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::max_capacity() const
 {
-    return (is_valid()) ? m_data_->vector->max_capacity() : 0;
+    return (is_valid()) ? std::numeric_limits<size_t>::max() / sizeof(T) : 0;
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::clear()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::clear()
 {
     if (is_valid())
     {
-        m_data_->vector->clear();
+        detach_keep_index();
+        m_data_->truncate(0);
+        if (m_data_->index != nullptr)
+        {
+            m_data_->index->clear();
+        }
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::push_back(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::push_back(const T& value)
 {
     if (is_valid())
     {
-        m_data_->vector->push_back(value);
+        detach_keep_index();
+        m_data_->push_back(value);
+        index_appended(m_data_->length - 1);
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::emplace_back(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::emplace_back(const T& value)
 {
     if (is_valid())
     {
-        m_data_->vector->emplace_back(value);
+        detach_keep_index();
+        m_data_->push_back(value);
+        index_appended(m_data_->length - 1);
     }
 }
 
-template <typename T>
-inline T HELIUM_API::SharedVector<T>::pop_back(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::pop_back(const T& value)
 {
-    if (is_valid())
+    (void)value;
+    if (is_valid() && size())
     {
-        T poped_data = m_data_->vector->back();
-        m_data_->vector->pop_back(value);
+        detach_keep_index();
+        const size_t last = m_data_->length - 1;
+        if constexpr (HLM::hashing::is_hashable<T>::value)
+        {
+            // recorded only when it is the first occurrence of its value
+            if (m_data_->index != nullptr && m_data_->index->find(m_data_->elements, m_data_->elements[last]) == last)
+            {
+                m_data_->index->erase(m_data_->elements, last);
+            }
+        }
+        T poped_data = m_data_->elements[last];
+        m_data_->truncate(last);
         return poped_data;
     }
     else
@@ -430,212 +1024,469 @@ inline T HELIUM_API::SharedVector<T>::pop_back(const T& value)
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::emplace(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::emplace(const T& value)
 {
     if (is_valid())
     {
-        m_data_->vector->emplace(value);
+        detach();
+        m_data_->insert_front(value);
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::resize(const size_t& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::resize(const size_t& value)
 {
     if (is_valid())
     {
-        m_data_->vector->resize(value);
+        detach();
+        m_data_->resize(value);
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::shrink_to_fit(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::resize_parallel(const size_t& value)
 {
     if (is_valid())
     {
-        m_data_->vector->shrink_to_fit(value);
+        detach();
+        m_data_->resize(value, HLM_PARALLEL);
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::insert(const SharedVector& other) const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::resize_uninitialized(const size_t& value)
 {
-    if (other.is_valid() && this->is_valid())
+    static_assert(std::is_trivially_default_constructible<T>::value && std::is_trivially_destructible<T>::value,
+                  "resize_uninitialized : T must be trivially default constructible and destructible");
+    if (is_valid())
     {
-        this->m_data_->vector->insert(this->m_data_->vector->end(), other.m_data_->vector->begin(), other.m_data_->vector->end());
+        detach();
+        m_data_->resize_uninitialized(value);
     }
 }
 
-template <typename T>
-inline typename std::vector<T>::iterator HELIUM_API::SharedVector<T>::begin()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::shrink_to_fit()
 {
     if (is_valid())
     {
-        return m_data_->vector->begin();
+        detach();
+        m_data_->shrink_to_fit();
     }
 }
 
-template <typename T>
-inline typename std::vector<T>::const_iterator HELIUM_API::SharedVector<T>::begin() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::shrink_to_fit(const T& value)
 {
-    if (is_valid())
+    (void)value;
+    shrink_to_fit();
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::insert(const SharedVector& other)
+{
+    if (other.is_valid() && this->is_valid())
     {
-        return m_data_->vector->begin();
+        detach_keep_index();
+        const size_t from = m_data_->length;
+        this->m_data_->append(other.m_data_->elements, other.m_data_->length);
+        index_appended(from);
     }
 }
 
-template <typename T>
-inline typename std::vector<T>::iterator HELIUM_API::SharedVector<T>::end()
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::iterator HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::begin()
 {
     if (is_valid())
     {
-        return m_data_->vector->end();
+        detach();
     }
+    return (is_valid()) ? HLM::IteratorSelect<Data, T>::make(m_data_, 0) : iterator();
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::const_iterator HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::begin() const
+{
+    return (is_valid()) ? HLM::IteratorSelect<Data, const T>::make(m_data_, 0) : const_iterator();
 }
 
-template <typename T>
-inline typename std::vector<T>::const_iterator HELIUM_API::SharedVector<T>::end() const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::iterator HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::end()
 {
     if (is_valid())
     {
-        return m_data_->vector->end();
+        detach();
     }
+    return (is_valid()) ? HLM::IteratorSelect<Data, T>::make(m_data_, m_data_->length) : iterator();
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::const_iterator HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::end() const
+{
+    return (is_valid()) ? HLM::IteratorSelect<Data, const T>::make(m_data_, m_data_->length) : const_iterator();
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::broadcast(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HLM::VectorView<HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>, BoundsPolicy> HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::slice(const size_t& offset, const size_t& length) const
+{
+    return HLM::VectorView<SharedVector, BoundsPolicy>(*this, offset, length);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::broadcast(const T& value, const bool& parallel)
 {
     if (is_valid())
     {
-        m_data_->vector->assign(size(), value);
+        // value may be one of the elements
+        const T copy(value);
+        detach();
+        if (parallel)
+        {
+            HLM::parallel::fill(m_data_->elements, m_data_->length, copy);
+        }
+        else
+        {
+            std::fill_n(m_data_->elements, m_data_->length, copy);
+        }
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::broadcast(BroadcastFunctor<T>& functor)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::broadcast(BroadcastFunctor<T>& functor)
 {
     if (is_valid())
     {
+        detach();
+        T* elements = m_data_->elements;
+        const size_t n = m_data_->length;
 #ifdef HLM_OMP_PARALLEL
 #pragma omp parallel for schedule(dynamic, 8)
 #endif
-        for (size_t i = 0; i < size(); ++i)
+        for (size_t i = 0; i < n; ++i)
         {
-            functor((*(m_data_->vector))[i]);
+            functor(elements[i]);
         }
     }
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::replace_with(const T& oldVal, const T& newVal)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+template <typename Function, typename>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::broadcast(Function&& function)
 {
     if (is_valid())
     {
-        std::replace(m_data_->vector->begin(), m_data_->vector->end(), oldVal, newVal);
+        detach();
+        T* elements = m_data_->elements;
+        const size_t n = m_data_->length;
+#ifdef HLM_OMP_PARALLEL
+#pragma omp parallel for schedule(static)
+#endif
+        for (size_t i = 0; i < n; ++i)
+        {
+            function(elements[i]);
+        }
     }
 }
 
-template <typename T>
-inline typename std::vector<T>::iterator HELIUM_API::SharedVector<T>::find_iter(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::replace_with(const T& oldVal, const T& newVal)
 {
     if (is_valid())
     {
-        return (std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
-    }
-    else
-    {
-        return m_data_->vector->end();
+        detach();
+        if constexpr (HLM::simd::is_accelerated<T>::value)
+        {
+            HLM::simd::replace(m_data_->elements, m_data_->length, oldVal, newVal);
+        }
+        else
+        {
+            std::replace(m_data_->elements, m_data_->elements + m_data_->length, oldVal, newVal);
+        }
     }
 }
 
-template <typename T>
-inline typename std::vector<T>::const_iterator HELIUM_API::SharedVector<T>::find_iter(const T& value) const
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::iterator HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::find_iter(const T& value)
 {
     if (is_valid())
     {
-        return (std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
+        const size_t index = find_index(value);
+        detach();
+        return HLM::IteratorSelect<Data, T>::make(m_data_, index);
     }
     else
     {
-        return m_data_->vector->end();
+        return end();
     }
 }
 
-template <typename T>
-inline T& HELIUM_API::SharedVector<T>::find(const T& value)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline typename HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::const_iterator HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::find_iter(const T& value) const
 {
     if (is_valid())
     {
-        return *(std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
+        return HLM::IteratorSelect<Data, const T>::make(m_data_, find_index(value));
     }
     else
     {
-        return *(m_data_->vector->end());
+        return end();
     }
 }
 
-template <typename T>
-inline const T& HELIUM_API::SharedVector<T>::find(const T& value) const
+// Returns DefaultValue() when the value is not present
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::find(const T& value)
 {
     if (is_valid())
     {
-        return *(std::find(m_data_->vector->begin(), m_data_->vector->end(), value));
+        // look up first : a miss hands out no reference and keeps the index
+        const size_t index = find_index(value);
+        if (index == m_data_->length)
+        {
+            return DefaultValue();
+        }
+        detach();
+        return m_data_->elements[index];
     }
-    else
+    return DefaultValue();
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline const T& HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::find(const T& value) const
+{
+    if (is_valid())
     {
-        return *(m_data_->vector->end());
+        const size_t index = find_index(value);
+        return (index != m_data_->length) ? m_data_->elements[index] : DefaultValue();
     }
+    return DefaultValue();
 }
 
 // Reduce the vector using a functor
-template <typename T>
-inline T HELIUM_API::SharedVector<T>::reduce(const ReduceFunctor<T>& functor) {
-    if (is_valid()) {
-        T accum = (*this)[0];
+// The functor is called as functor(element, accum), partial results as functor(right, left)
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::reduce(const ReduceFunctor<T>& functor, const bool& deterministic) {
+    if (is_valid() && m_data_->length != 0) {
+        return HLM::parallel::reduce(m_data_->elements, m_data_->length,
+                                     [&functor](const T& accum, const T& element) { return functor(element, accum); },
+                                     deterministic);
+    } else {
+        return DefaultValue();
+    }
+}
 
-        for (size_t i = 1; i < size(); ++i) {
-            accum = functor((*this)[i], accum);
+// Reduce the vector using any callable, accumulator first
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+template <typename Function, typename>
+inline T HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::reduce(Function&& function, const bool& deterministic) const {
+    if (is_valid() && m_data_->length != 0) {
+        if constexpr (IsPlus<Function>::value && HLM::simd::is_accelerated<T>::value) {
+            return sum(deterministic);
         }
-        return accum;
+        return HLM::parallel::reduce(m_data_->elements, m_data_->length, function, deterministic);
     } else {
         return DefaultValue();
     }
 }
 
+// Integer sums wrap, so any order gives the same result and the SIMD kernels are used in both modes
+// Deterministic floating point sums keep the serial fold inside each chunk
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::sum(const bool& deterministic) const {
+    if (!is_valid() || m_data_->length == 0) {
+        return T();
+    }
+    const T* elements = m_data_->elements;
+    const size_t n = m_data_->length;
+    if constexpr (HLM::simd::is_accelerated<T>::value) {
+        if (std::is_integral<T>::value || !deterministic) {
+            return HLM::parallel::reduce_range(n, T(),
+                                               [elements](const size_t& begin, const size_t& end) {
+                                                   return HLM::simd::sum(elements + begin, end - begin);
+                                               },
+                                               HLM::simd::scalar::add<T>, deterministic);
+        }
+    }
+    return HLM::parallel::reduce(elements, n, std::plus<T>(), deterministic);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::min() const {
+    if (!is_valid() || m_data_->length == 0) {
+        return DefaultValue();
+    }
+    const T* elements = m_data_->elements;
+    auto smaller = [](const T& a, const T& b) { return (b < a) ? b : a; };
+    if constexpr (HLM::simd::is_accelerated<T>::value) {
+        return HLM::parallel::reduce_range(m_data_->length, elements[0],
+                                           [elements](const size_t& begin, const size_t& end) {
+                                               return HLM::simd::min(elements + begin, end - begin);
+                                           },
+                                           smaller, HLM_FAST);
+    } else {
+        return HLM::parallel::reduce(elements, m_data_->length, smaller, HLM_FAST);
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::max() const {
+    if (!is_valid() || m_data_->length == 0) {
+        return DefaultValue();
+    }
+    const T* elements = m_data_->elements;
+    auto larger = [](const T& a, const T& b) { return (a < b) ? b : a; };
+    if constexpr (HLM::simd::is_accelerated<T>::value) {
+        return HLM::parallel::reduce_range(m_data_->length, elements[0],
+                                           [elements](const size_t& begin, const size_t& end) {
+                                               return HLM::simd::max(elements + begin, end - begin);
+                                           },
+                                           larger, HLM_FAST);
+    } else {
+        return HLM::parallel::reduce(elements, m_data_->length, larger, HLM_FAST);
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline T HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::dot(const SharedVector& other, const bool& deterministic) const {
+    if (!is_valid() || !other.is_valid() || m_data_->length != other.m_data_->length) {
+        throw std::runtime_error("dot : vectors of different sizes");
+    }
+    const T* a = m_data_->elements;
+    const T* b = other.m_data_->elements;
+    const size_t n = m_data_->length;
+    if (n == 0) {
+        return T();
+    }
+    if constexpr (HLM::simd::is_accelerated<T>::value) {
+        if (std::is_integral<T>::value || !deterministic) {
+            return HLM::parallel::reduce_range(n, T(),
+                                               [a, b](const size_t& begin, const size_t& end) {
+                                                   return HLM::simd::dot(a + begin, b + begin, end - begin);
+                                               },
+                                               HLM::simd::scalar::add<T>, deterministic);
+        }
+    }
+    return HLM::parallel::reduce_range(n, T(),
+                                       [a, b](const size_t& begin, const size_t& end) {
+                                           T accum = a[begin] * b[begin];
+                                           for (size_t i = begin + 1; i < end; ++i) {
+                                               accum = accum + a[i] * b[i];
+                                           }
+                                           return accum;
+                                       },
+                                       std::plus<T>(), deterministic);
+}
+
 // Filter the vector to remove duplicates
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::filter() {
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::sort(const bool& parallel) {
+    sort(std::less<T>(), parallel);
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+template <typename Compare, typename>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::sort(Compare cmp, const bool& parallel) {
+    if (is_valid()) {
+        detach();
+        HLM::sorting::sort(m_data_->elements, m_data_->length, cmp, parallel);
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::filter(const bool& parallel) {
+    if (is_valid()) {
+        detach();
+        HLM::sorting::sort(m_data_->elements, m_data_->length, std::less<T>(), parallel);
+        m_data_->truncate(HLM::sorting::unique(m_data_->elements, m_data_->length, parallel));
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::filter_stable() {
     if (is_valid()) {
-        std::sort(m_data_->vector->begin(), m_data_->vector->end());
-        m_data_->vector->erase(std::unique(m_data_->vector->begin(), m_data_->vector->end()), m_data_->vector->end());
+        detach();
+        m_data_->truncate(HLM::hashing::unique_stable(m_data_->elements, m_data_->length));
     }
 }
 
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::build_index() {
+    static_assert(HLM::hashing::is_hashable<T>::value, "SharedVector::build_index : T needs a std::hash specialisation");
+    if (is_valid()) {
+        detach_keep_index();
+        if (m_data_->index == nullptr) {
+            m_data_->index = new HLM::hashing::IndexTable<T>(m_data_->length);
+        }
+        m_data_->index->rebuild(m_data_->elements, m_data_->length);
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::drop_index() {
+    if (is_valid()) {
+        m_data_->drop_index();
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::has_index() const {
+    return is_valid() && m_data_->index != nullptr;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline size_t HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::index_of(const T& value) const {
+    return (is_valid()) ? find_index(value) : 0;
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline bool HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::contains(const T& value) const {
+    return is_valid() && find_index(value) != m_data_->length;
+}
+
 // Swap external vector with internal
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::swap(const SharedVector& externalVector) {
-    const Data* temp = this->m_data_;
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::swap(SharedVector& externalVector) {
+    Data* temp = this->m_data_;
     this->m_data_ = externalVector.m_data_;
     externalVector.m_data_ = temp;
 }
 
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::swap(const std::vector<T>& externalVector) {
-    std::vector<T> temp    = std::move(*(this->m_data_->vector));
-    this->m_data_->vector  = std::move(externalVector.m_data_->vector);
-    externalVector.m_data_ = std::move(temp);
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::swap(std::vector<T>& externalVector) {
+    if (is_valid()) {
+        detach();
+        std::vector<T> temp(m_data_->elements, m_data_->elements + m_data_->length);
+        m_data_->assign(externalVector.data(), externalVector.size());
+        externalVector = std::move(temp);
+    }
 }
 
 // Display the vector content
-template <typename T>
-inline void HELIUM_API::SharedVector<T>::display() const {
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::display() const {
     if (is_valid()) {
         std::cout << "SharedVector content: ";
-        const HELIUM_API::SharedVector<T>& temp = *this;
+        const HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>& temp = *this;
         for (size_t i = 0; i < size(); ++i) {
             std::cout << (temp[i]) << " ";
         }
         std::cout << "\n";
-    } 
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline void HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::save(std::ostream& out) const
+{
+    if (is_valid())
+    {
+        HLM::save(out, *this);
+    }
+}
+
+template <typename T, typename ThreadPolicy, size_t InlineCapacity, typename BoundsPolicy>
+inline HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy> HELIUM_API::SharedVector<T, ThreadPolicy, InlineCapacity, BoundsPolicy>::load(std::istream& in, const bool& verify)
+{
+    return HLM::load<SharedVector>(in, verify);
 }
 #endif
@@ -1,11 +1,34 @@
 #pragma once
-#ifndef _HLM_SMART_VECTOR_HPP_
-#define _HLM_SMART_VECTOR_HPP_
+#ifndef _HLM_SHARED_VECTOR_H_
+#define _HLM_SHARED_VECTOR_H_
 #include <iostream>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
 #include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <functional>
+#include <string>
+#include "../hlm_config.hpp"
+#include "../hlm_thread_policy.hpp"
+#include "../hlm_leak_tracker.hpp"
+#include "../hlm_parallel.hpp"
+#include "../hlm_simd.hpp"
+#include "../hlm_expr.hpp"
+#include "../hlm_memory_resource.hpp"
+#include "../hlm_bounds.hpp"
+#include "../hlm_vector_view.hpp"
+#include "../hlm_iterator.hpp"
+#include "../hlm_mmap.hpp"
+#include "../hlm_serialize.hpp"
+#include "../hlm_sort.hpp"
+#include "../hlm_hash.hpp"
+#include "../hlm_instrument.hpp"
+#include "../hlm_memory_registry.hpp"
 #ifdef HLM_OMP_PARALLEL
 #include <omp.h>
 #endif
@@ -17,6 +40,26 @@ namespace HELIUM_API {
 // Makes sense :) sometimes
 #define until while
 
+// Refcount policies : SharedVector<T, SingleThreaded> skips the atomics
+using HLM::SingleThreaded;
+using HLM::MultiThreaded;
+
+// Bounds-checking policies for operator[]
+using HLM::BoundsUnchecked;
+using HLM::BoundsAssert;
+using HLM::BoundsClamp;
+using HLM::BoundsThrow;
+using HLM::BoundsTrap;
+using HLM::BoundsWarn;
+
+// Zero-copy subranges
+using HLM::VectorView;
+using HLM::partition;
+
+// Publication handle, see hlm_atomic_vector.h
+template <typename T, size_t InlineCapacity, typename BoundsPolicy>
+class AtomicSharedVector;
+
 template <typename T>
 class ReduceFunctor {
 public:
@@ -34,43 +77,124 @@ public:
 /// @brief class HLM::SharedVector
 /// A safe vector container to prevent dangling references or pointers
 /// Never exposes the data pointer or reference outside 
-template <typename T>
+/// ThreadPolicy selects the refcount implementation (MultiThreaded by default)
+/// InlineCapacity is the minimum number of elements stored inside the control block itself :
+/// up to that size a vector costs a single allocation, elements spill to the heap only on overflow
+/// BoundsPolicy decides what operator[] does with an out-of-range index (see hlm_bounds.hpp),
+/// HLM::BoundsUnchecked compiles it down to a raw array access
+template <typename T, typename ThreadPolicy = MultiThreaded, size_t InlineCapacity = 0, typename BoundsPolicy = HLM::BoundsWarn>
 class SharedVector {
 private:
     /// @brief struct Data
-    // Data struct is a simple way to create & manage the vector container
+    // Data struct is the control block of a SharedVector
+    // The refcount, UUID, size/capacity and the element storage share a single allocation
+    // (make_shared style) :  [ Data | padding | T[inline_reserved] ]
+    // The tail holds at least InlineCapacity elements (more when created from a larger range)
+    // Elements only spill to a separate heap buffer once they outgrow the inline tail
     // SharedVector Will never expose the pointer or even a reference externaly 
     // Caution : Not meant for external use
-    struct Data {
-        static size_t& GlobalCount() {
-            static std::atomic<size_t> global_count = 0;
-            return global_count;
-        }
-
-        static void checkGlobalCount() {
-            if (GlobalCount() != 0) {
-                throw std::runtime_error("Not all instances have been deleted");
-            }
-        }
+    // The UUID and the live-instance bookkeeping come from the LeakTracker node
+    struct Data : public HLM::LeakTracker<Data>::Node {
         // Caution : Not meant for external use
-        std::vector<T>* vector;
-        std::atomic<size_t> count;
-        size_t UUID;
+        T* elements;               // inline tail or spilled heap buffer
+        size_t length;
+        size_t reserved;
+        size_t inline_reserved;    // slots in the tail of this allocation
+        size_t alignment;          // of the elements : alignof(T), or more from an AlignedResource
+        size_t generation;         // bumped whenever elements moves, checked iterators compare it
+        bool copy_on_write;        // set once a HLM_COW handle shares this block
+        bool read_only;            // elements is a read-only file mapping, forked before the first write
+        void* mapping;             // file mapping elements points into (the payload may start further in)
+        size_t mapped_bytes;       // size of that mapping
+        std::pmr::memory_resource* resource;   // block and element buffer source, nullptr : operator new
+        HLM::hashing::IndexTable<T>* index;    // lookup index of find(), nullptr unless build_index()
+#ifdef HLM_INSTRUMENT
+        HLM::instrument::BlockCounters counters;
+#endif
+        typename ThreadPolicy::counter_type count;
+        typename ThreadPolicy::counter_type pins;    // part of count held by checked iterators
+
+        // Allocate a block whose inline tail can hold 'capacity' elements
+        // The element alignment of resource is looked up here, when a resource is attached :
+        // blocks made from an existing one take its resource and alignment through 'like'
+        inline static Data* create(const size_t& capacity, std::pmr::memory_resource* resource = nullptr);
+        inline static Data* create(const size_t& capacity, const Data& like);
+        // Copy of [first, first + n)
+        inline static Data* create(const T* first, const size_t& n, std::pmr::memory_resource* resource = nullptr);
+        inline static Data* create(const T* first, const size_t& n, const Data& like);
+        // create() without the budget check
+        inline static Data* allocate(const size_t& capacity, std::pmr::memory_resource* resource, const size_t& alignment);
+        // Fill the empty block data with [first, first + n), the budget is checked once the elements
+        // are copied : the shrink pass may reallocate the block first points into
+        inline static Data* copy_in(Data* data, const T* first, const size_t& n);
+        inline static void destroy(Data* data);
+        // References held by checked iterators (see hlm_iterator.hpp), ignored by detach()
+        inline void pin();
+        inline bool unpin();
+        inline void drop_index();
+        // Memory registry (see hlm_memory_registry.hpp)
+        inline void describe(HLM::memory::BlockInfo& info) const;
+        inline size_t try_shrink();
 
-        inline Data();
-        inline Data(const std::vector<T>&  externalVector);
-        inline Data(const std::vector<T>&& externalVector);
+        inline T* inline_storage();
+        inline bool is_inline() const;
+        inline void reserve(const size_t& new_capacity);
+        inline void push_back(const T& value);
+        inline void insert_front(const T& value);
+        inline void append(const T* first, const size_t& n);
+        inline void assign(const T* first, const size_t& n);
+        // parallel : the new elements are value-initialised by the parallel workers (first touch)
+        inline void resize(const size_t& new_length, const bool& parallel = HLM_SERIAL);
+        // The new elements are left uninitialised, T is trivially default constructible
+        inline void resize_uninitialized(const size_t& new_length);
+        inline void truncate(const size_t& new_length);
+        inline void shrink_to_fit();
+
+    private:
+        inline Data(const size_t& capacity, std::pmr::memory_resource* resource, const size_t& alignment);
         inline ~Data();
+
+        inline size_t grown_capacity(const size_t& min_capacity) const;
+        inline static void* allocate_bytes(std::pmr::memory_resource* resource, const size_t& bytes, const size_t& alignment);
+        inline static void deallocate_bytes(std::pmr::memory_resource* resource, void* memory, const size_t& bytes, const size_t& alignment);
+        inline T* allocate_elements(const size_t& n);
+        inline void deallocate_elements(T* buffer, const size_t& n);
+
+        static constexpr size_t block_alignment(const size_t& alignment) {
+            return alignment > alignof(Data) ? alignment : alignof(Data);
+        }
+        // The inline tail starts on the element alignment
+        static constexpr size_t tail_offset(const size_t& alignment) {
+            return (sizeof(Data) + alignment - 1) / alignment * alignment;
+        }
     };
 
     Data* m_data_;
 
+    // Publishes and adopts blocks through their refcount
+    template <typename, size_t, typename> friend class AtomicSharedVector;
+
     // Caution : Not meant for external use
-    // Only meant for reassigning new vector
-    // Delete the data and move new copy
-    inline void delete_vector();
-    inline void force_delete_data();
+    // Adopt a freshly created block (refcount already 1)
+    inline explicit SharedVector(Data* data);
+
     inline void release_reference();
+    // Index of the first element equal to value, length when absent
+    inline size_t find_index(const T& value) const;
+
+    // Copy-on-write : every mutating member calls detach() first
+    // If the block is in COW mode and shared, this handle forks a private copy
+    // Any write may change the elements, so detach() also drops the lookup index
+    inline void detach();
+    // detach() for the members that keep the lookup index up to date themselves
+    inline void detach_keep_index();
+    // Record the elements appended at [from, length) in the lookup index
+    inline void index_appended(const size_t& from);
+    // detach() would fork : shared copy-on-write block, or read-only mapping
+    inline bool must_fork() const;
+    // Wrap count elements at offset bytes into a file mapping, released with the block
+    inline static SharedVector adopt_mapping(const HLM::MappedRegion& region, const size_t& offset, const size_t& count, const int& mode);
+    HLM_NOINLINE void fork();
 
     inline T* operator&();
     inline T& operator*();
@@ -81,8 +205,36 @@ private:
     void* operator new(std::size_t);
     void  operator delete(void*);
 
+    // Keep the callable overloads away from values and from the virtual functor classes
+    template <typename Function>
+    using EnableIfBroadcastCallable = typename std::enable_if<
+        !std::is_base_of<BroadcastFunctor<T>, typename std::decay<Function>::type>::value &&
+        std::is_invocable<Function&, T&>::value>::type;
+
+    template <typename Function>
+    using EnableIfReduceCallable = typename std::enable_if<
+        !std::is_base_of<ReduceFunctor<T>, typename std::decay<Function>::type>::value &&
+        std::is_invocable_r<T, Function&, const T&, const T&>::value>::type;
+
+    template <typename Compare>
+    using EnableIfCompare = typename std::enable_if<
+        std::is_invocable_r<bool, Compare&, const T&, const T&>::value>::type;
+
+    // reduce(std::plus) is routed to the SIMD sum
+    template <typename Function>
+    using IsPlus = std::integral_constant<bool,
+        std::is_same<typename std::decay<Function>::type, std::plus<T>>::value ||
+        std::is_same<typename std::decay<Function>::type, std::plus<>>::value>;
+
 public:
 
+    typedef T        value_type;
+    typedef ReduceFunctor<T> reduce_functor_type;
+    typedef BroadcastFunctor<T> broadcast_functor_type;
+    // Raw pointers in release builds, generation-checked in debug builds (see hlm_iterator.hpp)
+    typedef typename HLM::IteratorSelect<Data, T>::type       iterator;
+    typedef typename HLM::IteratorSelect<Data, const T>::type const_iterator;
+
 ////////////////////////////////////////////////////////////////////////////////////////
 ////////  Smart & Safety check functions //////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////  
@@ -95,6 +247,14 @@ public:
     inline const size_t ref_count() const;
     inline size_t data_id();
     inline const size_t data_id() const;
+    // Number of live Data blocks of this type, merged across all threads
+    inline static size_t live_instances();
+    // Memory resource of the block, nullptr when it uses the global operator new
+    inline std::pmr::memory_resource* get_resource() const;
+    // True while the elements live in a file mapping
+    inline bool is_mapped() const;
+    // Counters of the block (see hlm_instrument.hpp), only the byte counters unless HLM_INSTRUMENT
+    inline HLM::instrument::Counters counters() const;
 
 ///////////////////////////////////////////////////////////////////////////////////////
 ///// Fancy Ways to Construct vector data with interoperability with std::vector //////
@@ -103,11 +263,38 @@ public:
     
     #define HLM_MOVE 1
     #define HLM_COPY 0
+    // Share the block until the first mutation, then fork a private copy
+    // Once a block is shared in COW mode every holder forks on write, aliasing writes are no longer visible
+    // Switch a block to COW mode before handing handles to other threads
+    #define HLM_COW  2
 
     inline SharedVector();
-    inline SharedVector(const std::vector<T>&  externalVector, const bool& move_semantic = HLM_MOVE);    
-    inline SharedVector(const std::vector<T>&& externalVector, const bool& move_semantic = HLM_MOVE);
-    inline SharedVector(const SharedVector<T>& externalVector, const bool& move_semantic = HLM_MOVE);
+    inline SharedVector(const std::vector<T>&  externalVector, const int& move_semantic = HLM_MOVE);    
+    inline SharedVector(const std::vector<T>&& externalVector, const int& move_semantic = HLM_MOVE);
+    inline SharedVector(const SharedVector& externalVector, const int& move_semantic = HLM_MOVE);
+    // Evaluate an element-wise expression, see hlm_expr.hpp
+    template <typename E>
+    inline explicit SharedVector(const HLM::Expression<E>& expression);
+    // Take the block and the element buffer from a memory resource (see hlm_memory_resource.hpp)
+    // nullptr selects the global operator new, the resource must outlive the block
+    inline explicit SharedVector(std::pmr::memory_resource* resource);
+    inline SharedVector(const std::vector<T>& externalVector, std::pmr::memory_resource* resource);
+    // Deep copy into another resource
+    inline SharedVector(const SharedVector& externalVector, std::pmr::memory_resource* resource);
+
+    // Back the vector with a whole file (mmap on POSIX, see hlm_mmap.hpp), T must be trivially copyable
+    // and the file size a multiple of sizeof(T). Throws std::runtime_error when the file cannot be mapped
+    // The mapping is released with the last handle, or as soon as the vector outgrows it
+    // HLM_MAP_READONLY : pages shared with the page cache, the first mutable access (non-const
+    //                    operator[], begin(), data() ...) forks a private heap copy, read through const
+    // HLM_MAP_PRIVATE  : writable in place, modified pages are private to this process, never written back
+    #define HLM_MAP_READONLY 0
+    #define HLM_MAP_PRIVATE  1
+    inline static SharedVector map_file(const std::string& path, const int& mode = HLM_MAP_READONLY);
+    // Map a file written by save() in place, same modes (see hlm_serialize.hpp)
+    // HLM_SKIP_CHECKSUM avoids reading the whole file up front
+    inline static SharedVector map_saved(const std::string& path, const int& mode = HLM_MAP_READONLY,
+                                         const bool& verify = HLM_VERIFY_CHECKSUM);
     inline ~SharedVector();
 
 
@@ -118,7 +305,10 @@ public:
     // Assignment operator from external vector using move semantics
     inline const SharedVector& operator=(const std::vector<T>&  externalVector);
     inline const SharedVector& operator=(const std::vector<T>&& externalVector);
-    inline const SharedVector& operator=(const SharedVector<T>& externalVector);
+    inline const SharedVector& operator=(const SharedVector& externalVector);
+    // Evaluate an element-wise expression into this block in one fused loop (resized to fit)
+    template <typename E>
+    inline const SharedVector& operator=(const HLM::Expression<E>& expression);
 
     // Equality operator
     inline bool operator==(const SharedVector& other) const;
@@ -130,13 +320,16 @@ public:
     // Pass a Copy to external vec if the data is valid 
     inline operator std::vector<T>() const;
 
+    // Never checked, whatever the BoundsPolicy
     inline T& fast_access(const size_t& index);
     // Access element at index (allowing negative indices for reverse access)
+    // Out-of-range indices are handled by the BoundsPolicy
     inline T& operator[](const int& index);
     inline const T& operator[](const int index) const;
 
     // Access element at index
     inline T& operator[](const size_t& index);
+    inline const T& operator[](const size_t& index) const;
     
 //////////////////////////////////////////////////////////////////////////////////////////
 /////////// Wrapper functions around std::vector member functions
@@ -161,43 +354,110 @@ public:
     inline T pop_back(const T& value);
     inline void emplace(const T& value);
     inline void resize(const size_t& value = 0);
-    inline void shrink_to_fit(const T& value);
+    // resize() with the new elements value-initialised by the parallel workers, each over the block
+    // the parallel loops give it (see HLM::parallel::for_blocks) : on NUMA machines the pages are
+    // first touched, hence placed, where they are used. Serial without a parallel backend
+    inline void resize_parallel(const size_t& value);
+    // resize() leaving the new elements uninitialised (indeterminate until written) and their pages
+    // untouched, e.g. for a parallel broadcast to first-touch them
+    inline void resize_uninitialized(const size_t& value);
+    // Release the unused capacity : back into the inline tail, or into an exactly sized buffer
+    inline void shrink_to_fit();
+    // The value is ignored, kept for existing callers
+    [[deprecated("use shrink_to_fit()")]] inline void shrink_to_fit(const T& value);
     // insert an another vector to the front of this vector
-    inline void insert(const SharedVector& other) const;
-    // Traditional std::vector::iterators
-    inline typename std::vector<T>::iterator begin();
-    inline typename std::vector<T>::const_iterator begin() const;
-    inline typename std::vector<T>::iterator end();
-    inline typename std::vector<T>::const_iterator end() const;
+    inline void insert(const SharedVector& other);
+    // Iterators over the contiguous element storage
+    inline iterator begin();
+    inline const_iterator begin() const;
+    inline iterator end();
+    inline const_iterator end() const;
+    // Zero-copy view of [offset, offset + length) sharing this block, see hlm_vector_view.hpp
+    inline HLM::VectorView<SharedVector, BoundsPolicy> slice(const size_t& offset, const size_t& length = static_cast<size_t>(-1)) const;
 
 ////////////////////////////////////////////////////////////////////
 ////////// Fancy Functions  ////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////
 
     // Broadcast a value to all elements in the vector
-    inline void broadcast(const T& value);
+    // Serial by default, HLM_PARALLEL splits large vectors over the parallel workers, block by block
+    // like resize_parallel
+    inline void broadcast(const T& value, const bool& parallel = HLM_SERIAL);
     // Broadcast a functor to all elements in the vector
     inline void broadcast(BroadcastFunctor<T>& functor);
+    // Broadcast any callable void(T&) (lambda, function object) : no virtual dispatch,
+    // the call is inlined into a tight loop over the raw buffer
+    template <typename Function, typename = EnableIfBroadcastCallable<Function>>
+    inline void broadcast(Function&& function);
     // Reduce the vector using a functor
-    inline T reduce(const ReduceFunctor<T>& functor);
-    // Filter the vector to remove duplicates
-    inline void filter();
+    // Large vectors are reduced in parallel (HLM_OMP_PARALLEL or HLM_THREAD_PARALLEL), so the
+    // functor must be associative. HLM_DETERMINISTIC fixes the chunking and the combine order,
+    // which makes floating point results bit-reproducible across thread counts
+    #define HLM_FAST          0
+    #define HLM_DETERMINISTIC 1
+    inline T reduce(const ReduceFunctor<T>& functor, const bool& deterministic = HLM_FAST);
+    // Reduce with any callable T(const T& acc, const T& element), inlined like broadcast
+    template <typename Function, typename = EnableIfReduceCallable<Function>>
+    inline T reduce(Function&& function, const bool& deterministic = HLM_FAST) const;
+    // Arithmetic shortcuts, SIMD kernels for int32_t, int64_t, float and double (see hlm_simd.hpp)
+    // and parallel like reduce for large vectors
+    // Sum of the elements, T() when empty
+    inline T sum(const bool& deterministic = HLM_FAST) const;
+    // Smallest / largest element, DefaultValue() when empty
+    inline T min() const;
+    inline T max() const;
+    // Sum of the element-wise products, throws when the sizes differ
+    inline T dot(const SharedVector& other, const bool& deterministic = HLM_FAST) const;
+    // Sort in ascending order : radix sort for integer, float and double elements, merge sort
+    // otherwise (see hlm_sort.hpp). HLM_PARALLEL splits large vectors over the parallel workers
+    inline void sort(const bool& parallel = HLM_PARALLEL);
+    // Sort with a strict weak ordering bool(const T&, const T&), std::less still takes the radix path
+    template <typename Compare, typename = EnableIfCompare<Compare>>
+    inline void sort(Compare cmp, const bool& parallel = HLM_PARALLEL);
+    // Filter the vector to remove duplicates (sorts it), same engine as sort()
+    inline void filter(const bool& parallel = HLM_PARALLEL);
+    // Remove duplicates keeping the first occurrence of each value, in order (hash set, T hashable)
+    inline void filter_stable();
+
+    // Lookup index : a hash table of the first position of every value, attached to the block
+    // and shared by its handles, so find() / find_iter() / index_of() / contains() are O(1)
+    // push_back, emplace_back, insert, pop_back and clear update it, every other write drops it,
+    // including the non-const accessors handing out a writable reference (operator[], fast_access(),
+    // data(), begin() / end(), find_iter(), and find() when the value is found) even when they are
+    // only used to read : a loop mixing v[i] with lookups on a non-const handle drops the index at
+    // its first v[i] and every later lookup is a linear scan, until build_index() runs again
+    // Read through a const reference (std::as_const(v)[i]) to keep it, index_of() / contains()
+    // never drop it. T must be hashable (std::hash)
+    inline void build_index();
+    inline void drop_index();
+    inline bool has_index() const;
+    // Position of the first element equal to value, size() when absent
+    inline size_t index_of(const T& value) const;
+    inline bool contains(const T& value) const;
     // Replace elements in the vector equal to oldVal with a new value
     inline void replace_with(const T& oldVal, const T& newVal);
     // Find the iterator to the first occurrence of a value
-    inline typename std::vector<T>::iterator find_iter(const T& value);
-    inline typename std::vector<T>::const_iterator find_iter(const T& value) const;
+    inline iterator find_iter(const T& value);
+    inline const_iterator find_iter(const T& value) const;
     // Find the value by ref to the first occurrence of a value
     inline T& find(const T& value);
     inline const T& find(const T& value) const;
     // Swap external vector with internal uisng move semantics
-    inline void swap(const SharedVector&    externalVector);
-    inline void swap(const std::vector<T>&  externalVector);
+    inline void swap(SharedVector&    externalVector);
+    inline void swap(std::vector<T>&  externalVector);
     
     // Display the vector content
     inline void display() const;
+    // Versioned binary image, T must be trivially copyable (see hlm_serialize.hpp)
+    inline void save(std::ostream& out) const;
+    inline static SharedVector load(std::istream& in, const bool& verify = HLM_VERIFY_CHECKSUM);
 };
 
+/// @brief SmallSharedVector
+// SharedVector with room for N elements in its control block
+template <typename T, size_t N, typename ThreadPolicy = MultiThreaded>
+using SmallSharedVector = SharedVector<T, ThreadPolicy, N>;
+
 }  // namespace HELIUM_API
 
 #ifdef USE_HEADER_ONLY_IMPLEMENTATION
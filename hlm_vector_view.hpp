@@ -0,0 +1,258 @@
+#ifndef _HLM_VECTOR_VIEW_HPP_
+#define _HLM_VECTOR_VIEW_HPP_
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include "hlm_parallel.hpp"
+#include "hlm_simd.hpp"
+#include "hlm_bounds.hpp"
+#ifdef HLM_OMP_PARALLEL
+#include <omp.h>
+#endif
+
+// Zero-copy subrange of an HLM::Vector or a HELIUM_API::SharedVector :
+//
+//     SharedVector<float> v = ...;
+//     HLM::VectorView<SharedVector<float>> tail = v.slice(1000);          // elements [1000, size)
+//     std::vector<HLM::VectorView<SharedVector<float>>> parts = HLM::partition(v, 4);
+//
+// A view keeps a refcounted handle to the parent block (never a pointer), plus an offset and a length
+// The element pointer is read through the handle on every access, so the view never dangles :
+// when the parent grows it follows the new buffer, when the parent shrinks the view shrinks with it
+// Writes through a view are visible in the parent, except on a copy-on-write block (HLM_COW)
+// where the first write forks a private copy of the whole parent block, like any other holder
+// Views of MultiThreaded vectors can be handed to other threads, views of SingleThreaded ones cannot
+
+namespace HLM {
+
+/// @brief class VectorView
+// Container is the parent vector type, BoundsPolicy handles out-of-range indices in operator[]
+// (see hlm_bounds.hpp), fast_access() is never checked
+template <typename Container, typename BoundsPolicy = BoundsWarn>
+class VectorView {
+public:
+    typedef typename Container::value_type T;
+    typedef T        value_type;
+    typedef T*       iterator;
+    typedef const T* const_iterator;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // View of [offset, offset + length) of parent, clamped to the current parent size
+    explicit VectorView(const Container& parent, const size_t& offset = 0, const size_t& length = npos)
+    : handle_(parent), offset_(0), length_(0)
+    {
+        const size_t n = handle_.size();
+        offset_ = (offset < n) ? offset : n;
+        length_ = (length < n - offset_) ? length : n - offset_;
+    }
+
+    // Number of elements, less than the initial length once the parent has shrunk under the view
+    size_t size() const
+    {
+        const size_t n = handle_.size();
+        if (offset_ >= n) {
+            return 0;
+        }
+        return (length_ < n - offset_) ? length_ : n - offset_;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t offset() const { return offset_; }
+
+    // Same block as the parent (or its copy-on-write fork)
+    const Container& parent() const { return handle_; }
+
+    // Get data ie... the first element of the view
+    const T* data() const { return handle_.data() + first(); }
+    T* data() { return handle_.data() + first(); }
+
+    // Never checked, whatever the BoundsPolicy
+    T& fast_access(const size_t& index) { return data()[index]; }
+
+    // Access element at index (allowing negative indices for reverse access)
+    // Out-of-range indices are handled by the BoundsPolicy
+    T& operator[](const int& index)
+    {
+        const size_t n = size();
+        return BoundsPolicy::at(data(), n, wrap_index(index, n), Container::DefaultValue());
+    }
+
+    const T& operator[](const int index) const
+    {
+        const size_t n = size();
+        return BoundsPolicy::at(data(), n, wrap_index(index, n), Container::DefaultValue());
+    }
+
+    // Access element at index
+    T& operator[](const size_t& index)
+    {
+        return BoundsPolicy::at(data(), size(), index, Container::DefaultValue());
+    }
+
+    const T& operator[](const size_t& index) const
+    {
+        return BoundsPolicy::at(data(), size(), index, Container::DefaultValue());
+    }
+
+    // Sub-view of [offset, offset + length) relative to this view, clamped to this view
+    VectorView slice(const size_t& offset, const size_t& length = npos) const
+    {
+        const size_t n     = size();
+        const size_t first = (offset < n) ? offset : n;
+        VectorView view(*this);
+        view.offset_ = offset_ + first;
+        view.length_ = (length < n - first) ? length : n - first;
+        return view;
+    }
+
+    // Iterators over the viewed elements
+    iterator begin() { return data(); }
+    const_iterator begin() const { return data(); }
+    iterator end() { return data() + size(); }
+    const_iterator end() const { return data() + size(); }
+
+    // Copy of the viewed elements
+    operator std::vector<T>() const { return std::vector<T>(begin(), end()); }
+
+////////////////////////////////////////////////////////////////////
+////////// Fancy Functions  ////////////////////////////////////////
+////////////////////////////////////////////////////////////////////
+
+    // Broadcast a value to all elements in the view
+    void broadcast(const T& value)
+    {
+        std::fill_n(data(), size(), value);
+    }
+
+    // Broadcast any callable void(T&), BroadcastFunctor included
+    template <typename Function, typename = typename std::enable_if<std::is_invocable<Function&, T&>::value>::type>
+    void broadcast(Function&& function)
+    {
+        T* elements = data();
+        const size_t n = size();
+        #ifdef HLM_OMP_PARALLEL
+        #pragma omp parallel for schedule(static) if (n >= HLM_PARALLEL_THRESHOLD)
+        for (long i = 0; i < static_cast<long>(n); ++i) {
+            function(elements[i]);
+        }
+        #else
+        for (size_t i = 0; i < n; ++i) {
+            function(elements[i]);
+        }
+        #endif
+    }
+
+    // Reduce with the parent's ReduceFunctor, called as functor(element, accum) like the parent's reduce
+    // Parallel for large views like SharedVector::reduce, so the functor must be associative
+    // DefaultValue() when empty
+    T reduce(const typename Container::reduce_functor_type& functor, const bool& deterministic = false) const
+    {
+        const size_t n = size();
+        if (n == 0) {
+            return Container::DefaultValue();
+        }
+        return parallel::reduce(data(), n,
+                                [&functor](const T& accum, const T& element) { return functor(element, accum); },
+                                deterministic);
+    }
+
+    // Reduce with any other callable T(const T& acc, const T& element), accumulator first
+    // Same parallel split and empty result as above
+    template <typename Function, typename = typename std::enable_if<
+        !std::is_base_of<typename Container::reduce_functor_type, typename std::decay<Function>::type>::value>::type>
+    T reduce(Function&& function, const bool& deterministic = false) const
+    {
+        const size_t n = size();
+        if (n == 0) {
+            return Container::DefaultValue();
+        }
+        return parallel::reduce(data(), n,
+                                [&function](const T& acc, const T& element) { return function(acc, element); },
+                                deterministic);
+    }
+
+    // Replace elements in the view equal to oldVal with a new value
+    void replace_with(const T& oldVal, const T& newVal)
+    {
+        if constexpr (simd::is_accelerated<T>::value) {
+            simd::replace(data(), size(), oldVal, newVal);
+        }
+        else {
+            std::replace(begin(), end(), oldVal, newVal);
+        }
+    }
+
+    // Find the iterator to the first occurrence of a value, end() when absent
+    iterator find_iter(const T& value)
+    {
+        T* elements = data();
+        if constexpr (simd::is_accelerated<T>::value) {
+            return elements + simd::find(elements, size(), value);
+        }
+        else {
+            return std::find(elements, elements + size(), value);
+        }
+    }
+
+    const_iterator find_iter(const T& value) const
+    {
+        const T* elements = data();
+        if constexpr (simd::is_accelerated<T>::value) {
+            return elements + simd::find(elements, size(), value);
+        }
+        else {
+            return std::find(elements, elements + size(), value);
+        }
+    }
+
+    // Find the value by ref to the first occurrence of a value
+    // Returns DefaultValue() when the value is not present
+    T& find(const T& value)
+    {
+        iterator found = find_iter(value);
+        return (found != end()) ? *found : Container::DefaultValue();
+    }
+
+    const T& find(const T& value) const
+    {
+        const_iterator found = find_iter(value);
+        return (found != end()) ? *found : Container::DefaultValue();
+    }
+
+private:
+    // offset_ clamped to the current parent size, so data() stays within the parent buffer
+    size_t first() const
+    {
+        const size_t n = handle_.size();
+        return (offset_ < n) ? offset_ : n;
+    }
+
+    Container handle_;
+    size_t    offset_;
+    size_t    length_;
+};
+
+/// @brief partition
+// Split a vector into parts contiguous views of near-equal size (the OpenMP schedule(static) split),
+// e.g. one per worker thread. No element is copied
+template <typename Container>
+std::vector<VectorView<Container>> partition(const Container& vector, const size_t& parts)
+{
+    std::vector<VectorView<Container>> views;
+    if (parts == 0) {
+        return views;
+    }
+    const size_t n = vector.size();
+    views.reserve(parts);
+    for (size_t k = 0; k < parts; ++k) {
+        size_t begin, end;
+        parallel::static_range(n, parts, k, begin, end);
+        views.push_back(VectorView<Container>(vector, begin, end - begin));
+    }
+    return views;
+}
+
+} // namespace HLM
+#endif
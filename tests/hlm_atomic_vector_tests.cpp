@@ -0,0 +1,129 @@
+// AtomicSharedVector : readers crossing fold_threshold (2^14 loads of one publication) while a
+// writer keeps calling store(), so folds race with retirement. Every snapshot must stay whole
+// and every block must be reclaimed : live_instances() returns to its baseline
+// Run under TSan and ASan as well
+
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_vector_class/hlm_atomic_vector.h"
+#include "hlm_vector_class/hlm_atomic_vector.cpp"
+#include "hlm_test.hpp"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    typedef HELIUM_API::AtomicSharedVector<int> Slot;
+    typedef Slot::vector_type Vector;
+
+    const size_t length = 16;
+
+    // Every element holds the version, a torn snapshot would mix two
+    Vector version(const int& v)
+    {
+        Vector vector;
+        for (size_t i = 0; i < length; ++i) {
+            vector.push_back(v);
+        }
+        return vector;
+    }
+
+    bool whole(const Vector& snapshot)
+    {
+        if (snapshot.size() != length) {
+            return false;
+        }
+        for (size_t i = 1; i < length; ++i) {
+            if (snapshot[i] != snapshot[size_t(0)]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void check_fold_retire_race()
+    {
+        const size_t baseline = Vector::live_instances();
+        const size_t readers = std::max<size_t>(4, std::thread::hardware_concurrency());
+        const size_t loads = 5 * (size_t(1) << 14);   // several folds per reader
+        std::atomic<size_t> torn(0);
+        std::atomic<size_t> done(0);
+        {
+            Slot slot(version(0));
+            std::vector<std::thread> threads;
+            for (size_t r = 0; r < readers; ++r) {
+                threads.emplace_back([&slot, &torn, &done, loads, r]() {
+                    std::vector<Vector> held;
+                    for (size_t i = 0; i < loads; ++i) {
+                        Vector snapshot = slot.load();
+                        if (!whole(snapshot)) {
+                            ++torn;
+                        }
+                        // some snapshots outlive several publications
+                        if ((i + r) % 1024 == 0) {
+                            held.push_back(snapshot);
+                        }
+                        if (held.size() > 8) {
+                            held.erase(held.begin());
+                        }
+                    }
+                    for (size_t h = 0; h < held.size(); ++h) {
+                        if (!whole(held[h])) {
+                            ++torn;
+                        }
+                    }
+                    ++done;
+                });
+            }
+            threads.emplace_back([&slot, &done, readers]() {
+                int v = 1;
+                while (done.load() < readers) {
+                    slot.store(version(v++));
+                    if (v % 4 == 0) {
+                        Vector previous = slot.exchange(version(v++));
+                        (void)previous;
+                    }
+                    std::this_thread::yield();
+                }
+            });
+            for (size_t t = 0; t < threads.size(); ++t) {
+                threads[t].join();
+            }
+            HLM_CHECK(whole(slot.load()));
+        }
+        HLM_CHECK(torn.load() == 0);
+        HLM_CHECK(Vector::live_instances() == baseline);
+    }
+
+    // One publication loaded past fold_threshold while snapshots are held, then retired
+    void check_fold_then_retire()
+    {
+        const size_t baseline = Vector::live_instances();
+        {
+            Slot slot(version(1));
+            std::vector<Vector> held;
+            for (size_t i = 0; i < 3 * (size_t(1) << 14) + 7; ++i) {
+                Vector snapshot = slot.load();
+                if (i % 3 == 0) {
+                    held.push_back(snapshot);
+                }
+            }
+            slot.store(version(2));
+            HLM_CHECK(whole(held.front()) && held.front()[size_t(0)] == 1);
+            HLM_CHECK(Vector::live_instances() == baseline + 2);
+            held.clear();
+            HLM_CHECK(Vector::live_instances() == baseline + 1);
+        }
+        HLM_CHECK(Vector::live_instances() == baseline);
+    }
+
+} // namespace
+
+int main()
+{
+    check_fold_then_retire();
+    check_fold_retire_race();
+    return HLM::test::report("hlm_atomic_vector_tests");
+}
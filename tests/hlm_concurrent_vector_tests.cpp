@@ -0,0 +1,180 @@
+// ConcurrentSharedVector under concurrent push_back / grow_by, and appends whose segment
+// allocation fails : nothing may be claimed for them, so the destructor and clear() only ever
+// see constructed elements in allocated segments (run under ASan to see the difference)
+
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_vector_class/hlm_concurrent_vector.h"
+#include "hlm_vector_class/hlm_concurrent_vector.cpp"
+#include "hlm_test.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // Segments come from the aligned operator new : it fails on demand
+    std::atomic<bool> fail_segments(false);
+
+    void* allocate_aligned(std::size_t bytes, std::align_val_t alignment)
+    {
+        if (fail_segments.load()) {
+            throw std::bad_alloc();
+        }
+        const size_t align = static_cast<size_t>(alignment);
+        void* memory = std::aligned_alloc(align, (bytes + align - 1) / align * align);
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    void release_aligned(void* memory) { std::free(memory); }
+
+} // namespace
+
+void* operator new(std::size_t bytes, std::align_val_t alignment) { return allocate_aligned(bytes, alignment); }
+void* operator new[](std::size_t bytes, std::align_val_t alignment) { return allocate_aligned(bytes, alignment); }
+void operator delete(void* memory, std::align_val_t) noexcept { release_aligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { release_aligned(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { release_aligned(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { release_aligned(memory); }
+
+namespace {
+
+    // Counts live objects, so a destructor run on a slot that was never constructed shows
+    struct Counted {
+        static std::atomic<long> live;
+        long value;
+
+        Counted() : value(-1) { ++live; }
+        Counted(const long& v) : value(v) { ++live; }
+        Counted(const Counted& other) : value(other.value) { ++live; }
+        Counted& operator=(const Counted& other) { value = other.value; return *this; }
+        ~Counted() { --live; }
+    };
+    std::atomic<long> Counted::live(0);
+
+    typedef HELIUM_API::ConcurrentSharedVector<Counted> Vector;
+
+    void check_stress()
+    {
+        const size_t threads = std::max<size_t>(4, std::thread::hardware_concurrency());
+        const size_t per_thread = 20000;
+        const size_t block = 37;   // grow_by runs straddle segment boundaries
+        {
+            Vector vector;
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&vector, t, per_thread, block]() {
+                    size_t i = 0;
+                    while (i < per_thread) {
+                        const long value = static_cast<long>(t * per_thread + i);
+                        if (i % 5 == 0 && i + block <= per_thread) {
+                            const size_t first = vector.grow_by(block, Counted(value));
+                            for (size_t j = 1; j < block; ++j) {
+                                vector[first + j].value = value + static_cast<long>(j);
+                            }
+                            i += block;
+                        }
+                        else {
+                            vector.push_back(Counted(value));
+                            ++i;
+                        }
+                    }
+                });
+            }
+            for (size_t t = 0; t < threads; ++t) {
+                workers[t].join();
+            }
+
+            // every value exactly once
+            HLM_CHECK(vector.size() == threads * per_thread);
+            std::vector<long> values;
+            values.reserve(vector.size());
+            const Vector& reader = vector;
+            for (Vector::const_iterator it = reader.begin(); it != reader.end(); ++it) {
+                values.push_back(it->value);
+            }
+            std::sort(values.begin(), values.end());
+            bool all = (values.size() == threads * per_thread);
+            for (size_t i = 0; all && i < values.size(); ++i) {
+                all = (values[i] == static_cast<long>(i));
+            }
+            HLM_CHECK(all);
+            HLM_CHECK(Counted::live.load() == static_cast<long>(threads * per_thread));
+
+            vector.clear();
+            HLM_CHECK(vector.size() == 0);
+            HLM_CHECK(Counted::live.load() == 0);
+        }
+        HLM_CHECK(Counted::live.load() == 0);
+    }
+
+    void check_failed_allocation()
+    {
+        const size_t first = Vector::first_segment_size;
+        {
+            Vector vector;
+            vector.grow_by(first, Counted(1));   // segment 0 full
+
+            // push_back into segment 1 fails : nothing claimed
+            fail_segments.store(true);
+            bool thrown = false;
+            try {
+                vector.push_back(Counted(2));
+            }
+            catch (const std::bad_alloc&) {
+                thrown = true;
+            }
+            HLM_CHECK(thrown);
+            HLM_CHECK(vector.size() == first);
+
+            // grow_by over segments 1 and 2 fails the same way
+            thrown = false;
+            try {
+                vector.grow_by(3 * first, Counted(3));
+            }
+            catch (const std::bad_alloc&) {
+                thrown = true;
+            }
+            fail_segments.store(false);
+            HLM_CHECK(thrown);
+            HLM_CHECK(vector.size() == first);
+            HLM_CHECK(Counted::live.load() == static_cast<long>(first));
+
+            // the vector keeps working once memory is back
+            HLM_CHECK(vector.push_back(Counted(4)) == first);
+            HLM_CHECK(vector[first].value == 4);
+            HLM_CHECK(vector.size() == first + 1);
+        }
+        // the destructor only destroyed constructed slots
+        HLM_CHECK(Counted::live.load() == 0);
+
+        {
+            Vector vector;
+            fail_segments.store(true);
+            try {
+                vector.push_back(Counted(5));
+            }
+            catch (const std::bad_alloc&) {
+            }
+            fail_segments.store(false);
+            HLM_CHECK(vector.size() == 0);
+            vector.clear();
+        }
+        HLM_CHECK(Counted::live.load() == 0);
+        HLM_CHECK(Vector::live_instances() == 0);
+    }
+
+} // namespace
+
+int main()
+{
+    check_stress();
+    check_failed_allocation();
+    return HLM::test::report("hlm_concurrent_vector_tests");
+}
@@ -0,0 +1,139 @@
+// Copy-on-write rules of HELIUM_API::SharedVector (must_fork / fork) : the first write through a
+// handle of a shared HLM_COW block forks that handle, the last handle writes in place, and the
+// references held by checked iterators are not sharers
+// Checked iterators are forced on so the pin rules are tested in release builds too
+
+#ifndef HLM_CHECKED_ITERATORS
+#define HLM_CHECKED_ITERATORS
+#endif
+
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_test.hpp"
+
+namespace {
+
+    typedef HELIUM_API::SharedVector<int> V;
+
+    V make_vector()
+    {
+        return V(std::vector<int>{1, 2, 3, 4}, HLM_COPY);
+    }
+
+    int read(const V& vector, const size_t& index)
+    {
+        return vector[index];
+    }
+
+    void check_first_write_forks()
+    {
+        V source = make_vector();
+        V cow(source, HLM_COW);
+        HLM_CHECK(cow.data_id() == source.data_id());
+        HLM_CHECK(source.ref_count() == 2);
+
+        // reads through a const handle never fork
+        HLM_CHECK(read(cow, 1) == 2);
+        HLM_CHECK(cow.data_id() == source.data_id());
+
+        cow[size_t(0)] = 10;
+        HLM_CHECK(cow.data_id() != source.data_id());
+        HLM_CHECK(source.ref_count() == 1);
+        HLM_CHECK(cow.ref_count() == 1);
+        HLM_CHECK(read(cow, 0) == 10);
+        HLM_CHECK(read(source, 0) == 1);
+        HLM_CHECK(read(cow, 3) == 4);
+    }
+
+    void check_every_holder_forks()
+    {
+        // the original handle is a holder like any other once the block is in COW mode
+        V source = make_vector();
+        V cow(source, HLM_COW);
+        const size_t shared_id = source.data_id();
+        source[size_t(1)] = 20;
+        HLM_CHECK(source.data_id() != shared_id);
+        HLM_CHECK(cow.data_id() == shared_id);
+        HLM_CHECK(read(cow, 1) == 2);
+        HLM_CHECK(read(source, 1) == 20);
+    }
+
+    void check_last_handle_writes_in_place()
+    {
+        V source = make_vector();
+        {
+            V cow(source, HLM_COW);
+        }
+        const size_t id = source.data_id();
+        source[size_t(2)] = 30;
+        HLM_CHECK(source.data_id() == id);
+        HLM_CHECK(read(source, 2) == 30);
+
+        // a handle left alone by a fork writes in place too
+        V other = make_vector();
+        V cow(other, HLM_COW);
+        const size_t other_id = other.data_id();
+        cow[size_t(0)] = 5;
+        HLM_CHECK(cow.data_id() != other_id);
+        other[size_t(0)] = 6;
+        HLM_CHECK(other.data_id() == other_id);
+        HLM_CHECK(read(other, 0) == 6);
+        HLM_CHECK(read(cow, 0) == 5);
+    }
+
+    void check_pins_are_not_sharers()
+    {
+        V source = make_vector();
+        {
+            V cow(source, HLM_COW);
+        }
+        const size_t id = source.data_id();
+        V::iterator first = source.begin();
+        V::iterator second = source.begin() + 1;
+        HLM_CHECK(source.ref_count() == 3);
+        HLM_CHECK(source.data_id() == id);
+
+        source[size_t(0)] = 7;
+        HLM_CHECK(source.data_id() == id);
+        HLM_CHECK(*first == 7);
+        *second = 8;
+        HLM_CHECK(read(source, 1) == 8);
+    }
+
+    void check_pinned_block_with_sharer_forks()
+    {
+        // with another handle on the block the write forks, the iterator keeps its block
+        V source = make_vector();
+        V::iterator first = source.begin();
+        V cow(source, HLM_COW);
+        const size_t shared_id = source.data_id();
+        source[size_t(0)] = 9;
+        HLM_CHECK(source.data_id() != shared_id);
+        HLM_CHECK(cow.data_id() == shared_id);
+        HLM_CHECK(*first == 1);
+        HLM_CHECK(read(cow, 0) == 1);
+        HLM_CHECK(read(source, 0) == 9);
+    }
+
+    void check_copy_never_shares()
+    {
+        V source = make_vector();
+        V copy(source, HLM_COPY);
+        HLM_CHECK(copy.data_id() != source.data_id());
+        HLM_CHECK(source.ref_count() == 1);
+    }
+
+} // namespace
+
+int main()
+{
+    const size_t baseline = V::live_instances();
+    check_first_write_forks();
+    check_every_holder_forks();
+    check_last_handle_writes_in_place();
+    check_pins_are_not_sharers();
+    check_pinned_block_with_sharer_forks();
+    check_copy_never_shares();
+    HLM_CHECK(V::live_instances() == baseline);
+    return HLM::test::report("hlm_cow_tests");
+}
@@ -0,0 +1,126 @@
+// Heap allocations of the inline tail (InlineCapacity) of SharedVector and Vector
+// Every form of the global operator new is replaced by a counting one : up to InlineCapacity
+// elements a vector costs its control block only, the first element past it spills the
+// elements to one separate buffer. The leak tracker sets up one shard per type and thread on
+// first use, the checks start after that
+
+#include "hlm_vector.hpp"
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_test.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    size_t allocations = 0;
+
+    void* counted(std::size_t bytes)
+    {
+        ++allocations;
+        void* memory = std::malloc(bytes != 0 ? bytes : 1);
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+    void* counted(std::size_t bytes, std::align_val_t alignment)
+    {
+        ++allocations;
+        const size_t align = static_cast<size_t>(alignment);
+        void* memory = std::aligned_alloc(align, (bytes + align - 1) / align * align);
+        if (memory == nullptr) {
+            throw std::bad_alloc();
+        }
+        return memory;
+    }
+
+} // namespace
+
+void* operator new(std::size_t bytes) { return counted(bytes); }
+void* operator new[](std::size_t bytes) { return counted(bytes); }
+void* operator new(std::size_t bytes, std::align_val_t alignment) { return counted(bytes, alignment); }
+void* operator new[](std::size_t bytes, std::align_val_t alignment) { return counted(bytes, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+namespace {
+
+    const size_t inline_capacity = 8;
+
+    // V has inline_capacity elements inline, NoTail the same vector without a tail
+    template <typename V, typename NoTail>
+    void check_inline(const char* name)
+    {
+        std::fprintf(stderr, "%s\n", name);
+
+        // the first block of a type on a thread sets up its leak tracker shard, once
+        {
+            V warm_up;
+            NoTail warm_up_no_tail;
+        }
+
+        // one allocation for the control block, none while the tail has room
+        size_t before = allocations;
+        {
+            V vector;
+            HLM_CHECK(allocations - before == 1);
+            HLM_CHECK(vector.capacity() == inline_capacity);
+            for (size_t i = 0; i < inline_capacity; ++i) {
+                vector.push_back(static_cast<int>(i));
+            }
+            HLM_CHECK(allocations - before == 1);
+
+            // sharing the block costs nothing, a deep copy one block again
+            const size_t shared = allocations;
+            {
+                V copy(vector);
+                V deep(vector, HLM_COPY);
+                HLM_CHECK(allocations - shared == 1);
+                HLM_CHECK(deep.size() == inline_capacity);
+            }
+
+            // the element past the tail spills to a single buffer
+            const size_t spill = allocations;
+            vector.push_back(static_cast<int>(inline_capacity));
+            HLM_CHECK(allocations - spill == 1);
+            HLM_CHECK(vector.capacity() > inline_capacity);
+            for (size_t i = 0; i <= inline_capacity; ++i) {
+                HLM_CHECK(vector.fast_access(i) == static_cast<int>(i));
+            }
+        }
+
+        // resize within the tail does not allocate, past it once
+        before = allocations;
+        {
+            V vector;
+            vector.resize(inline_capacity);
+            HLM_CHECK(allocations - before == 1);
+            vector.resize(inline_capacity + 1);
+            HLM_CHECK(allocations - before == 2);
+        }
+
+        // without an inline tail the first element already spills
+        before = allocations;
+        {
+            NoTail empty_tail;
+            empty_tail.push_back(1);
+            HLM_CHECK(allocations - before == 2);
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    check_inline<HELIUM_API::SmallSharedVector<int, inline_capacity>, HELIUM_API::SharedVector<int>>("SharedVector");
+    check_inline<HLM::SmallVector<int, inline_capacity>, HLM::Vector<int>>("Vector");
+    return HLM::test::report("hlm_inline_capacity_tests");
+}
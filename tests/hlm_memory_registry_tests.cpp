@@ -0,0 +1,130 @@
+// Deep copies under memory pressure : with the budget exceeded and the automatic shrink pass
+// enabled, copying an exclusively owned, partly filled vector shrinks the source while the copy
+// is made. The copy must be taken before the shrink pass runs, not from the released buffer
+// Build with -DHLM_MEMORY_REGISTRY (and -fsanitize=address to catch a read of the old buffer)
+
+#ifndef HLM_MEMORY_REGISTRY
+#define HLM_MEMORY_REGISTRY
+#endif
+
+#include <memory_resource>
+#include "hlm_vector.hpp"
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_soa_vector.hpp"
+#include "hlm_test.hpp"
+
+namespace {
+
+    const size_t filled = 1000;
+    const size_t kept   = 100;
+
+    // Exclusively owned, spilled out of the inline tail and with spare capacity : shrinkable
+    template <typename V>
+    V shrinkable()
+    {
+        V vector;
+        for (size_t i = 0; i < filled; ++i) {
+            vector.push_back(static_cast<int>(i));
+        }
+        vector.resize(kept);
+        return vector;
+    }
+
+    template <typename V>
+    bool holds_sequence(const V& vector)
+    {
+        if (vector.size() != kept) {
+            return false;
+        }
+        for (size_t i = 0; i < kept; ++i) {
+            if (vector[i] != static_cast<int>(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void over_budget()
+    {
+        HLM::memory::set_budget(1);
+        HLM::memory::set_auto_shrink(true);
+    }
+
+    void within_budget()
+    {
+        HLM::memory::set_auto_shrink(false);
+        HLM::memory::set_budget(0);
+    }
+
+    template <typename V>
+    void check_copies(const char* name)
+    {
+        std::fprintf(stderr, "%s\n", name);
+        {
+            V source = shrinkable<V>();
+            HLM_CHECK(source.capacity() > kept);
+            over_budget();
+            V copy(source, HLM_COPY);
+            within_budget();
+            HLM_CHECK(holds_sequence(copy));
+            HLM_CHECK(holds_sequence(source));
+            HLM_CHECK(source.capacity() == kept);
+        }
+        {
+            V source = shrinkable<V>();
+            over_budget();
+            V copy(source, std::pmr::new_delete_resource());
+            within_budget();
+            HLM_CHECK(holds_sequence(copy));
+            HLM_CHECK(holds_sequence(source));
+            HLM_CHECK(copy.get_resource() == std::pmr::new_delete_resource());
+        }
+        {
+            V left = shrinkable<V>();
+            V right = shrinkable<V>();
+            over_budget();
+            V both = left + right;
+            within_budget();
+            HLM_CHECK(both.size() == 2 * kept);
+            for (size_t i = 0; i < 2 * kept; ++i) {
+                HLM_CHECK(both[i] == static_cast<int>(i % kept));
+            }
+        }
+    }
+
+    void check_soa_copies()
+    {
+        typedef HLM::SoAVector<int, double> Rows;
+        std::fprintf(stderr, "SoAVector<int, double>\n");
+        Rows source;
+        for (size_t i = 0; i < filled; ++i) {
+            source.push_back(static_cast<int>(i), 0.5 * static_cast<double>(i));
+        }
+        source.resize(kept);
+        HLM_CHECK(source.capacity() > kept);
+        over_budget();
+        Rows copy(source, HLM_COPY);
+        Rows moved(source, std::pmr::new_delete_resource());
+        within_budget();
+        HLM_CHECK(copy.size() == kept);
+        HLM_CHECK(moved.size() == kept);
+        for (size_t i = 0; i < kept; ++i) {
+            HLM_CHECK(copy.get<0>(i) == static_cast<int>(i));
+            HLM_CHECK(copy.get<1>(i) == 0.5 * static_cast<double>(i));
+            HLM_CHECK(moved.get<0>(i) == static_cast<int>(i));
+            HLM_CHECK(source.get<1>(i) == 0.5 * static_cast<double>(i));
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    check_copies<HLM::Vector<int>>("Vector<int>");
+    check_copies<HLM::SmallVector<int, 8>>("SmallVector<int, 8>");
+    check_copies<HELIUM_API::SharedVector<int>>("SharedVector<int>");
+    check_copies<HELIUM_API::SmallSharedVector<int, 8>>("SmallSharedVector<int, 8>");
+    check_soa_copies();
+    return HLM::test::report("hlm_memory_registry_tests");
+}
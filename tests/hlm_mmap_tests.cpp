@@ -0,0 +1,176 @@
+// SharedVector::map_file on temporary files (Linux : the mappings are looked up in /proc/self/maps)
+// Read-only and private mappings : contents, private writes never reaching the file, the first
+// mutable access of a read-only mapping and growth past the mapping copying out and unmapping
+
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_test.hpp"
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+    typedef HELIUM_API::SharedVector<int32_t> Vector;
+
+    const size_t count = 1000;
+
+    // Temporary file holding 0 .. count - 1, removed with the object
+    struct TempFile {
+        std::string path;
+
+        TempFile()
+        {
+            char name[] = "/tmp/hlm_mmap_tests_XXXXXX";
+            const int fd = ::mkstemp(name);
+            HLM_CHECK(fd >= 0);
+            ::close(fd);
+            path = name;
+            std::vector<int32_t> values(count);
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = static_cast<int32_t>(i);
+            }
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(count * sizeof(int32_t)));
+        }
+
+        ~TempFile() { ::unlink(path.c_str()); }
+
+        std::vector<int32_t> contents() const
+        {
+            std::ifstream in(path, std::ios::binary);
+            std::vector<int32_t> values(count);
+            in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(int32_t)));
+            return values;
+        }
+
+        // True while the process maps the file
+        bool mapped() const
+        {
+            std::ifstream maps("/proc/self/maps");
+            std::string line;
+            while (std::getline(maps, line)) {
+                if (line.find(path) != std::string::npos) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    bool holds_sequence(const Vector& vector, const size_t& n)
+    {
+        if (vector.size() < n) {
+            return false;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (vector[i] != static_cast<int32_t>(i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void check_read_only()
+    {
+        TempFile file;
+        {
+            Vector vector = Vector::map_file(file.path, HLM_MAP_READONLY);
+            HLM_CHECK(vector.is_mapped());
+            HLM_CHECK(file.mapped());
+            HLM_CHECK(vector.size() == count);
+            HLM_CHECK(holds_sequence(vector, count));
+
+            // const reads stay on the mapping, the first mutable access forks a heap copy
+            const Vector& reader = vector;
+            HLM_CHECK(reader[size_t(10)] == 10);
+            HLM_CHECK(vector.is_mapped());
+            vector[size_t(10)] = -1;
+            HLM_CHECK(!vector.is_mapped());
+            HLM_CHECK(!file.mapped());
+            HLM_CHECK(vector.fast_access(10) == -1);
+            HLM_CHECK(vector.fast_access(11) == 11);
+        }
+        HLM_CHECK(file.contents()[10] == 10);
+    }
+
+    void check_private()
+    {
+        TempFile file;
+        {
+            Vector vector = Vector::map_file(file.path, HLM_MAP_PRIVATE);
+            HLM_CHECK(vector.is_mapped());
+            HLM_CHECK(holds_sequence(vector, count));
+
+            // writes stay in place but private to this process
+            vector[size_t(0)] = -7;
+            vector.broadcast([](int32_t& element) { element += 1000; });
+            HLM_CHECK(vector.is_mapped());
+            HLM_CHECK(vector.fast_access(0) == 993);
+            HLM_CHECK(vector.fast_access(5) == 1005);
+            HLM_CHECK(file.contents()[0] == 0);
+            HLM_CHECK(file.contents()[5] == 5);
+        }
+        HLM_CHECK(!file.mapped());
+        HLM_CHECK(file.contents() == TempFile().contents());
+    }
+
+    void check_growth()
+    {
+        const int modes[] = { HLM_MAP_READONLY, HLM_MAP_PRIVATE };
+        for (size_t m = 0; m < 2; ++m) {
+            TempFile file;
+            Vector vector = Vector::map_file(file.path, modes[m]);
+            HLM_CHECK(file.mapped());
+
+            // the element past the mapping copies everything out and releases the mapping
+            vector.push_back(static_cast<int32_t>(count));
+            HLM_CHECK(!vector.is_mapped());
+            HLM_CHECK(!file.mapped());
+            HLM_CHECK(vector.size() == count + 1);
+            HLM_CHECK(holds_sequence(vector, count + 1));
+            HLM_CHECK(file.contents().size() == count);
+        }
+    }
+
+    void check_shared_handles()
+    {
+        TempFile file;
+        Vector first = Vector::map_file(file.path, HLM_MAP_READONLY);
+        {
+            Vector second(first);
+            HLM_CHECK(second.is_mapped());
+        }
+        // released with the last handle only
+        HLM_CHECK(file.mapped());
+        first = Vector();
+        HLM_CHECK(!file.mapped());
+    }
+
+    void check_errors()
+    {
+        bool thrown = false;
+        try {
+            Vector::map_file("/tmp/hlm_mmap_tests_missing_file");
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        HLM_CHECK(thrown);
+    }
+
+} // namespace
+
+int main()
+{
+    check_read_only();
+    check_private();
+    check_growth();
+    check_shared_handles();
+    check_errors();
+    return HLM::test::report("hlm_mmap_tests");
+}
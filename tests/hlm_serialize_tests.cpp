@@ -0,0 +1,135 @@
+// save / load round trips, and load() of corrupt or truncated images : a header announcing more
+// elements than the stream holds must fail with std::runtime_error, without allocating for the
+// announced count, from a seekable stream (std::stringstream) and from a pipe-like one
+
+#include "hlm_vector.hpp"
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_serialize.hpp"
+#include "hlm_test.hpp"
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+namespace {
+
+    // Reads from a string, cannot seek or tell : load() has to find the end by reading
+    class PipeBuffer : public std::streambuf {
+    public:
+        explicit PipeBuffer(const std::string& bytes) : bytes_(bytes)
+        {
+            char* first = &bytes_[0];
+            setg(first, first, first + bytes_.size());
+        }
+
+    private:
+        std::string bytes_;
+    };
+
+    template <typename V>
+    std::string saved(const V& vector)
+    {
+        std::ostringstream out(std::ios::binary);
+        HLM::save(out, vector);
+        return out.str();
+    }
+
+    // The message of the runtime_error load() throws, empty when it does not throw
+    template <typename V>
+    std::string load_error(const std::string& image, const bool& seekable)
+    {
+        try {
+            if (seekable) {
+                std::istringstream in(image, std::ios::binary);
+                HLM::load<V>(in);
+            }
+            else {
+                PipeBuffer buffer(image);
+                std::istream in(&buffer);
+                HLM::load<V>(in);
+            }
+        }
+        catch (const std::runtime_error& error) {
+            return error.what();
+        }
+        return std::string();
+    }
+
+    template <typename V>
+    void check_round_trip(const size_t& n)
+    {
+        V vector;
+        for (size_t i = 0; i < n; ++i) {
+            vector.push_back(static_cast<double>(i) * 0.5);
+        }
+        const std::string image = saved(vector);
+        for (int seekable = 0; seekable < 2; ++seekable) {
+            V loaded;
+            if (seekable) {
+                std::istringstream in(image, std::ios::binary);
+                loaded = HLM::load<V>(in);
+            }
+            else {
+                PipeBuffer buffer(image);
+                std::istream in(&buffer);
+                loaded = HLM::load<V>(in);
+            }
+            HLM_CHECK(loaded.size() == n);
+            bool same = true;
+            for (size_t i = 0; i < n; ++i) {
+                same = same && (loaded.fast_access(i) == vector.fast_access(i));
+            }
+            HLM_CHECK(same);
+        }
+    }
+
+    template <typename V>
+    void check_corrupt_count()
+    {
+        V vector;
+        for (int i = 0; i < 100; ++i) {
+            vector.push_back(i);
+        }
+        const std::string image = saved(vector);
+        HLM::SavedHeader header;
+        std::memcpy(&header, image.data(), sizeof(header));
+
+        // a 64-byte header alone announcing 2^40 elements (8 TiB)
+        header.count = uint64_t(1) << 40;
+        std::string huge(reinterpret_cast<const char*>(&header), sizeof(header));
+        HLM_CHECK(load_error<V>(huge, true).find("truncated") != std::string::npos);
+        HLM_CHECK(load_error<V>(huge, false).find("truncated") != std::string::npos);
+
+        // the real payload but a count one past it
+        header.count = 101;
+        std::string longer(image);
+        std::memcpy(&longer[0], &header, sizeof(header));
+        HLM_CHECK(load_error<V>(longer, true).find("truncated") != std::string::npos);
+        HLM_CHECK(load_error<V>(longer, false).find("truncated") != std::string::npos);
+
+        // truncated payload, and a flipped payload byte
+        const std::string cut = image.substr(0, image.size() - 1);
+        HLM_CHECK(load_error<V>(cut, true).find("truncated") != std::string::npos);
+        HLM_CHECK(load_error<V>(cut, false).find("truncated") != std::string::npos);
+        std::string flipped(image);
+        flipped[flipped.size() - 1] ^= 1;
+        HLM_CHECK(load_error<V>(flipped, true).find("checksum") != std::string::npos);
+        HLM_CHECK(load_error<V>(flipped, false).find("checksum") != std::string::npos);
+    }
+
+} // namespace
+
+int main()
+{
+    // 0, below one chunk, and several chunks (the first holds 1 MiB, 131072 doubles)
+    const size_t sizes[] = { 0, 1000, 1000000 };
+    for (size_t s = 0; s < 3; ++s) {
+        check_round_trip<HELIUM_API::SharedVector<double>>(sizes[s]);
+        check_round_trip<HLM::Vector<double>>(sizes[s]);
+    }
+    check_corrupt_count<HELIUM_API::SharedVector<double>>();
+    check_corrupt_count<HLM::Vector<double>>();
+    return HLM::test::report("hlm_serialize_tests");
+}
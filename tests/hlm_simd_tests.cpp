@@ -0,0 +1,153 @@
+// HLM::simd kernels against the scalar path, for every accelerated element type
+// Each instruction set is called directly (the dispatching kernels only reach the best one) :
+// SSE2 always on x86-64, AVX2 when the running CPU has it. Lengths 0 .. 2 * lanes + 1 cover
+// the unrolled loop, the single-register loop and every tail, starts 0 .. lanes - 1 elements
+// into an aligned buffer cover the unaligned loads
+
+#include "hlm_simd.hpp"
+#include "hlm_test.hpp"
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+    // Small integral values : float sums and dot products stay exact whatever the association
+    template <typename T>
+    std::vector<T> pattern(const size_t& n, const unsigned& seed)
+    {
+        std::vector<T> values(n);
+        unsigned state = seed * 2654435761u + 1;
+        for (size_t i = 0; i < n; ++i) {
+            state = state * 1664525u + 1013904223u;
+            values[i] = static_cast<T>(static_cast<int>((state >> 16) % 201) - 100);
+        }
+        return values;
+    }
+
+    // Kernels of one instruction set, as a table of function pointers
+    template <typename T>
+    struct Kernels {
+        const char* name;
+        size_t      lanes;
+        T      (*sum)(const T*, const size_t&);
+        T      (*dot)(const T*, const T*, const size_t&);
+        T      (*min)(const T*, const size_t&);
+        T      (*max)(const T*, const size_t&);
+        size_t (*find)(const T*, const size_t&, const T&);
+        void   (*replace)(T*, const size_t&, const T&, const T&);
+    };
+
+    template <typename T>
+    void check_kernels(const Kernels<T>& k)
+    {
+        const size_t lanes = k.lanes;
+        for (size_t n = 0; n <= 2 * lanes + 1; ++n) {
+            for (size_t offset = 0; offset < lanes; ++offset) {
+                const std::vector<T> a = pattern<T>(n + offset, static_cast<unsigned>(n * 31 + offset));
+                const std::vector<T> b = pattern<T>(n + offset, static_cast<unsigned>(n * 17 + offset + 7));
+                const T* x = a.data() + offset;
+                const T* y = b.data() + offset;
+
+                HLM_CHECK(k.sum(x, n) == HLM::simd::scalar::sum(x, n));
+                HLM_CHECK(k.dot(x, y, n) == HLM::simd::scalar::dot(x, y, n));
+                if (n != 0) {
+                    HLM_CHECK(k.min(x, n) == HLM::simd::scalar::min(x, n));
+                    HLM_CHECK(k.max(x, n) == HLM::simd::scalar::max(x, n));
+                }
+
+                // absent, then present at every position (first match wins)
+                HLM_CHECK(k.find(x, n, T(1000)) == n);
+                for (size_t at = 0; at < n; ++at) {
+                    std::vector<T> c(a);
+                    c[offset + at] = T(1000);
+                    if (at + 1 < n) {
+                        c[offset + n - 1] = T(1000);
+                    }
+                    HLM_CHECK(k.find(c.data() + offset, n, T(1000)) == at);
+                }
+
+                // the values around the range must stay untouched
+                std::vector<T> expected(a);
+                std::vector<T> actual(a);
+                expected.push_back(T(0));
+                actual.push_back(T(0));
+                const T old_value = (n != 0) ? x[n / 2] : T(0);
+                HLM::simd::scalar::replace(expected.data() + offset, n, old_value, T(1000));
+                k.replace(actual.data() + offset, n, old_value, T(1000));
+                HLM_CHECK(actual == expected);
+            }
+        }
+    }
+
+    // Extremes : integer wrap-around and the signed 64 bit compare emulated on SSE2
+    template <typename T>
+    void check_extremes(const Kernels<T>& k)
+    {
+        const size_t n = 2 * k.lanes + 1;
+        std::vector<T> values(n, std::numeric_limits<T>::max());
+        values[n / 2] = std::numeric_limits<T>::lowest();
+        values[n - 1] = T(-1);
+        if (std::is_integral<T>::value) {
+            HLM_CHECK(k.sum(values.data(), n) == HLM::simd::scalar::sum(values.data(), n));
+            HLM_CHECK(k.dot(values.data(), values.data(), n) == HLM::simd::scalar::dot(values.data(), values.data(), n));
+        }
+        HLM_CHECK(k.min(values.data(), n) == std::numeric_limits<T>::lowest());
+        HLM_CHECK(k.max(values.data(), n) == std::numeric_limits<T>::max());
+    }
+
+#ifdef HLM_SIMD_X86
+    template <typename T>
+    Kernels<T> sse2_kernels()
+    {
+        namespace s = HLM::simd::sse2;
+        return Kernels<T>{"sse2", s::Ops<T>::lanes, &s::sum<T>, &s::dot<T>, &s::min<T>, &s::max<T>, &s::find<T>, &s::replace<T>};
+    }
+
+    template <typename T>
+    Kernels<T> avx2_kernels()
+    {
+        namespace s = HLM::simd::avx2;
+        return Kernels<T>{"avx2", s::Ops<T>::lanes, &s::sum<T>, &s::dot<T>, &s::min<T>, &s::max<T>, &s::find<T>, &s::replace<T>};
+    }
+#endif
+
+    // The dispatching kernels, whatever active_isa() picked
+    template <typename T>
+    Kernels<T> dispatch_kernels()
+    {
+        namespace s = HLM::simd;
+        return Kernels<T>{"dispatch", 8, &s::sum<T>, &s::dot<T>, &s::min<T>, &s::max<T>, &s::find<T>, &s::replace<T>};
+    }
+
+    template <typename T>
+    void check_type()
+    {
+        check_kernels(dispatch_kernels<T>());
+        check_extremes(dispatch_kernels<T>());
+#ifdef HLM_SIMD_X86
+        check_kernels(sse2_kernels<T>());
+        check_extremes(sse2_kernels<T>());
+        if (HLM::simd::active_isa() == HLM::simd::ISA_AVX2) {
+            check_kernels(avx2_kernels<T>());
+            check_extremes(avx2_kernels<T>());
+        }
+#endif
+    }
+
+} // namespace
+
+int main()
+{
+#ifdef HLM_SIMD_X86
+    std::fprintf(stderr, "instruction set : %s\n", (HLM::simd::active_isa() == HLM::simd::ISA_AVX2) ? "avx2" : "sse2");
+#else
+    std::fprintf(stderr, "instruction set : scalar\n");
+#endif
+    check_type<int32_t>();
+    check_type<int64_t>();
+    check_type<float>();
+    check_type<double>();
+    return HLM::test::report("hlm_simd_tests");
+}
@@ -0,0 +1,45 @@
+#ifndef _HLM_TEST_HPP_
+#define _HLM_TEST_HPP_
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks shared by the test programs of this directory, no dependency beyond the headers
+// Every test program is one translation unit with its own main, returning non-zero on failure
+//
+// Build and run (from the repository root), for example :
+//   g++ -std=c++17 -O1 -g -I. tests/hlm_simd_tests.cpp -o hlm_simd_tests -pthread && ./hlm_simd_tests
+// Add -fsanitize=address,undefined to catch the memory errors the checks cannot see
+
+namespace HLM {
+namespace test {
+
+    inline int& failures()
+    {
+        static int count = 0;
+        return count;
+    }
+
+    inline void fail(const char* expression, const char* file, const int& line)
+    {
+        std::fprintf(stderr, "%s:%d: check failed : %s\n", file, line, expression);
+        ++failures();
+    }
+
+    // One line summary, the exit code of main
+    inline int report(const char* name)
+    {
+        if (failures() == 0) {
+            std::fprintf(stderr, "%s : ok\n", name);
+            return 0;
+        }
+        std::fprintf(stderr, "%s : %d check(s) failed\n", name, failures());
+        return 1;
+    }
+
+} // namespace test
+} // namespace HLM
+
+#define HLM_CHECK(expression) \
+    ((expression) ? (void)0 : HLM::test::fail(#expression, __FILE__, __LINE__))
+
+#endif
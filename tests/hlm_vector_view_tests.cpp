@@ -0,0 +1,47 @@
+// HLM::VectorView reductions against the parent's : the parent's ReduceFunctor keeps its
+// functor(element, accum) argument order through a view, other callables take the accumulator first
+
+#include "hlm_vector.hpp"
+#include "hlm_vector_class/hlm_vector.h"
+#include "hlm_vector_class/hlm_vector.cpp"
+#include "hlm_vector_view.hpp"
+#include "hlm_test.hpp"
+
+namespace {
+
+    // Not commutative : the order of the arguments shows in the result
+    template <typename Functor>
+    class Digits : public Functor {
+    public:
+        long operator()(const long& element, const long& accum) const override { return accum * 10 + element; }
+    };
+
+    template <typename V>
+    void check_reduce(const char* name)
+    {
+        std::fprintf(stderr, "%s\n", name);
+        V vector;
+        for (long i = 1; i <= 6; ++i) {
+            vector.push_back(i);
+        }
+        const Digits<typename V::reduce_functor_type> digits;
+        HLM::VectorView<V> whole(vector);
+        HLM::VectorView<V> middle(vector, 1, 3);
+
+        HLM_CHECK(whole.reduce(digits) == vector.reduce(digits));
+        HLM_CHECK(whole.reduce(digits) == 123456);
+        HLM_CHECK(middle.reduce(digits) == 234);
+
+        // a lambda gets the accumulator first
+        HLM_CHECK(middle.reduce([](const long& accum, const long& element) { return accum * 10 + element; }) == 234);
+        HLM_CHECK(HLM::VectorView<V>(vector, 6).reduce(digits) == V::DefaultValue());
+    }
+
+} // namespace
+
+int main()
+{
+    check_reduce<HELIUM_API::SharedVector<long>>("SharedVector");
+    check_reduce<HLM::Vector<long>>("Vector");
+    return HLM::test::report("hlm_vector_view_tests");
+}